@@ -0,0 +1,84 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "author_table.h"
+
+#define DEFAULT_COMMITS 1000000
+#define DEFAULT_AUTHORS 2000
+
+/*
+ * Usage: bench_authors [commits] [authors]
+ *
+ * Interns one signature per commit, drawn from a skewed pool the way a
+ * project's history is: a few regulars write most of the commits. Reports
+ * interning throughput and the table's footprint against keeping a copy of
+ * the signature in every commit.
+ */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    size_t commits = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_COMMITS;
+    size_t authors = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_AUTHORS;
+    if (!commits || !authors) {
+        fprintf(stderr, "Usage: %s [commits] [authors]\n", argv[0]);
+        return 1;
+    }
+
+    char **pool = malloc(authors * sizeof(char *));
+    size_t *picks = malloc(commits * sizeof(size_t));
+    if (!pool || !picks) return 1;
+    char buf[96];
+    for (size_t i = 0; i < authors; i++) {
+        snprintf(buf, sizeof(buf), "Developer Number %zu <developer.%zu@example.com>", i, i);
+        pool[i] = strdup(buf);
+        if (!pool[i]) return 1;
+    }
+
+    // Squaring a uniform draw favours the low ids
+    unsigned int seed = 42;
+    size_t copied_bytes = 0;
+    for (size_t i = 0; i < commits; i++) {
+        seed = seed * 1103515245 + 12345;
+        double r = (double)(seed >> 8) / (double)(1u << 24);
+        picks[i] = (size_t)(r * r * (double)authors);
+        copied_bytes += strlen(pool[picks[i]]) + 1;
+    }
+
+    printf("Interning %zu commits by %zu authors\n\n", commits, authors);
+
+    author_table_t table;
+    author_table_init(&table);
+    uint32_t check = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < commits; i++) {
+        const char *signature = pool[picks[i]];
+        uint32_t id = author_table_intern(&table, signature, strlen(signature));
+        if (id == AUTHOR_NONE) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        check ^= id;
+    }
+    double elapsed = now_seconds() - start;
+
+    size_t interned = author_table_memory(&table) + commits * sizeof(uint32_t);
+    printf("author_table_intern: %10.1f ns/op  %10.0f ops/s (%u distinct, check %u)\n",
+           elapsed * 1e9 / commits, commits / elapsed, table.count, check);
+    printf("interned:  %10zu bytes (table %zu, ids %zu)\n", interned,
+           author_table_memory(&table), commits * sizeof(uint32_t));
+    printf("per commit:%10zu bytes (strings %zu, pointers %zu)\n",
+           copied_bytes + commits * sizeof(char *), copied_bytes, commits * sizeof(char *));
+
+    author_table_cleanup(&table);
+    for (size_t i = 0; i < authors; i++) free(pool[i]);
+    free(pool);
+    free(picks);
+    return 0;
+}
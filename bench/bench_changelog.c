@@ -0,0 +1,166 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <git2.h>
+#include "changelog.h"
+
+#define DEFAULT_COMMITS 100000
+
+/*
+ * Usage:
+ *   bench_changelog create <dir> [commits]   build a linear history to measure against
+ *   bench_changelog batch <dir> [workers]    changelog_generate() + changelog_write()
+ *   bench_changelog stream <dir> [workers]   changelog_generate_stream()
+ *   bench_changelog render <dir> [workers]   changelog_write() of Markdown, JSON and HTML
+ *                                            after changelog_generate(), timed alone
+ *
+ * workers is the walk's pool size, 0 (the default) for one per CPU; compare
+ * 1 against N for the parallel speedup. Every commit is parsed unless
+ * BENCH_CACHE=1 lets the walk use .git/releasy/commits.cache.
+ *
+ * Run each mode in its own process so peak RSS is not shared between them.
+ * For allocation counts run the same command under valgrind and read the
+ * "total heap usage" line.
+ */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Commit mix roughly matching a busy project: mostly fixes and features,
+// some scoped, a few with bodies and some that are not conventional at all
+static int create_history(const char *path, size_t count) {
+    git_repository *repo = NULL;
+    if (git_repository_init(&repo, path, 0) != 0) return -1;
+
+    git_signature *sig = NULL;
+    git_index *index = NULL;
+    git_tree *tree = NULL;
+    git_oid tree_id, parent_id;
+    int error = git_signature_now(&sig, "Bench User", "bench@example.com");
+    if (!error) error = git_repository_index(&index, repo);
+    if (!error) error = git_index_write_tree(&tree_id, index);
+    if (!error) error = git_tree_lookup(&tree, repo, &tree_id);
+
+    static const char *types[] = { "fix", "feat", "docs", "refactor", "perf", "chore" };
+    static const char *scopes[] = { "core", "cli", "git", "changelog" };
+    char message[256];
+    unsigned int seed = 42;
+
+    for (size_t i = 0; !error && i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = seed >> 8;
+
+        switch (r % 8) {
+            case 0:
+                snprintf(message, sizeof(message), "Merge branch 'topic-%zu'", i);
+                break;
+            case 1:
+                snprintf(message, sizeof(message), "%s: change %zu\n\nLonger explanation of change %zu.\n",
+                         types[(r >> 3) % 6], i, i);
+                break;
+            case 2:
+            case 3:
+                snprintf(message, sizeof(message), "%s(%s): change %zu",
+                         types[(r >> 3) % 6], scopes[(r >> 6) % 4], i);
+                break;
+            default:
+                snprintf(message, sizeof(message), "%s: change %zu", types[(r >> 3) % 6], i);
+                break;
+        }
+
+        git_commit *parent = NULL;
+        if (i > 0) {
+            error = git_commit_lookup(&parent, repo, &parent_id);
+            if (error) break;
+        }
+        error = git_commit_create(&parent_id, repo, "HEAD", sig, sig, "UTF-8", message, tree,
+                                  parent ? 1 : 0, parent ? (const git_commit **)&parent : NULL);
+        if (parent) git_commit_free(parent);
+    }
+
+    git_tree_free(tree);
+    git_index_free(index);
+    git_signature_free(sig);
+    git_repository_free(repo);
+    return error ? -1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s create <dir> [commits] | batch|stream|render <dir> [workers]\n", argv[0]);
+        return 1;
+    }
+
+    git_libgit2_init();
+    int ret = 0;
+
+    if (strcmp(argv[1], "create") == 0) {
+        size_t count = argc > 3 ? strtoul(argv[3], NULL, 10) : DEFAULT_COMMITS;
+        double start = now_seconds();
+        ret = create_history(argv[2], count) == 0 ? 0 : 1;
+        printf("Created %zu commits in %.1fs\n", count, now_seconds() - start);
+        git_libgit2_shutdown();
+        return ret;
+    }
+
+    git_repository *repo = NULL;
+    if (git_repository_open(&repo, argv[2]) != 0) {
+        fprintf(stderr, "Failed to open %s\n", argv[2]);
+        git_libgit2_shutdown();
+        return 1;
+    }
+
+    long base_rss = peak_rss_kb();
+    changelog_t log;
+    changelog_init(&log, "bench_changelog.md");
+    log.walk.workers = argc > 3 ? atoi(argv[3]) : 0;
+    const char *cache = getenv("BENCH_CACHE");
+    log.walk.use_cache = cache && strcmp(cache, "1") == 0;
+
+    double start = now_seconds();
+    if (strcmp(argv[1], "batch") == 0) {
+        ret = changelog_generate(&log, repo, "1.0.0");
+        if (ret == RELEASY_SUCCESS) {
+            printf("Collected %zu commits\n", log.entries[0]->count);
+            ret = changelog_write(&log);
+        }
+    } else if (strcmp(argv[1], "render") == 0) {
+        ret = changelog_generate(&log, repo, "1.0.0");
+        if (ret == RELEASY_SUCCESS) {
+            log.formats = CHANGELOG_FORMAT_ALL;
+            start = now_seconds();
+            ret = changelog_write(&log);
+        }
+    } else {
+        ret = changelog_generate_stream(&log, repo, "1.0.0");
+    }
+    double elapsed = now_seconds() - start;
+
+    if (ret != RELEASY_SUCCESS) {
+        fprintf(stderr, "%s failed: %s\n", argv[1], changelog_error_string(ret));
+    } else {
+        printf("%-6s %.2fs, peak RSS %ld KiB (%ld KiB after open), %s workers%s\n",
+               argv[1], elapsed, peak_rss_kb(), base_rss, argc > 3 ? argv[3] : "default",
+               log.walk.use_cache ? ", cached" : "");
+    }
+
+    changelog_cleanup(&log);
+    remove("bench_changelog.md");
+    remove("bench_changelog.json");
+    remove("bench_changelog.html");
+    git_repository_free(repo);
+    git_libgit2_shutdown();
+    return ret == RELEASY_SUCCESS ? 0 : 1;
+}
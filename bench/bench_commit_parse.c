@@ -0,0 +1,157 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "changelog.h"
+
+#define CORPUS_SIZE 1000000
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// The parser changelog_parse_message() replaced, kept here for comparison
+static const char *legacy_types[] = {
+    "feat", "fix", "docs", "style", "refactor",
+    "perf", "test", "build", "ci", "chore", "revert"
+};
+
+static int legacy_parse(const char *message, commit_info_t *commit) {
+    memset(commit, 0, sizeof(commit_info_t));
+
+    char *msg_copy = strdup(message);
+    if (!msg_copy) return RELEASY_ERROR;
+
+    char *type_end = strchr(msg_copy, ':');
+    if (!type_end) {
+        free(msg_copy);
+        return CHANGELOG_ERR_INVALID_FORMAT;
+    }
+
+    *type_end = '\0';
+    char *scope_start = strchr(msg_copy, '(');
+    char *scope_end = scope_start ? strchr(scope_start, ')') : NULL;
+    if (scope_start && scope_end) {
+        *scope_end = '\0';
+        scope_start++;
+        commit->scope = strdup(scope_start);
+        *scope_start = '\0';
+    }
+
+    commit->is_breaking = (strstr(msg_copy, "!") != NULL);
+
+    commit->type = COMMIT_TYPE_UNKNOWN;
+    for (int i = 0; i < COMMIT_TYPE_UNKNOWN; i++) {
+        if (strcmp(msg_copy, legacy_types[i]) == 0) {
+            commit->type = (commit_type_t)i;
+            break;
+        }
+    }
+
+    const char *desc = type_end + 1;
+    while (*desc && isspace((unsigned char)*desc)) desc++;
+    commit->description = strdup(desc);
+
+    free(msg_copy);
+    return commit->description ? RELEASY_SUCCESS : RELEASY_ERROR;
+}
+
+// Message mix roughly matching a busy project: short headers, some scoped,
+// some with a body and footers, and merges that are not conventional
+static char **build_corpus(size_t count) {
+    static const char *types[] = { "fix", "feat", "docs", "refactor", "perf", "chore", "test", "ci" };
+    static const char *scopes[] = { "core", "cli", "git", "changelog", "semver" };
+
+    char **corpus = malloc(count * sizeof(char *));
+    if (!corpus) return NULL;
+
+    unsigned int seed = 42;
+    char buf[512];
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = seed >> 8;
+        const char *type = types[r % 8];
+        const char *scope = scopes[(r >> 3) % 5];
+
+        switch ((r >> 6) % 10) {
+            case 0:
+                snprintf(buf, sizeof(buf), "Merge pull request #%u from topic/branch-%u", r % 9999, r % 777);
+                break;
+            case 1:
+            case 2:
+                snprintf(buf, sizeof(buf),
+                         "%s(%s): handle the case where change %zu hits an empty list\n\n"
+                         "The old code assumed at least one element and read past the end\n"
+                         "of the buffer when the list was empty.\n\n"
+                         "Refs: #%u\nSigned-off-by: Some Developer <dev@example.com>\n",
+                         type, scope, i, r % 9999);
+                break;
+            case 3:
+                snprintf(buf, sizeof(buf), "%s!: drop the deprecated API\n\n"
+                         "BREAKING CHANGE: callers must use the new handles\n", type);
+                break;
+            case 4:
+            case 5:
+            case 6:
+                snprintf(buf, sizeof(buf), "%s(%s): change %zu", type, scope, i);
+                break;
+            default:
+                snprintf(buf, sizeof(buf), "%s: change %zu", type, i);
+                break;
+        }
+        corpus[i] = strdup(buf);
+        if (!corpus[i]) {
+            while (i--) free(corpus[i]);
+            free(corpus);
+            return NULL;
+        }
+    }
+    return corpus;
+}
+
+int main(void) {
+    char **corpus = build_corpus(CORPUS_SIZE);
+    if (!corpus) {
+        fprintf(stderr, "Failed to build corpus\n");
+        return 1;
+    }
+
+    printf("Parsing %d commit messages\n\n", CORPUS_SIZE);
+
+    size_t valid = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        conventional_commit_t parsed;
+        if (changelog_parse_message(corpus[i], strlen(corpus[i]), &parsed) == RELEASY_SUCCESS) valid++;
+    }
+    double elapsed = now_seconds() - start;
+    printf("changelog_parse_message: %10.0f msgs/s (%zu valid)\n", CORPUS_SIZE / elapsed, valid);
+
+    valid = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        commit_info_t commit;
+        if (changelog_parse_commit(corpus[i], &commit) == RELEASY_SUCCESS) valid++;
+        changelog_free_commit(&commit);
+    }
+    elapsed = now_seconds() - start;
+    printf("changelog_parse_commit:  %10.0f msgs/s (%zu valid)\n", CORPUS_SIZE / elapsed, valid);
+
+    valid = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        commit_info_t commit;
+        if (legacy_parse(corpus[i], &commit) == RELEASY_SUCCESS) valid++;
+        changelog_free_commit(&commit);
+    }
+    elapsed = now_seconds() - start;
+    printf("previous parser:         %10.0f msgs/s (%zu valid)\n", CORPUS_SIZE / elapsed, valid);
+
+    for (size_t i = 0; i < CORPUS_SIZE; i++) free(corpus[i]);
+    free(corpus);
+    return 0;
+}
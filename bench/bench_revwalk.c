@@ -0,0 +1,112 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <git2.h>
+#include "commit_graph.h"
+
+/*
+ * Usage:
+ *   bench_revwalk <dir> [from]   time from..HEAD (all of HEAD without from)
+ *
+ * Compares a GIT_SORT_TIME revwalk against commit_graph_range(). Build the
+ * repository with `bench_changelog create <dir> 1000000`, then pack it and
+ * write the graph:
+ *
+ *   git -C <dir> gc && git -C <dir> commit-graph write --reachable
+ */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int resolve(git_repository *repo, const char *spec, git_oid *oid) {
+    git_object *obj = NULL, *commit = NULL;
+    if (git_revparse_single(&obj, repo, spec) != 0) return -1;
+    int error = git_object_peel(&commit, obj, GIT_OBJECT_COMMIT);
+    git_object_free(obj);
+    if (error) return -1;
+    *oid = *git_object_id(commit);
+    git_object_free(commit);
+    return 0;
+}
+
+static long revwalk_count(git_repository *repo, const git_oid *to, const git_oid *hide) {
+    git_revwalk *walker = NULL;
+    if (git_revwalk_new(&walker, repo) != 0) return -1;
+    git_revwalk_sorting(walker, GIT_SORT_TIME);
+    git_revwalk_push(walker, to);
+    if (hide) git_revwalk_hide(walker, hide);
+
+    long count = 0;
+    git_oid oid;
+    while (git_revwalk_next(&oid, walker) == 0) count++;
+    git_revwalk_free(walker);
+    return count;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <dir> [from]\n", argv[0]);
+        return 1;
+    }
+
+    git_libgit2_init();
+    git_repository *repo = NULL;
+    if (git_repository_open(&repo, argv[1]) != 0) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        git_libgit2_shutdown();
+        return 1;
+    }
+
+    git_oid to, hide;
+    int ret = resolve(repo, "HEAD", &to);
+    if (ret == 0 && argc > 2) ret = resolve(repo, argv[2], &hide);
+    if (ret != 0) {
+        fprintf(stderr, "Cannot resolve the range\n");
+        git_repository_free(repo);
+        git_libgit2_shutdown();
+        return 1;
+    }
+    const git_oid *hidden = argc > 2 ? &hide : NULL;
+
+    double start = now_seconds();
+    long walked = revwalk_count(repo, &to, hidden);
+    double revwalk_time = now_seconds() - start;
+    printf("revwalk %ld commits in %.3fs\n", walked, revwalk_time);
+
+    // Fresh handle, so the graph run gets no help from the object cache
+    git_repository_free(repo);
+    git_repository_open(&repo, argv[1]);
+
+    commit_graph_t graph;
+    start = now_seconds();
+    ret = commit_graph_open(&graph, repo);
+    if (ret != RELEASY_SUCCESS) {
+        fprintf(stderr, "commit-graph: %s\n", commit_graph_error_string(ret));
+    } else {
+        git_oid *oids = NULL;
+        size_t count = 0;
+        ret = commit_graph_range(&graph, repo, &to, hidden, &oids, &count);
+        double graph_time = now_seconds() - start;
+        if (ret != RELEASY_SUCCESS) {
+            fprintf(stderr, "commit-graph: %s\n", commit_graph_error_string(ret));
+        } else {
+            printf("graph   %zu commits in %.3fs (%.1fx)\n", count, graph_time,
+                   graph_time > 0 ? revwalk_time / graph_time : 0.0);
+            if ((long)count != walked) {
+                fprintf(stderr, "Commit counts differ\n");
+                ret = RELEASY_ERROR;
+            }
+        }
+        free(oids);
+        commit_graph_close(&graph);
+    }
+
+    git_repository_free(repo);
+    git_libgit2_shutdown();
+    return ret == RELEASY_SUCCESS ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <regex.h>
+#include "semver.h"
+
+#define CORPUS_SIZE 1000000
+
+// The pattern semver_parse matched with regexec() before the hand written
+// scanner, timed for comparison
+#define SEMVER_REGEX "^(0|[1-9][0-9]*)\\.(0|[1-9][0-9]*)\\.(0|[1-9][0-9]*)(\\-([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*))?(\\+([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*))?$"
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Tag mix roughly matching a long lived repo: mostly plain releases,
+// some prereleases, a few with build metadata and some non-version tags
+static char **build_corpus(size_t count) {
+    static const char *labels[] = { "alpha", "beta", "rc", "alpha.1", "rc.12" };
+    static const char *junk[] = { "nightly", "latest", "1.0", "release-2020", "v1.2.3.4" };
+
+    char **corpus = malloc(count * sizeof(char *));
+    if (!corpus) return NULL;
+
+    unsigned int seed = 42;
+    char buf[64];
+    for (size_t i = 0; i < count; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = seed >> 8;
+        int major = r % 20, minor = (r >> 5) % 50, patch = (r >> 11) % 200;
+
+        switch ((r >> 20) % 10) {
+            case 0:
+            case 1:
+                snprintf(buf, sizeof(buf), "%d.%d.%d-%s", major, minor, patch, labels[r % 5]);
+                break;
+            case 2:
+                snprintf(buf, sizeof(buf), "%d.%d.%d-%s+build.%u", major, minor, patch,
+                         labels[r % 5], r % 10000);
+                break;
+            case 3:
+                snprintf(buf, sizeof(buf), "%s", junk[r % 5]);
+                break;
+            default:
+                snprintf(buf, sizeof(buf), "%d.%d.%d", major, minor, patch);
+                break;
+        }
+        corpus[i] = strdup(buf);
+        if (!corpus[i]) {
+            while (i--) free(corpus[i]);
+            free(corpus);
+            return NULL;
+        }
+    }
+    return corpus;
+}
+
+int main(void) {
+    char **corpus = build_corpus(CORPUS_SIZE);
+    if (!corpus) {
+        fprintf(stderr, "Failed to build corpus\n");
+        return 1;
+    }
+
+    size_t *lengths = malloc(CORPUS_SIZE * sizeof(size_t));
+    if (!lengths) return 1;
+    for (size_t i = 0; i < CORPUS_SIZE; i++) lengths[i] = strlen(corpus[i]);
+
+    printf("Parsing %d tags\n\n", CORPUS_SIZE);
+
+    size_t valid = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        semver_view_t view;
+        if (semver_parse_view(corpus[i], lengths[i], &view) == RELEASY_SUCCESS) valid++;
+    }
+    double elapsed = now_seconds() - start;
+    printf("semver_parse_view: %10.0f parses/s (%zu valid)\n", CORPUS_SIZE / elapsed, valid);
+
+    valid = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        semver_t version;
+        if (semver_parse(corpus[i], &version) == RELEASY_SUCCESS) {
+            valid++;
+            semver_free(&version);
+        }
+    }
+    elapsed = now_seconds() - start;
+    printf("semver_parse:      %10.0f parses/s (%zu valid)\n", CORPUS_SIZE / elapsed, valid);
+
+    // Matching alone, without the atoi() calls and prerelease/build copies
+    // the old parser made afterwards, so this is an upper bound on its speed
+    regex_t regex;
+    if (regcomp(&regex, SEMVER_REGEX, REG_EXTENDED) != 0) {
+        fprintf(stderr, "Failed to compile regex\n");
+        return 1;
+    }
+    valid = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        regmatch_t matches[10];
+        if (regexec(&regex, corpus[i], 10, matches, 0) == 0) valid++;
+    }
+    elapsed = now_seconds() - start;
+    printf("regexec:           %10.0f parses/s (%zu valid)\n", CORPUS_SIZE / elapsed, valid);
+    regfree(&regex);
+
+    for (size_t i = 0; i < CORPUS_SIZE; i++) free(corpus[i]);
+    free(corpus);
+    free(lengths);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#ifndef RELEASY_ARENA_H
+#define RELEASY_ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_FIRST_CHUNK 4096
+#define ARENA_MAX_CHUNK (1024 * 1024)
+
+typedef struct arena_chunk arena_chunk_t;
+
+// Bump-pointer allocator for many small objects that die together.
+// Chunks double in size up to ARENA_MAX_CHUNK; nothing is freed on its own.
+typedef struct {
+    arena_chunk_t *head;    // Chunk being carved, newest first
+    size_t used;            // Bytes handed out from head
+    size_t next_size;       // Size of the next chunk
+} arena_t;
+
+void arena_init(arena_t *arena);
+void *arena_alloc(arena_t *arena, size_t size);
+char *arena_strdup(arena_t *arena, const char *str);
+char *arena_strndup(arena_t *arena, const char *str, size_t len);
+
+// Forgets every allocation but keeps the newest chunk for reuse
+void arena_reset(arena_t *arena);
+void arena_cleanup(arena_t *arena);
+
+#endif // RELEASY_ARENA_H
@@ -0,0 +1,46 @@
+#ifndef RELEASY_AUTHOR_TABLE_H
+#define RELEASY_AUTHOR_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+// Not an author: commits without a signature, or built outside a walk
+#define AUTHOR_NONE 0
+
+#define AUTHOR_TABLE_FIRST_SLOTS 256
+
+typedef struct {
+    const char *signature;  // "Name <email>", stored once in the table's arena
+    size_t length;
+    uint64_t hash;
+} author_t;
+
+// Every distinct author seen by a changelog, numbered from 1 in order of
+// first appearance. Open addressing with linear probing over the ids; the
+// hash is kept beside each author so growing never rehashes a string.
+typedef struct {
+    uint32_t *slots;        // Author ids, AUTHOR_NONE where empty; a power of two long
+    size_t capacity;
+    author_t *authors;      // authors[id - 1]
+    uint32_t count;
+    size_t authors_capacity;
+    arena_t arena;
+    size_t string_bytes;    // Signatures copied into the arena
+} author_table_t;
+
+void author_table_init(author_table_t *table);
+
+// The id of the signature, adding it when new; AUTHOR_NONE when out of memory
+uint32_t author_table_intern(author_table_t *table, const char *signature, size_t length);
+
+// The same for "name <email>", hashed and compared part by part, so the
+// signature is only put together for an author not seen before
+uint32_t author_table_intern_parts(author_table_t *table, const char *name, const char *email);
+const author_t *author_table_get(const author_table_t *table, uint32_t id);
+
+// Bytes held by the table, strings included
+size_t author_table_memory(const author_table_t *table);
+void author_table_cleanup(author_table_t *table);
+
+#endif // RELEASY_AUTHOR_TABLE_H
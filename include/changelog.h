@@ -1,8 +1,12 @@
 #ifndef RELEASY_CHANGELOG_H
 #define RELEASY_CHANGELOG_H
 
+#include <stdint.h>
 #include <git2.h>
 #include "releasy.h"
+#include "arena.h"
+#include "author_table.h"
+#include "changelog_backup.h"
 
 // Error codes
 #define CHANGELOG_ERR_NO_COMMITS -300
@@ -18,6 +22,32 @@
 #define CHANGELOG_ERR_INVALID_PATH -310
 #define CHANGELOG_ERR_INVALID_CONFIG -311
 #define CHANGELOG_ERR_INVALID_VERSION -312
+#define CHANGELOG_ERR_SECTION_NOT_FOUND -313
+
+#define CHANGELOG_MAX_WORKERS 16
+#define CHANGELOG_WALK_BATCH 1024
+
+#define CHANGELOG_WALK_OPTIONS_INIT { 0, CHANGELOG_WALK_BATCH, 1, NULL, 0, 0, 0, NULL }
+
+typedef struct {
+    int workers;        // 0 means one per online CPU, up to CHANGELOG_MAX_WORKERS
+    size_t batch_size;  // Commits handed to the workers at a time; shorter ranges are parsed on the calling thread
+    int use_cache;      // Reuse and extend the parsed commits in .git/releasy/commits.cache
+    const char *path;   // Only commits changing this directory or file; NULL for all
+    int first_parent;   // Mainline only, merges listed under their pull request titles
+    int expand_merges;  // With first_parent, follow each merge with the commits it brought in
+    int cherry_pick;    // Leave out repeated changes and reverted pairs, matched by patch id
+    const char *compare;    // Also leave out changes this branch already has; implies cherry_pick
+} changelog_walk_options_t;
+
+// Output formats, combined as a mask in changelog_t.formats
+typedef enum {
+    CHANGELOG_FORMAT_MARKDOWN = 1,
+    CHANGELOG_FORMAT_JSON = 2,
+    CHANGELOG_FORMAT_HTML = 4
+} changelog_format_t;
+
+#define CHANGELOG_FORMAT_ALL (CHANGELOG_FORMAT_MARKDOWN | CHANGELOG_FORMAT_JSON | CHANGELOG_FORMAT_HTML)
 
 // Commit types for conventional commits
 typedef enum {
@@ -35,6 +65,23 @@ typedef enum {
     COMMIT_TYPE_UNKNOWN
 } commit_type_t;
 
+// A run of bytes inside a commit message, not NUL-terminated
+typedef struct {
+    const char *ptr;    // NULL when the part is absent
+    size_t len;
+} changelog_span_t;
+
+// A conventional commit split in place; every span points into the message
+typedef struct {
+    commit_type_t type;
+    changelog_span_t type_name;
+    changelog_span_t scope;
+    changelog_span_t description;
+    changelog_span_t body;
+    changelog_span_t footer;    // Trailing "Token: value" paragraph, e.g. BREAKING CHANGE or Refs
+    int is_breaking;            // '!' before the colon or a BREAKING CHANGE footer
+} conventional_commit_t;
+
 typedef struct {
     commit_type_t type;
     char *scope;
@@ -44,7 +91,8 @@ typedef struct {
     int is_breaking;
     char *commit_hash;
     char *author;
-    char *date;
+    int64_t timestamp;  // Author time, seconds since the epoch; formatted when rendered
+    uint32_t author_id; // In the author table of the walk that found it; AUTHOR_NONE outside one
 } commit_info_t;
 
 typedef struct {
@@ -53,6 +101,7 @@ typedef struct {
     char *version;
     char *previous_version;
     char *date;
+    int pooled;  // Commits live in the changelog arena, not on the heap
 } changelog_entry_t;
 
 typedef struct {
@@ -63,14 +112,55 @@ typedef struct {
     int group_by_type;
     int include_authors;
     int backup;  // Flag to enable/disable changelog backup
+    changelog_backup_policy_t backup_policy;    // Which older backups are kept
+    int group_by_scope;  // Within a type, list commits of one scope together
+    int formats;    // changelog_format_t mask; JSON and HTML are written beside file_path
+    int include_contributors;   // Close each entry with its authors and their commit counts
+    changelog_walk_options_t walk;
+    arena_t arena;  // Commits collected by changelog_generate()
+    author_table_t authors;     // Each walked commit's author, stored once
 } changelog_t;
 
+// Called once per conventional commit in the walk. The commit and its strings
+// are only valid until the callback returns; a callback that keeps it makes
+// a copy. Anything but RELEASY_SUCCESS stops the walk and is returned.
+typedef int (*changelog_commit_cb)(const commit_info_t *commit, void *payload);
+
 // Function declarations
 int changelog_init(changelog_t *log, const char *file_path);
 int changelog_parse_commit(const char *message, commit_info_t *commit);
+
+// Parses "type(scope)!: description", then the body and footers, without
+// copying. Returns CHANGELOG_ERR_INVALID_FORMAT for a header that is not a
+// conventional commit and RELEASY_ERROR when the description is empty.
+int changelog_parse_message(const char *message, size_t len, conventional_commit_t *out);
+// version may be the tag spelling ("v1.2.0"); the entry is named "1.2.0"
 int changelog_generate(changelog_t *log, git_repository *repo, const char *version);
+
+// Rebuilds an entry for every version tag in one topological walk of the
+// history. Each commit goes to the oldest release that contains it; the
+// entries are appended newest first. With walk.path set only commits
+// touching that path are listed.
+int changelog_generate_all(changelog_t *log, git_repository *repo);
+
+// Walks from (exclusive) to to (HEAD when NULL), newest first. A NULL from
+// walks the whole history. Commits are looked up and parsed a batch at a
+// time on a pool of threads, each with its own repository handle, and reach
+// cb on the calling thread in walk order. With cherry_pick the range is
+// read in full first, to find its duplicates. opts may be NULL.
+int changelog_walk(git_repository *repo, const char *from, const char *to,
+                   const changelog_walk_options_t *opts, changelog_commit_cb cb, void *payload);
+
+// Like changelog_generate() followed by changelog_write(), but the new
+// entry is rendered while the history is walked instead of being kept in
+// memory, so ranges of any length are written in bounded memory. Only the
+// Markdown changelog is written.
+int changelog_generate_stream(changelog_t *log, git_repository *repo, const char *version);
+
+// Splices the entries into the Markdown changelog, and writes them to
+// CHANGELOG.json and CHANGELOG.html (after file_path) for the other formats
 int changelog_write(changelog_t *log);
-int changelog_free_commit(commit_info_t *commit);
+int changelog_free_commit(commit_info_t *commit);  // Heap commits only, e.g. from changelog_parse_commit()
 int changelog_free_entry(changelog_entry_t *entry);
 void changelog_cleanup(changelog_t *log);
 
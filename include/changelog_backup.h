@@ -0,0 +1,49 @@
+#ifndef RELEASY_CHANGELOG_BACKUP_H
+#define RELEASY_CHANGELOG_BACKUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Backups sit beside the changelog as <file>.<YYYYmmdd_HHMMSS>.<hash>.bak,
+// the hash being of their content, so identical ones are found by name
+#define CHANGELOG_BACKUP_SUFFIX ".bak"
+#define CHANGELOG_BACKUP_STAMP_LENGTH 15
+#define CHANGELOG_BACKUP_HASH_LENGTH 16
+
+// Which backups survive a new one. The one just made always does. Nothing
+// is removed unless asked for: by default every backup is kept.
+typedef struct {
+    size_t keep;        // Newest backups kept, 0 for all
+    int64_t max_age;    // Seconds; older backups are removed, 0 for no limit
+} changelog_backup_policy_t;
+
+#define CHANGELOG_BACKUP_POLICY_INIT { 0, 0 }
+
+// How the backup came to be, cheapest first
+typedef enum {
+    CHANGELOG_BACKUP_EXISTING,      // The same content was already saved this second
+    CHANGELOG_BACKUP_LINKED,        // Hard link to an older backup with the same content
+    CHANGELOG_BACKUP_CLONED,        // Reflink; shares extents until either side changes
+    CHANGELOG_BACKUP_COPY_RANGE,    // copy_file_range(), in the kernel
+    CHANGELOG_BACKUP_COPIED         // Written out from a mapping of the changelog
+} changelog_backup_method_t;
+
+typedef struct {
+    char *path;
+    changelog_backup_method_t method;
+    size_t removed;     // Older backups dropped by the policy
+} changelog_backup_result_t;
+
+// Backs up path as of now and applies the policy. result may be NULL;
+// otherwise free it with changelog_backup_result_free().
+int changelog_backup(const char *path, const changelog_backup_policy_t *policy,
+                     changelog_backup_result_t *result);
+void changelog_backup_result_free(changelog_backup_result_t *result);
+
+// Removes backups of path the policy no longer keeps, newest first by the
+// time in their names. Backups from before content hashes count too.
+int changelog_backup_prune(const char *path, const changelog_backup_policy_t *policy,
+                           time_t now, size_t *removed);
+
+#endif // RELEASY_CHANGELOG_BACKUP_H
@@ -0,0 +1,63 @@
+#ifndef RELEASY_CHANGELOG_INDEX_H
+#define RELEASY_CHANGELOG_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "changelog.h"
+
+#define CHANGELOG_INDEX_MAGIC "RLSYCLOG"
+#define CHANGELOG_INDEX_FORMAT 1
+
+// One "## [version]" section: from its heading up to the next "## " heading
+// or the end of the file. Versions are kept without a leading "v".
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    uint32_t name_offset;
+    uint32_t name_length;
+} changelog_index_entry_t;
+
+// On-disk layout: header, entries sorted by version, version names. The
+// changelog it was built from is recorded by size and mtime.
+typedef struct {
+    char magic[8];
+    uint32_t format;
+    uint32_t byte_order;
+    uint32_t entry_size;
+    uint32_t count;
+    uint64_t names_size;
+    int64_t source_size;
+    int64_t source_mtime_sec;
+    int64_t source_mtime_nsec;
+} changelog_index_header_t;
+
+// A read-only mapping of the changelog and where its sections are, either
+// from the sidecar file or scanned just now
+typedef struct {
+    const char *data;
+    size_t size;
+    const changelog_index_entry_t *entries;
+    size_t count;
+    const char *names;
+    void *sidecar;          // Mapped sidecar, when it was current
+    size_t sidecar_size;
+    changelog_index_entry_t *built;     // Scanned entries and names otherwise
+    char *built_names;
+    int from_cache;
+} changelog_index_t;
+
+// Maps changelog_path and indexes it. cache_path, when set, is read if it
+// still matches the changelog and rewritten if it does not.
+int changelog_index_open(changelog_index_t *index, const char *changelog_path, const char *cache_path);
+
+// The section for version ("1.2.0" or "v1.2.0") as it sits in the mapping,
+// by binary search. CHANGELOG_ERR_SECTION_NOT_FOUND when there is none.
+int changelog_index_find(const changelog_index_t *index, const char *version,
+                         const char **section, size_t *length);
+void changelog_index_close(changelog_index_t *index);
+
+// .git/releasy/changelog-<hash of the changelog's real path>.idx, given
+// the repository's common dir with its trailing slash
+char *changelog_index_cache_path(const char *git_dir, const char *changelog_path);
+
+#endif // RELEASY_CHANGELOG_INDEX_H
@@ -0,0 +1,94 @@
+#ifndef RELEASY_CHANGELOG_RENDER_H
+#define RELEASY_CHANGELOG_RENDER_H
+
+#include "changelog.h"
+
+// Bytes of formatted text held before they are written out
+#define CHANGELOG_RENDER_BUFFER (256 * 1024)
+
+// Pieces gathered into one writev(); well under any IOV_MAX
+#define CHANGELOG_RENDER_IOVECS 256
+
+// Buffer of a piece-at-a-time Markdown writer, one per open spool
+#define CHANGELOG_MARKDOWN_BUFFER (16 * 1024)
+
+// Strings at least this long are written from the commit rather than copied
+#define CHANGELOG_RENDER_ZERO_COPY 64
+
+// An author of an entry and how many of its listed commits they wrote
+typedef struct {
+    uint32_t author;
+    const char *signature;
+    size_t commits;
+} changelog_contributor_t;
+
+// An entry's commits in rendering order: bucket t, for each commit type,
+// is commits[starts[t]] up to commits[starts[t + 1]]. Without grouping
+// there is a single bucket, in walk order.
+typedef struct {
+    const commit_info_t **commits;
+    size_t starts[COMMIT_TYPE_UNKNOWN + 2];
+    changelog_contributor_t *contributors;  // Only when the log includes them
+    size_t contributor_count;
+} changelog_buckets_t;
+
+// Entries bucketed once and rendered in any number of formats. The
+// entries are borrowed and must outlive the model.
+typedef struct {
+    changelog_entry_t *const *entries;
+    size_t count;
+    changelog_buckets_t *buckets;
+    int group_by_type;
+    int group_by_scope;
+    int include_metadata;
+    int include_authors;
+    int include_contributors;
+} changelog_model_t;
+
+// One counting pass over each entry; within a type, commits sharing a
+// scope are kept together when the log asks for it. Contributors are
+// counted by author id, so only commits interned in the log's author
+// table are credited.
+int changelog_model_build(changelog_model_t *model, const changelog_t *log,
+                          changelog_entry_t *const *entries, size_t count);
+
+// Markdown is the "## [version]" sections alone, for splicing into a
+// changelog; JSON and HTML are whole documents
+int changelog_model_render(const changelog_model_t *model, changelog_format_t format, int fd);
+void changelog_model_free(changelog_model_t *model);
+
+/*
+ * Markdown written a piece at a time, in the same layout the model renders,
+ * for output whose commits are freed as soon as they are written. Commit
+ * strings are copied, so nothing passed in needs to outlive the call. A
+ * failed write is remembered and reported by flush and close.
+ */
+typedef struct changelog_markdown changelog_markdown_t;
+
+// NULL when out of memory; grouped lines carry the scope instead of the type
+changelog_markdown_t *changelog_markdown_open(int fd, int group_by_type, int include_authors);
+
+// Text as it is, such as lines kept from an existing changelog
+void changelog_markdown_text(changelog_markdown_t *md, const char *text, size_t len);
+
+// The model's "## [version]" sections, as changelog_model_render() writes them
+void changelog_markdown_sections(changelog_markdown_t *md, const changelog_model_t *model);
+
+void changelog_markdown_entry(changelog_markdown_t *md, const char *version, const char *date);
+void changelog_markdown_type(changelog_markdown_t *md, commit_type_t type);
+void changelog_markdown_commit(changelog_markdown_t *md, const commit_info_t *commit);
+void changelog_markdown_contributors(changelog_markdown_t *md, const changelog_contributor_t *contributors,
+                                     size_t count);
+
+// CHANGELOG_ERR_FILE_ACCESS once any write has failed
+int changelog_markdown_flush(changelog_markdown_t *md);
+int changelog_markdown_close(changelog_markdown_t *md);
+
+// Most commits first, then by signature
+void changelog_contributors_sort(changelog_contributor_t *contributors, size_t count);
+
+// "md,json,html" to a mask of changelog_format_t
+int changelog_parse_formats(const char *list, int *formats);
+const char *changelog_format_extension(changelog_format_t format);
+
+#endif // RELEASY_CHANGELOG_RENDER_H
@@ -0,0 +1,98 @@
+#ifndef RELEASY_COMMIT_CACHE_H
+#define RELEASY_COMMIT_CACHE_H
+
+#include <stdint.h>
+#include <git2.h>
+#include "releasy.h"
+#include "changelog.h"
+
+// Error codes
+#define COMMIT_CACHE_ERR_CORRUPT -1100
+#define COMMIT_CACHE_ERR_FILE_ACCESS -1101
+#define COMMIT_CACHE_ERR_MEMORY -1102
+#define COMMIT_CACHE_ERR_LOCKED -1103
+
+#define COMMIT_CACHE_FILE "commits.cache"
+#define COMMIT_CACHE_MAGIC "RLSYCMTS"
+#define COMMIT_CACHE_FORMAT 1
+#define COMMIT_CACHE_MAX_BYTES (64 * 1024 * 1024)
+
+// Entry flags
+#define COMMIT_CACHE_CONVENTIONAL 0x01  // Not set: the commit has no conventional header
+#define COMMIT_CACHE_BREAKING 0x02
+#define COMMIT_CACHE_HAS_SCOPE 0x04
+#define COMMIT_CACHE_HAS_BODY 0x08
+#define COMMIT_CACHE_HAS_FOOTER 0x10
+#define COMMIT_CACHE_HAS_AUTHOR 0x20
+
+// On-disk layout: header, entries sorted by commit id, then one record per
+// conventional commit holding scope, description, body, footer and author
+// as NUL terminated strings in that order
+typedef struct {
+    char magic[8];
+    uint32_t format;
+    uint32_t byte_order;
+    uint32_t entry_size;
+    uint32_t count;
+    uint64_t data_size;
+    uint64_t generation;    // Bumped on every rewrite
+} commit_cache_header_t;
+
+typedef struct {
+    int64_t timestamp;      // Author time, seconds since the epoch
+    uint64_t generation;    // Last rewrite that saw the commit used
+    unsigned char oid[GIT_OID_RAWSZ];
+    uint32_t data_offset;
+    uint32_t data_length;
+    uint8_t type;
+    uint8_t flags;
+    uint16_t reserved;
+} commit_cache_entry_t;
+
+typedef enum {
+    COMMIT_CACHE_MISS,
+    COMMIT_CACHE_HIT,           // info filled in
+    COMMIT_CACHE_HIT_OTHER      // Known not to be a conventional commit
+} commit_cache_result_t;
+
+// A read-only mapping of .git/releasy/commits.cache plus the commits parsed
+// since it was opened. Commits never change, so entries never go stale;
+// the file is only bounded in size.
+typedef struct {
+    void *map;
+    size_t map_size;
+    const commit_cache_header_t *header;
+    const commit_cache_entry_t *entries;
+    const char *data;
+    size_t count;
+    unsigned char *used;            // One flag per mapped entry
+    commit_cache_entry_t *added;    // data_offset points into added_data
+    size_t added_count;
+    size_t added_capacity;
+    char *added_data;
+    size_t added_size;
+    size_t added_data_capacity;
+    size_t max_bytes;               // Size budget for the next save
+} commit_cache_t;
+
+// A missing or unreadable cache opens empty; it is replaced on save
+int commit_cache_open(commit_cache_t *cache, git_repository *repo);
+
+// Safe to call from several threads at once. On a hit the strings point
+// into the mapping; commit_hash and date are left for the caller.
+commit_cache_result_t commit_cache_lookup(commit_cache_t *cache, const git_oid *oid,
+                                          commit_info_t *info);
+
+// Records a freshly parsed commit, NULL info for one that is not
+// conventional. Not thread-safe.
+int commit_cache_add(commit_cache_t *cache, const git_oid *oid, const commit_info_t *info);
+
+// Merges what was added into the file, dropping the least recently used
+// entries past max_bytes. Returns COMMIT_CACHE_ERR_LOCKED when another
+// process is writing it.
+int commit_cache_save(commit_cache_t *cache, git_repository *repo);
+void commit_cache_close(commit_cache_t *cache);
+
+const char *commit_cache_error_string(int error_code);
+
+#endif // RELEASY_COMMIT_CACHE_H
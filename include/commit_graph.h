@@ -0,0 +1,92 @@
+#ifndef RELEASY_COMMIT_GRAPH_H
+#define RELEASY_COMMIT_GRAPH_H
+
+#include <stdint.h>
+#include <git2.h>
+#include "releasy.h"
+
+// Error codes
+#define COMMIT_GRAPH_ERR_NOT_FOUND -1200
+#define COMMIT_GRAPH_ERR_CORRUPT -1201
+#define COMMIT_GRAPH_ERR_FILE_ACCESS -1202
+#define COMMIT_GRAPH_ERR_MEMORY -1203
+#define COMMIT_GRAPH_ERR_STALE -1204
+#define COMMIT_GRAPH_ERR_GIT_OPERATION -1205
+
+#define COMMIT_GRAPH_FILE "objects/info/commit-graph"
+#define COMMIT_GRAPH_NONE UINT32_MAX
+
+// Commits newer than the graph a range may read from the object database
+#define COMMIT_GRAPH_MAX_OVERLAY 10000
+
+// A read-only mapping of the commit-graph file `git commit-graph write`
+// leaves in the object directory. Commits are addressed by their position
+// in the file. Split graph chains are not read.
+typedef struct {
+    void *map;
+    size_t map_size;
+    const unsigned char *fanout;        // OIDF: 256 cumulative counts
+    const unsigned char *oids;          // OIDL: sorted commit ids
+    const unsigned char *commits;       // CDAT: tree, parents, generation and time
+    const unsigned char *extra_edges;   // EDGE: parents of octopus merges
+    size_t extra_edges_count;
+    uint32_t count;
+    const unsigned char *bloom_index;   // BIDX: where each commit's filter ends
+    const unsigned char *bloom_data;    // BDAT: changed-path filters, after the header
+    size_t bloom_data_size;
+    uint32_t bloom_version;             // Murmur3 flavour, 0 without filters
+    uint32_t bloom_hashes;
+} commit_graph_t;
+
+// A path hashed for the changed-path filters
+typedef struct {
+    uint32_t hash0;
+    uint32_t hash1;
+} commit_graph_bloom_key_t;
+
+int commit_graph_open(commit_graph_t *graph, git_repository *repo);
+
+// Position of oid in the graph, or COMMIT_GRAPH_NONE for a commit written
+// after the graph was
+uint32_t commit_graph_find(const commit_graph_t *graph, const git_oid *oid);
+void commit_graph_oid(const commit_graph_t *graph, uint32_t pos, git_oid *oid);
+
+// Topological level: one more than the highest of the parents, so a commit
+// can only reach commits with a lower generation
+uint32_t commit_graph_generation(const commit_graph_t *graph, uint32_t pos);
+int64_t commit_graph_time(const commit_graph_t *graph, uint32_t pos);
+
+// Fills up to max parent positions and returns how many the commit has
+size_t commit_graph_parents(const commit_graph_t *graph, uint32_t pos,
+                            uint32_t *parents, size_t max);
+
+// Keys for path and every directory above it, the way git probes the
+// filters. COMMIT_GRAPH_ERR_NOT_FOUND when the graph has no usable filters.
+int commit_graph_bloom_keys(const commit_graph_t *graph, const char *path,
+                            commit_graph_bloom_key_t **keys, size_t *count);
+
+// 0 when the commit certainly left path as its first parent had it, 1 when
+// it may have changed it or the graph cannot tell
+int commit_graph_bloom_maybe_changed(const commit_graph_t *graph, uint32_t pos,
+                                     const commit_graph_bloom_key_t *keys, size_t count);
+
+// The commits reachable from to but not from hide (may be NULL), children
+// before parents like a GIT_SORT_TOPOLOGICAL | GIT_SORT_TIME revwalk: by
+// generation, then newest first. Parents, generations and dates all
+// come from the graph; only commits written since it are read from the
+// object database, and past COMMIT_GRAPH_MAX_OVERLAY of those it returns
+// COMMIT_GRAPH_ERR_STALE. *oids is the caller's to free.
+int commit_graph_range(const commit_graph_t *graph, git_repository *repo, const git_oid *to,
+                       const git_oid *hide, git_oid **oids, size_t *count);
+
+// Like commit_graph_range(), following only the first parent of each
+// commit, newest first down the chain
+int commit_graph_first_parent_range(const commit_graph_t *graph, git_repository *repo,
+                                    const git_oid *to, const git_oid *hide,
+                                    git_oid **oids, size_t *count);
+
+void commit_graph_close(commit_graph_t *graph);
+
+const char *commit_graph_error_string(int error_code);
+
+#endif // RELEASY_COMMIT_GRAPH_H
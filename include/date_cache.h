@@ -0,0 +1,43 @@
+#ifndef RELEASY_DATE_CACHE_H
+#define RELEASY_DATE_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define DATE_DAY_LENGTH 10  // "YYYY-MM-DD"
+#define DATE_CACHE_SLOTS 64
+
+// A local calendar day, [start, end) in seconds since the epoch
+typedef struct {
+    int64_t start;
+    int64_t end;
+    char day[DATE_DAY_LENGTH + 1];
+} date_span_t;
+
+// The local days overlapping one UTC day: at most the one it starts in and
+// the one it ends in
+typedef struct {
+    int64_t utc_day;
+    date_span_t spans[2];
+} date_slot_t;
+
+// Formatted local days, direct-mapped by UTC day. One cache per thread;
+// nothing in it is shared, and localtime_r() is only called on a miss.
+typedef struct {
+    date_slot_t slots[DATE_CACHE_SLOTS];
+    char scratch[DATE_DAY_LENGTH + 1];  // Days that are never cached
+    size_t hits;
+    size_t misses;
+} date_cache_t;
+
+void date_cache_init(date_cache_t *cache);
+
+// "YYYY-MM-DD" in local time, valid until the next call; NULL if the time
+// cannot be converted. Days whose UTC offset changes part way through (DST
+// switches) are formatted every time rather than cached.
+const char *date_cache_day(date_cache_t *cache, int64_t timestamp);
+
+// The same without a cache; buf holds DATE_DAY_LENGTH + 1 bytes
+int date_format_day(int64_t timestamp, char *buf);
+
+#endif // RELEASY_DATE_CACHE_H
@@ -4,6 +4,8 @@
 #include <git2.h>
 #include "releasy.h"
 #include "semver.h"
+#include "version_list.h"
+#include "worktree_status.h"
 
 #define GIT_ERR_REPO_NOT_FOUND -200
 #define GIT_ERR_TAG_EXISTS -201
@@ -18,6 +20,8 @@
 
 typedef struct {
     git_repository *repo;
+    git_config *config;     // Borrowed config snapshot, NULL to read from repo
+    int borrowed;           // repo belongs to someone else, don't free it
     git_signature *signature;
     char *current_branch;
     char *latest_tag;
@@ -28,7 +32,9 @@ typedef struct {
 
 int git_ops_init(git_context_t *ctx);
 int git_ops_open_repo(git_context_t *ctx, const char *path);
+int git_ops_use_repo(git_context_t *ctx, git_repository *repo, git_config *config);
 int git_ops_check_dirty(git_context_t *ctx);
+int git_ops_status_report(git_context_t *ctx, worktree_report_t *report);
 int git_ops_get_latest_tag(git_context_t *ctx, char **tag);
 int git_ops_list_tags(git_context_t *ctx, char ***tags, size_t *count);
 int git_ops_create_tag(git_context_t *ctx, const char *version, const char *user_name, const char *user_email);
@@ -46,6 +52,8 @@ int git_ops_compare_versions(const char *version1, const char *version2);
 int git_ops_is_version_tag(git_context_t *ctx, const char *tag_name);
 int git_ops_get_version_history(git_context_t *ctx, char ***versions, size_t *count);
 int git_ops_get_latest_version(git_context_t *ctx, char *version, size_t size);
+int git_ops_find_latest_version(git_context_t *ctx, const version_filter_t *filter,
+                                char *version, size_t size);
 
 const char *git_ops_error_string(int error_code);
 void git_ops_cleanup(git_context_t *ctx);
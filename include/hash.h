@@ -0,0 +1,23 @@
+#ifndef RELEASY_HASH_H
+#define RELEASY_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 64-bit FNV-1a. Cheap and good enough for the short keys and file
+// contents it is used on; not for anything an attacker chooses.
+#define HASH_FNV1A_INIT 0xcbf29ce484222325ULL
+#define HASH_FNV1A_PRIME 0x100000001b3ULL
+
+// Continues hash over data, so a key made of several pieces hashes the
+// same as the pieces joined; start from HASH_FNV1A_INIT
+static inline uint64_t hash_fnv1a(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= HASH_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+#endif // RELEASY_HASH_H
@@ -0,0 +1,79 @@
+#ifndef RELEASY_PATCH_ID_H
+#define RELEASY_PATCH_ID_H
+
+#include <stdint.h>
+#include <git2.h>
+#include "releasy.h"
+
+// Error codes
+#define PATCH_ID_ERR_CORRUPT -1300
+#define PATCH_ID_ERR_FILE_ACCESS -1301
+#define PATCH_ID_ERR_MEMORY -1302
+#define PATCH_ID_ERR_LOCKED -1303
+#define PATCH_ID_ERR_GIT_OPERATION -1304
+
+#define PATCH_ID_CACHE_FILE "patch-ids.cache"
+#define PATCH_ID_CACHE_MAGIC "RLSYPTCH"
+#define PATCH_ID_CACHE_FORMAT 1
+#define PATCH_ID_CACHE_MAX_ENTRIES (1024 * 1024)
+
+#define PATCH_ID_MAX_WORKERS 16
+
+// What is known about one commit. A zero patch id means there is nothing
+// to compare: a merge, or a commit that changes no file. A zero reverts
+// means the message names no reverted commit.
+typedef struct {
+    unsigned char commit[GIT_OID_RAWSZ];
+    unsigned char patch[GIT_OID_RAWSZ];
+    unsigned char reverts[GIT_OID_RAWSZ];
+} patch_id_entry_t;
+
+// On-disk layout: header, then entries sorted by commit id
+typedef struct {
+    char magic[8];
+    uint32_t format;
+    uint32_t byte_order;
+    uint32_t entry_size;
+    uint32_t count;
+} patch_id_header_t;
+
+// A read-only mapping of .git/releasy/patch-ids.cache plus the commits
+// computed since it was opened. A commit's diff never changes, so entries
+// never go stale.
+typedef struct {
+    void *map;
+    size_t map_size;
+    const patch_id_entry_t *entries;
+    size_t count;
+    patch_id_entry_t *added;
+    size_t added_count;
+    size_t added_capacity;
+} patch_id_cache_t;
+
+// A missing or unreadable cache opens empty; it is replaced on save
+int patch_id_cache_open(patch_id_cache_t *cache, git_repository *repo);
+
+// 1 and the entry when the file has the commit, 0 otherwise. Safe to call
+// from several threads at once; entries added since open are not seen.
+int patch_id_cache_lookup(const patch_id_cache_t *cache, const git_oid *oid, patch_id_entry_t *entry);
+int patch_id_cache_add(patch_id_cache_t *cache, const patch_id_entry_t *entry);
+
+// Merges what was added into the file. Returns PATCH_ID_ERR_LOCKED when
+// another process is writing it.
+int patch_id_cache_save(patch_id_cache_t *cache, git_repository *repo);
+void patch_id_cache_close(patch_id_cache_t *cache);
+
+// The stable patch id of a commit against its first parent, as
+// `git patch-id --stable` gives it, and the commit a "This reverts commit"
+// line names
+int patch_id_compute(git_repository *repo, const git_oid *oid, patch_id_entry_t *entry);
+
+// patch_id_compute() for every commit, answered from cache (may be NULL)
+// where it can and otherwise on up to workers threads, each with its own
+// repository handle. Fresh results are added to the cache.
+int patch_id_compute_all(git_repository *repo, patch_id_cache_t *cache, const git_oid *oids,
+                         size_t count, int workers, patch_id_entry_t *entries);
+
+const char *patch_id_error_string(int error_code);
+
+#endif // RELEASY_PATCH_ID_H
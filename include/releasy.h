@@ -25,6 +25,16 @@ typedef struct {
     int changelog_include_metadata;
     int changelog_include_authors;
     int changelog_backup;
+    int changelog_backup_keep;          // 0 keeps every backup
+    int changelog_backup_max_age_days;  // 0 for no age limit
+    char *changelog_scope;  // Directory the changelog is limited to, NULL for the whole repo
+    int changelog_first_parent;
+    int changelog_expand_merges;
+    int changelog_cherry_pick;
+    char *changelog_compare;  // Branch whose changes are left out, NULL for none
+    int changelog_group_by_scope;
+    int changelog_formats;  // changelog_format_t mask
+    int changelog_include_contributors;
 } releasy_config_t;
 
 extern releasy_config_t g_config;
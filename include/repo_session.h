@@ -0,0 +1,31 @@
+#ifndef RELEASY_REPO_SESSION_H
+#define RELEASY_REPO_SESSION_H
+
+#include <git2.h>
+#include "releasy.h"
+
+// Error codes
+#define REPO_SESSION_ERR_NOT_FOUND -900
+#define REPO_SESSION_ERR_GIT_OPERATION -901
+
+// The repository a command works on, opened once per process. Every handle
+// handed out is borrowed: callers must not free them, and they stay valid
+// until repo_session_close().
+typedef struct {
+    git_repository *repo;
+    git_config *config;     // Snapshot taken at open, read-only
+    git_odb *odb;
+    char *path;
+} repo_session_t;
+
+int repo_session_open(const char *path);
+int repo_session_is_open(void);
+const repo_session_t *repo_session_get(void);
+git_repository *repo_session_repo(void);
+git_config *repo_session_config(void);
+git_odb *repo_session_odb(void);
+void repo_session_close(void);
+
+const char *repo_session_error_string(int error_code);
+
+#endif // RELEASY_REPO_SESSION_H
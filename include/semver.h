@@ -2,7 +2,7 @@
 #define RELEASY_SEMVER_H
 
 #include <stdlib.h>
-#include <regex.h>
+#include <stdint.h>
 #include "releasy.h"
 
 #define SEMVER_ERR_INVALID_FORMAT -100
@@ -21,10 +21,52 @@ typedef struct {
     char *build;
 } semver_t;
 
+// Byte range inside the string handed to semver_parse_view()
+typedef struct {
+    size_t offset;
+    size_t length;
+} semver_span_t;
+
+// Non-owning parse result: prerelease/build point back into the input,
+// a zero length span means the component is absent
+typedef struct {
+    int major;
+    int minor;
+    int patch;
+    semver_span_t prerelease;
+    semver_span_t build;
+} semver_view_t;
+
+#define SEMVER_KEY_SUFFIX_SIZE 28
+
+// Set in prefix[1] when the version has no prerelease, so a release sorts
+// after every prerelease of the same major.minor.patch
+#define SEMVER_KEY_RELEASE 0x1u
+
+// Set in flags when the prerelease didn't fit in the suffix; two truncated
+// keys that compare equal have to be settled with semver_compare()
+#define SEMVER_KEY_TRUNCATED 0x1u
+
+// Precedence key: ordering two keys is one or two integer compares on the
+// packed prefix, plus a memcmp of the encoded prerelease when both are
+// prereleases of the same version. Build metadata is ignored, as per SemVer.
+typedef struct {
+    uint64_t prefix[2];     // major << 32 | minor, patch << 32 | SEMVER_KEY_RELEASE
+    unsigned char suffix[SEMVER_KEY_SUFFIX_SIZE];
+    uint32_t flags;
+} semver_key_t;
+
 int semver_init(semver_t *version);
 int semver_parse(const char *version_str, semver_t *version);
+int semver_parse_view(const char *version_str, size_t len, semver_view_t *view);
 int semver_validate(const semver_t *version);
 int semver_compare(const semver_t *v1, const semver_t *v2);
+int semver_key_from_view(semver_key_t *key, const char *version_str, const semver_view_t *view);
+int semver_key_from_version(semver_key_t *key, const semver_t *version);
+int semver_key_parse(const char *version_str, size_t len, semver_key_t *key);
+int semver_key_compare(const semver_key_t *k1, const semver_key_t *k2);
+int semver_key_compare_exact(const semver_key_t *k1, const char *version1,
+                             const semver_key_t *k2, const char *version2);
 char *semver_to_string(const semver_t *version);
 const char *semver_error_string(int error_code);
 void semver_free(semver_t *version);
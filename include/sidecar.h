@@ -0,0 +1,52 @@
+#ifndef RELEASY_SIDECAR_H
+#define RELEASY_SIDECAR_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include "releasy.h"
+
+// Error codes
+#define SIDECAR_ERR_FILE_ACCESS -1400
+#define SIDECAR_ERR_CORRUPT -1401
+#define SIDECAR_ERR_MEMORY -1402
+#define SIDECAR_ERR_LOCKED -1403
+
+// Caches and indexes live in .git/releasy, shared by every worktree
+#define SIDECAR_DIR "releasy"
+
+// Written in host order; a file from a machine of the other order fails
+// the header check and is rebuilt
+#define SIDECAR_BYTE_ORDER 0x01020304u
+
+// A lock older than this was left behind by a process that died mid-write
+#define SIDECAR_LOCK_STALE_SECONDS 60
+
+// Writes go to path.lock, taken with O_EXCL the way git takes its own
+// locks, and are renamed over path once complete
+typedef struct {
+    char *path;
+    char *lock_path;
+    FILE *file;
+} sidecar_writer_t;
+
+// <common_dir><name>, where common_dir is git_repository_commondir() with
+// its trailing slash. The caller frees the result; NULL when common_dir is.
+char *sidecar_common_path(const char *common_dir, const char *name);
+
+// <common_dir>releasy/<name>
+char *sidecar_path(const char *common_dir, const char *name);
+
+// Maps path read-only. SIDECAR_ERR_FILE_ACCESS when it cannot be opened,
+// SIDECAR_ERR_CORRUPT when it is shorter than min_size. st, when set,
+// receives the file's stat.
+int sidecar_map(const char *path, size_t min_size, void **map, size_t *size, struct stat *st);
+
+// Creates the directory and takes the lock. SIDECAR_ERR_LOCKED while
+// another writer holds it.
+int sidecar_begin(sidecar_writer_t *writer, const char *path);
+
+// Renames the lock file over path when ok, and removes it otherwise
+int sidecar_commit(sidecar_writer_t *writer, int ok);
+
+#endif // RELEASY_SIDECAR_H
@@ -0,0 +1,70 @@
+#ifndef RELEASY_TAG_INDEX_H
+#define RELEASY_TAG_INDEX_H
+
+#include <stdint.h>
+#include <git2.h>
+#include "releasy.h"
+#include "semver.h"
+
+// Error codes
+#define TAG_INDEX_ERR_CORRUPT -801
+#define TAG_INDEX_ERR_FILE_ACCESS -802
+#define TAG_INDEX_ERR_GIT_OPERATION -803
+#define TAG_INDEX_ERR_MEMORY -804
+
+#define TAG_INDEX_FILE "tags.idx"
+#define TAG_INDEX_MAGIC "RLSYTAGS"
+#define TAG_INDEX_FORMAT 1
+
+// What the refdb looked like when the index was written. Any tag added,
+// moved or deleted touches packed-refs or the refs/tags directory.
+typedef struct {
+    int64_t packed_refs_mtime_sec;
+    int64_t packed_refs_mtime_nsec;
+    int64_t packed_refs_size;
+    int64_t refs_tags_mtime_sec;
+    int64_t refs_tags_mtime_nsec;
+} tag_index_stamp_t;
+
+// On-disk layout: header, entries sorted by version, NUL terminated names
+typedef struct {
+    char magic[8];
+    uint32_t format;
+    uint32_t byte_order;
+    uint32_t entry_size;
+    uint32_t count;
+    uint64_t names_size;
+    tag_index_stamp_t stamp;
+} tag_index_header_t;
+
+typedef struct {
+    semver_key_t key;
+    unsigned char commit[GIT_OID_RAWSZ];    // Zero when the tag does not peel to a commit
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t reserved;
+} tag_index_entry_t;
+
+// A read-only mapping of .git/releasy/tags.idx
+typedef struct {
+    void *map;
+    size_t map_size;
+    const tag_index_header_t *header;
+    const tag_index_entry_t *entries;
+    const char *names;
+    size_t count;
+    int racy;   // refdb was touched in the same clock tick the index was written
+} tag_index_t;
+
+int tag_index_open(tag_index_t *index, git_repository *repo);
+int tag_index_build(git_repository *repo);
+int tag_index_is_fresh(git_repository *repo);
+int tag_index_read_stamp(git_repository *repo, tag_index_stamp_t *stamp);
+int tag_index_note_created(git_repository *repo, const tag_index_stamp_t *before,
+                           const char *tag_name, const git_oid *commit);
+const char *tag_index_name(const tag_index_t *index, size_t i);
+void tag_index_close(tag_index_t *index);
+
+const char *tag_index_error_string(int error_code);
+
+#endif // RELEASY_TAG_INDEX_H
@@ -0,0 +1,62 @@
+#ifndef RELEASY_VERSION_LIST_H
+#define RELEASY_VERSION_LIST_H
+
+#include <git2.h>
+#include "releasy.h"
+#include "semver.h"
+
+// Error codes
+#define VERSION_LIST_ERR_NOT_FOUND -700
+#define VERSION_LIST_ERR_GIT_OPERATION -701
+#define VERSION_LIST_ERR_MEMORY -702
+#define VERSION_LIST_ERR_BUFFER_TOO_SMALL -703
+
+#define VERSION_FILTER_ANY -1
+#define VERSION_FILTER_INIT { VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_MATCH_ANY }
+
+typedef enum {
+    VERSION_MATCH_ANY,
+    VERSION_MATCH_RELEASE,
+    VERSION_MATCH_PRERELEASE
+} version_match_t;
+
+// Narrows a version query, e.g. {2, ANY, ANY, RELEASE} is "latest 2.x release"
+// and {3, 1, 0, PRERELEASE} is "latest prerelease of 3.1.0"
+typedef struct {
+    int major;
+    int minor;
+    int patch;
+    version_match_t match;
+} version_filter_t;
+
+// A version tag, parsed once when it is added to the list
+typedef struct {
+    char *tag;              // Tag name as stored in git, e.g. "v1.2.0"
+    const char *version;    // Tag name without the 'v' prefix, points into tag
+    semver_key_t key;
+    git_oid commit;         // Commit the tag points at, zero when not known
+} version_list_item_t;
+
+// Version tags ordered oldest to newest; non-version tags never get in
+typedef struct {
+    version_list_item_t *items;
+    size_t count;
+    size_t capacity;
+} version_list_t;
+
+int version_list_init(version_list_t *list);
+int version_list_add(version_list_t *list, const char *tag);
+int version_list_add_commit(version_list_t *list, const char *tag, const git_oid *commit);
+int version_list_load(version_list_t *list, git_repository *repo);
+void version_list_sort(version_list_t *list);
+const version_list_item_t *version_list_latest(const version_list_t *list);
+int version_list_detach(version_list_t *list, char ***tags, size_t *count);
+void version_list_cleanup(version_list_t *list);
+
+int version_filter_matches(const version_filter_t *filter, const semver_view_t *view);
+int version_list_select_latest(git_repository *repo, const version_filter_t *filter,
+                               char *version, size_t size);
+
+const char *version_list_error_string(int error_code);
+
+#endif // RELEASY_VERSION_LIST_H
@@ -0,0 +1,50 @@
+#ifndef RELEASY_WORKTREE_STATUS_H
+#define RELEASY_WORKTREE_STATUS_H
+
+#include <git2.h>
+#include "releasy.h"
+
+// Error codes
+#define WORKTREE_ERR_BARE -1000
+#define WORKTREE_ERR_GIT_OPERATION -1001
+#define WORKTREE_ERR_FILE_ACCESS -1002
+#define WORKTREE_ERR_MEMORY -1003
+
+#define WORKTREE_MAX_WORKERS 16
+#define WORKTREE_PARALLEL_MIN_ENTRIES 4096
+
+#define WORKTREE_SCAN_OPTIONS_INIT { 0, WORKTREE_PARALLEL_MIN_ENTRIES }
+
+typedef struct {
+    int workers;                    // 0 means one per online CPU, up to WORKTREE_MAX_WORKERS
+    size_t parallel_min_entries;    // Smaller indexes are checked on the calling thread
+} worktree_scan_options_t;
+
+// One dirty path, the same way git status would list it
+typedef struct {
+    char *path;                 // Untracked directories end in '/'
+    unsigned int status;        // GIT_STATUS_* flags
+} worktree_change_t;
+
+// Sorted by path
+typedef struct {
+    worktree_change_t *changes;
+    size_t count;
+    size_t capacity;
+} worktree_report_t;
+
+// Answers "is there anything to commit?" and stops at the first staged,
+// modified, conflicted or untracked path. Ignored files never count.
+int worktree_status_is_dirty(git_repository *repo, int *dirty);
+
+// Like worktree_status_is_dirty(), with large worktrees verified on a pool
+// of threads. With a report every dirty path is collected instead of
+// stopping at the first. opts and report may be NULL.
+int worktree_status_scan(git_repository *repo, const worktree_scan_options_t *opts,
+                         int *dirty, worktree_report_t *report);
+
+void worktree_report_cleanup(worktree_report_t *report);
+
+const char *worktree_status_error_string(int error_code);
+
+#endif // RELEASY_WORKTREE_STATUS_H
@@ -0,0 +1,87 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include "arena.h"
+
+#define ARENA_ALIGN alignof(max_align_t)
+
+struct arena_chunk {
+    arena_chunk_t *next;
+    size_t size;
+    alignas(max_align_t) unsigned char data[];
+};
+
+void arena_init(arena_t *arena) {
+    if (!arena) return;
+    memset(arena, 0, sizeof(arena_t));
+}
+
+static arena_chunk_t *arena_grow(arena_t *arena, size_t size) {
+    size_t chunk_size = arena->next_size ? arena->next_size : ARENA_FIRST_CHUNK;
+    if (chunk_size < size) chunk_size = size;
+
+    arena_chunk_t *chunk = malloc(sizeof(arena_chunk_t) + chunk_size);
+    if (!chunk) return NULL;
+
+    chunk->size = chunk_size;
+    chunk->next = arena->head;
+    arena->head = chunk;
+    arena->used = 0;
+
+    if (arena->next_size < ARENA_MAX_CHUNK) {
+        arena->next_size = arena->next_size ? arena->next_size * 2 : ARENA_FIRST_CHUNK * 2;
+    }
+    return chunk;
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    if (!arena) return NULL;
+
+    size_t rounded = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    if (rounded < size) return NULL;
+
+    if (!arena->head || arena->head->size - arena->used < rounded) {
+        if (!arena_grow(arena, rounded)) return NULL;
+    }
+
+    void *ptr = arena->head->data + arena->used;
+    arena->used += rounded;
+    return ptr;
+}
+
+char *arena_strndup(arena_t *arena, const char *str, size_t len) {
+    if (!str) return NULL;
+
+    char *copy = arena_alloc(arena, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+char *arena_strdup(arena_t *arena, const char *str) {
+    if (!str) return NULL;
+    return arena_strndup(arena, str, strlen(str));
+}
+
+void arena_reset(arena_t *arena) {
+    if (!arena || !arena->head) return;
+
+    arena_chunk_t *chunk = arena->head->next;
+    while (chunk) {
+        arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->head->next = NULL;
+    arena->used = 0;
+}
+
+void arena_cleanup(arena_t *arena) {
+    if (!arena) return;
+
+    arena_reset(arena);
+    free(arena->head);
+    memset(arena, 0, sizeof(arena_t));
+}
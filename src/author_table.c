@@ -0,0 +1,141 @@
+#include <stdlib.h>
+#include <string.h>
+#include "author_table.h"
+#include "hash.h"
+
+/*
+ * A signature as git_signature holds it, name and email apart. It hashes
+ * and compares equal to "name <email>" without that string being built;
+ * with no email, name is the whole signature.
+ */
+typedef struct {
+    const char *name;
+    size_t name_length;
+    const char *email;
+    size_t email_length;
+    size_t length;
+} signature_key_t;
+
+static uint64_t hash_key(const signature_key_t *key) {
+    uint64_t hash = hash_fnv1a(HASH_FNV1A_INIT, key->name, key->name_length);
+    if (!key->email) return hash;
+    hash = hash_fnv1a(hash, " <", 2);
+    hash = hash_fnv1a(hash, key->email, key->email_length);
+    return hash_fnv1a(hash, ">", 1);
+}
+
+static int key_matches(const author_t *author, const signature_key_t *key) {
+    const char *s = author->signature;
+    if (author->length != key->length || memcmp(s, key->name, key->name_length) != 0) return 0;
+    if (!key->email) return 1;
+    s += key->name_length;
+    return s[0] == ' ' && s[1] == '<' && memcmp(s + 2, key->email, key->email_length) == 0 &&
+           s[2 + key->email_length] == '>';
+}
+
+void author_table_init(author_table_t *table) {
+    memset(table, 0, sizeof(author_table_t));
+    arena_init(&table->arena);
+}
+
+static size_t find_slot(const author_table_t *table, uint64_t hash, const signature_key_t *key) {
+    size_t mask = table->capacity - 1;
+    size_t i = (size_t)hash & mask;
+    while (table->slots[i] != AUTHOR_NONE) {
+        const author_t *author = &table->authors[table->slots[i] - 1];
+        if (author->hash == hash && key_matches(author, key)) break;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Doubles the slots at half load, placing ids by their stored hash
+static int grow_slots(author_table_t *table) {
+    size_t capacity = table->capacity ? table->capacity * 2 : AUTHOR_TABLE_FIRST_SLOTS;
+    uint32_t *slots = calloc(capacity, sizeof(uint32_t));
+    if (!slots) return -1;
+
+    size_t mask = capacity - 1;
+    for (uint32_t id = 1; id <= table->count; id++) {
+        size_t i = (size_t)table->authors[id - 1].hash & mask;
+        while (slots[i] != AUTHOR_NONE) i = (i + 1) & mask;
+        slots[i] = id;
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->capacity = capacity;
+    return 0;
+}
+
+// Only a new author has its signature written out, once, into the arena
+static uint32_t intern_key(author_table_t *table, const signature_key_t *key) {
+    if (((size_t)table->count + 1) * 2 > table->capacity && grow_slots(table) != 0) return AUTHOR_NONE;
+
+    uint64_t hash = hash_key(key);
+    size_t slot = find_slot(table, hash, key);
+    if (table->slots[slot] != AUTHOR_NONE) return table->slots[slot];
+    if (table->count == UINT32_MAX - 1) return AUTHOR_NONE;
+
+    if (table->count == table->authors_capacity) {
+        size_t capacity = table->authors_capacity ? table->authors_capacity * 2 : AUTHOR_TABLE_FIRST_SLOTS / 2;
+        author_t *authors = realloc(table->authors, capacity * sizeof(author_t));
+        if (!authors) return AUTHOR_NONE;
+        table->authors = authors;
+        table->authors_capacity = capacity;
+    }
+
+    char *copy = arena_alloc(&table->arena, key->length + 1);
+    if (!copy) return AUTHOR_NONE;
+    memcpy(copy, key->name, key->name_length);
+    if (key->email) {
+        char *p = copy + key->name_length;
+        *p++ = ' ';
+        *p++ = '<';
+        memcpy(p, key->email, key->email_length);
+        p[key->email_length] = '>';
+    }
+    copy[key->length] = '\0';
+    table->string_bytes += key->length + 1;
+
+    author_t *author = &table->authors[table->count++];
+    author->signature = copy;
+    author->length = key->length;
+    author->hash = hash;
+    table->slots[slot] = table->count;
+    return table->count;
+}
+
+uint32_t author_table_intern(author_table_t *table, const char *signature, size_t length) {
+    if (!table || !signature) return AUTHOR_NONE;
+
+    signature_key_t key = { signature, length, NULL, 0, length };
+    return intern_key(table, &key);
+}
+
+uint32_t author_table_intern_parts(author_table_t *table, const char *name, const char *email) {
+    if (!table || !name || !email) return AUTHOR_NONE;
+
+    size_t name_length = strlen(name), email_length = strlen(email);
+    signature_key_t key = { name, name_length, email, email_length, name_length + email_length + 3 };
+    return intern_key(table, &key);
+}
+
+const author_t *author_table_get(const author_table_t *table, uint32_t id) {
+    if (!table || id == AUTHOR_NONE || id > table->count) return NULL;
+    return &table->authors[id - 1];
+}
+
+size_t author_table_memory(const author_table_t *table) {
+    if (!table) return 0;
+    return table->capacity * sizeof(uint32_t) + table->authors_capacity * sizeof(author_t) +
+           table->string_bytes;
+}
+
+void author_table_cleanup(author_table_t *table) {
+    if (!table) return;
+
+    free(table->slots);
+    free(table->authors);
+    arena_cleanup(&table->arena);
+    memset(table, 0, sizeof(author_table_t));
+}
@@ -1,14 +1,37 @@
 #define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <time.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "arena.h"
 #include "changelog.h"
+#include "changelog_backup.h"
+#include "changelog_render.h"
+#include "commit_cache.h"
+#include "commit_graph.h"
+#include "date_cache.h"
 #include "git_ops.h"
+#include "patch_id.h"
 #include "semver.h"
+#include "version_list.h"
 
-static int tag_sorting_callback(const void *a, const void *b);
+// Commits a worker claims from a batch at a time
+#define CHANGELOG_WALK_SLICE 32
+
+// Commits per thread whose subtree at the walk's path is remembered
+#define CHANGELOG_SUBTREE_SLOTS 4096
+
+// Without a commit-graph, how far back to look for the previous release tag
+#define CHANGELOG_DESCRIBE_MAX_COMMITS 100000
 
 static const char *commit_type_strings[] = {
     "feat", "fix", "docs", "style", "refactor",
@@ -16,45 +39,6 @@ static const char *commit_type_strings[] = {
     "revert", "unknown"
 };
 
-static int tag_sorting_callback(const void *a, const void *b) {
-    const char *tag_a = *(const char **)a;
-    const char *tag_b = *(const char **)b;
-    
-    // Skip 'v' prefix if present
-    if (tag_a[0] == 'v') tag_a++;
-    if (tag_b[0] == 'v') tag_b++;
-    
-    semver_t ver_a, ver_b;
-    semver_init(&ver_a);
-    semver_init(&ver_b);
-    
-    if (semver_parse(tag_a, &ver_a) != 0 || semver_parse(tag_b, &ver_b) != 0) {
-        semver_free(&ver_a);
-        semver_free(&ver_b);
-        return 0;
-    }
-    
-    int result = semver_compare(&ver_a, &ver_b);
-    semver_free(&ver_a);
-    semver_free(&ver_b);
-    return result;
-}
-
-static commit_type_t parse_commit_type(const char *type_str) {
-    if (!type_str) return COMMIT_TYPE_UNKNOWN;
-    
-    for (int i = 0; i < COMMIT_TYPE_UNKNOWN; i++) {
-        if (strcmp(type_str, commit_type_strings[i]) == 0) {
-            return (commit_type_t)i;
-        }
-    }
-    return COMMIT_TYPE_UNKNOWN;
-}
-
-#define CHANGELOG_ERR_INVALID_PATH -310
-#define CHANGELOG_ERR_INVALID_CONFIG -311
-#define CHANGELOG_ERR_INVALID_VERSION -312
-
 static int validate_file_path(const char *path) {
     if (!path || strlen(path) == 0) return CHANGELOG_ERR_INVALID_PATH;
     
@@ -95,6 +79,10 @@ static int validate_config(changelog_t *log) {
     if (log->group_by_type != 0 && log->group_by_type != 1) return CHANGELOG_ERR_INVALID_CONFIG;
     if (log->include_authors != 0 && log->include_authors != 1) return CHANGELOG_ERR_INVALID_CONFIG;
     if (log->backup != 0 && log->backup != 1) return CHANGELOG_ERR_INVALID_CONFIG;
+    if (log->backup_policy.max_age < 0) return CHANGELOG_ERR_INVALID_CONFIG;
+    if (log->group_by_scope != 0 && log->group_by_scope != 1) return CHANGELOG_ERR_INVALID_CONFIG;
+    if (log->include_contributors != 0 && log->include_contributors != 1) return CHANGELOG_ERR_INVALID_CONFIG;
+    if (!log->formats || (log->formats & ~CHANGELOG_FORMAT_ALL)) return CHANGELOG_ERR_INVALID_CONFIG;
     
     return RELEASY_SUCCESS;
 }
@@ -109,374 +97,1781 @@ int changelog_init(changelog_t *log, const char *file_path) {
     memset(log, 0, sizeof(changelog_t));
     log->file_path = strdup(file_path);
     if (!log->file_path) return CHANGELOG_ERR_MEMORY;
+    author_table_init(&log->authors);
     
     log->include_metadata = 1;
     log->group_by_type = 1;
     log->include_authors = 1;
+    log->formats = CHANGELOG_FORMAT_MARKDOWN;
+    
+    changelog_backup_policy_t backup_policy = CHANGELOG_BACKUP_POLICY_INIT;
+    log->backup_policy = backup_policy;
+    
+    changelog_walk_options_t walk = CHANGELOG_WALK_OPTIONS_INIT;
+    log->walk = walk;
     
     return validate_config(log);
 }
 
-static int parse_conventional_commit(const char *message, commit_info_t *commit) {
-    if (!message || !commit) return CHANGELOG_ERR_PARSE_FAILED;
-    
-    char *msg_copy = strdup(message);
-    if (!msg_copy) return RELEASY_ERROR;
-    
-    // Parse type and scope
-    char *type_end = strchr(msg_copy, ':');
-    if (!type_end) {
-        free(msg_copy);
-        return CHANGELOG_ERR_INVALID_FORMAT;
+/*
+ * Perfect hash over the conventional commit types: length plus the first
+ * two letters, lowercased, land every type in its own slot of a 16 entry
+ * table. Lookups hash once and confirm with a single compare.
+ */
+#define TYPE_HASH(len, c0, c1) (((len) + 3 * (unsigned)(c0) + (unsigned)(c1)) & 15)
+#define TYPE_SLOT(len, c0, c1, type) [TYPE_HASH(len, c0, c1)] = (type) + 1
+
+// Zero marks an empty slot, so slots hold the type plus one
+static const unsigned char commit_type_table[16] = {
+    TYPE_SLOT(4, 'f', 'e', COMMIT_TYPE_FEAT),
+    TYPE_SLOT(3, 'f', 'i', COMMIT_TYPE_FIX),
+    TYPE_SLOT(4, 'd', 'o', COMMIT_TYPE_DOCS),
+    TYPE_SLOT(5, 's', 't', COMMIT_TYPE_STYLE),
+    TYPE_SLOT(8, 'r', 'e', COMMIT_TYPE_REFACTOR),
+    TYPE_SLOT(4, 'p', 'e', COMMIT_TYPE_PERF),
+    TYPE_SLOT(4, 't', 'e', COMMIT_TYPE_TEST),
+    TYPE_SLOT(5, 'b', 'u', COMMIT_TYPE_BUILD),
+    TYPE_SLOT(2, 'c', 'i', COMMIT_TYPE_CI),
+    TYPE_SLOT(5, 'c', 'h', COMMIT_TYPE_CHORE),
+    TYPE_SLOT(6, 'r', 'e', COMMIT_TYPE_REVERT),
+};
+
+// Commit headers are ASCII; these skip the locale lookups of <ctype.h>
+static inline char ascii_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+static inline int is_ascii_alnum(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static inline int is_type_char(char c) {
+    return is_ascii_alnum(c) || c == '-' || c == '_';
+}
+
+static inline int is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+// Types are matched case-insensitively, as the spec asks
+static commit_type_t lookup_commit_type(const char *name, size_t len) {
+    if (len < 2) return COMMIT_TYPE_UNKNOWN;
+
+    unsigned slot = commit_type_table[TYPE_HASH(len, ascii_lower(name[0]), ascii_lower(name[1]))];
+    if (!slot) return COMMIT_TYPE_UNKNOWN;
+
+    commit_type_t type = (commit_type_t)(slot - 1);
+    const char *expected = commit_type_strings[type];
+    for (size_t i = 0; i < len; i++) {
+        // A NUL in expected ends the match before len
+        if (ascii_lower(name[i]) != expected[i]) return COMMIT_TYPE_UNKNOWN;
     }
-    
-    *type_end = '\0';
-    char *scope_start = strchr(msg_copy, '(');
-    char *scope_end = scope_start ? strchr(scope_start, ')') : NULL;
-    
-    if (scope_start && scope_end) {
-        *scope_end = '\0';
-        scope_start++;
-        commit->scope = strdup(scope_start);
-        *scope_start = '\0';
+    return expected[len] == '\0' ? type : COMMIT_TYPE_UNKNOWN;
+}
+
+static int is_blank_line(const char *line, const char *end) {
+    for (; line < end; line++) {
+        if (!is_space(*line)) return 0;
     }
-    
-    // Check for breaking change marker
-    commit->is_breaking = (strstr(msg_copy, "!") != NULL);
-    
-    // Parse type
-    char *type_str = msg_copy;
-    commit->type = parse_commit_type(type_str);
-    
-    // Parse description (skip leading whitespace)
-    const char *desc = type_end + 1;
-    while (*desc && isspace(*desc)) desc++;
-    commit->description = strdup(desc);
-    
-    free(msg_copy);
-    return commit->description ? RELEASY_SUCCESS : RELEASY_ERROR;
+    return 1;
 }
 
-int changelog_parse_commit(const char *message, commit_info_t *commit) {
-    if (!message || !commit) return CHANGELOG_ERR_PARSE_FAILED;
-    
-    memset(commit, 0, sizeof(commit_info_t));
-    return parse_conventional_commit(message, commit);
+static const char *line_end(const char *line, const char *end) {
+    const char *nl = memchr(line, '\n', (size_t)(end - line));
+    return nl ? nl : end;
 }
 
-static int write_commit_group(FILE *f, commit_type_t type, commit_info_t **commits, size_t count) {
-    if (!f || !commits) return RELEASY_ERROR;
-    
-    // Count commits of this type
-    size_t type_count = 0;
-    for (size_t i = 0; i < count; i++) {
-        if (commits[i]->type == type) type_count++;
+static changelog_span_t make_span(const char *start, const char *end) {
+    while (end > start && is_space(end[-1])) end--;
+    changelog_span_t span = { start, (size_t)(end - start) };
+    return span;
+}
+
+static int is_breaking_token(const char *line, const char *end) {
+    size_t len = (size_t)(end - line);
+    return (len >= 16 && strncmp(line, "BREAKING CHANGE:", 16) == 0) ||
+           (len >= 16 && strncmp(line, "BREAKING-CHANGE:", 16) == 0);
+}
+
+// "Token: value" or "Token #value", where BREAKING CHANGE is the one token
+// allowed to contain a space
+static int is_footer_line(const char *line, const char *end) {
+    if (is_breaking_token(line, end)) return 1;
+
+    const char *p = line;
+    while (p < end && (is_ascii_alnum(*p) || *p == '-')) p++;
+    if (p == line || end - p < 2) return 0;
+    return (p[0] == ':' && p[1] == ' ') || (p[0] == ' ' && p[1] == '#');
+}
+
+/*
+ * Everything after the header: the footer is the last paragraph when it
+ * opens with a footer token, the body is whatever comes before it.
+ */
+static void parse_body_and_footer(const char *start, const char *end, conventional_commit_t *out) {
+    while (start < end) {
+        const char *eol = line_end(start, end);
+        if (!is_blank_line(start, eol)) break;
+        start = eol < end ? eol + 1 : end;
     }
-    
-    if (type_count == 0) return RELEASY_SUCCESS;
-    
-    // Write section header
-    fprintf(f, "\n### %s\n\n", changelog_commit_type_string(type));
-    
-    // Write commits
-    for (size_t i = 0; i < count; i++) {
-        commit_info_t *commit = commits[i];
-        if (commit->type != type) continue;
-        
-        fprintf(f, "* ");
-        if (commit->scope) {
-            fprintf(f, "**%s:** ", commit->scope);
-        }
-        fprintf(f, "%s", commit->description);
-        if (commit->is_breaking) {
-            fprintf(f, " [BREAKING]");
+    if (start >= end) return;
+
+    // Find where the last paragraph starts and where the one before it ends
+    const char *last_para = start;
+    const char *body_end = start;
+    const char *content_end = start;
+    int after_blank = 0;
+    for (const char *line = start; line < end;) {
+        const char *eol = line_end(line, end);
+        if (is_blank_line(line, eol)) {
+            after_blank = 1;
+        } else {
+            if (after_blank) {
+                body_end = content_end;
+                last_para = line;
+                after_blank = 0;
+            }
+            content_end = eol;
         }
-        if (commit->author) {
-            fprintf(f, " (%s)", commit->author);
+        line = eol < end ? eol + 1 : end;
+    }
+
+    if (!is_footer_line(last_para, line_end(last_para, end))) {
+        out->body = make_span(start, content_end);
+        return;
+    }
+
+    out->footer = make_span(last_para, content_end);
+    if (last_para > start) out->body = make_span(start, body_end);
+
+    for (const char *line = last_para; line < content_end;) {
+        const char *eol = line_end(line, content_end);
+        if (is_breaking_token(line, eol)) out->is_breaking = 1;
+        line = eol < content_end ? eol + 1 : content_end;
+    }
+}
+
+int changelog_parse_message(const char *message, size_t len, conventional_commit_t *out) {
+    if (!message || !out) return CHANGELOG_ERR_PARSE_FAILED;
+    memset(out, 0, sizeof(conventional_commit_t));
+
+    const char *end = message + len;
+    const char *header_end = line_end(message, end);
+
+    // type(scope)!: description
+    const char *p = message;
+    while (p < header_end && is_type_char(*p)) p++;
+    if (p == message) return CHANGELOG_ERR_INVALID_FORMAT;
+    out->type_name.ptr = message;
+    out->type_name.len = (size_t)(p - message);
+
+    if (p < header_end && *p == '(') {
+        const char *close = memchr(p + 1, ')', (size_t)(header_end - p - 1));
+        if (!close) return CHANGELOG_ERR_INVALID_FORMAT;
+        if (close > p + 1) {
+            out->scope.ptr = p + 1;
+            out->scope.len = (size_t)(close - p - 1);
         }
-        fprintf(f, "\n");
+        p = close + 1;
     }
-    
+
+    if (p < header_end && *p == '!') {
+        out->is_breaking = 1;
+        p++;
+    }
+
+    if (p >= header_end || *p != ':') return CHANGELOG_ERR_INVALID_FORMAT;
+    p++;
+    while (p < header_end && (*p == ' ' || *p == '\t')) p++;
+
+    out->description = make_span(p, header_end);
+    if (!out->description.len) return RELEASY_ERROR;
+
+    out->type = lookup_commit_type(out->type_name.ptr, out->type_name.len);
+    if (header_end < end) parse_body_and_footer(header_end + 1, end, out);
     return RELEASY_SUCCESS;
 }
 
-#define CHANGELOG_BACKUP_SUFFIX ".bak"
+// Copies a span out of the message, into arena when one is given
+static char *span_dup(arena_t *arena, changelog_span_t span) {
+    if (!span.ptr) return NULL;
+    return arena ? arena_strndup(arena, span.ptr, span.len) : strndup(span.ptr, span.len);
+}
 
-static int create_backup_file(const char *original_path) {
-    if (!original_path) return CHANGELOG_ERR_FILE_ACCESS;
-    
-    // Generate backup filename with timestamp
-    time_t now = time(NULL);
-    struct tm *tm = localtime(&now);
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", tm);
-    
-    size_t backup_path_len = strlen(original_path) + strlen(CHANGELOG_BACKUP_SUFFIX) + strlen(timestamp) + 2;
-    char *backup_path = malloc(backup_path_len);
-    if (!backup_path) return CHANGELOG_ERR_MEMORY;
-    
-    snprintf(backup_path, backup_path_len, "%s.%s%s", 
-             original_path, timestamp, CHANGELOG_BACKUP_SUFFIX);
-    
-    // Open original file
-    FILE *src = fopen(original_path, "r");
-    if (!src) {
-        free(backup_path);
-        return CHANGELOG_ERR_FILE_ACCESS;
+static int commit_from_message(const char *message, commit_info_t *commit, arena_t *arena) {
+    conventional_commit_t parsed;
+    int ret = changelog_parse_message(message, strlen(message), &parsed);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    commit->type = parsed.type;
+    commit->is_breaking = parsed.is_breaking;
+    commit->scope = span_dup(arena, parsed.scope);
+    commit->description = span_dup(arena, parsed.description);
+    commit->body = span_dup(arena, parsed.body);
+    commit->footer = span_dup(arena, parsed.footer);
+
+    if (!commit->description ||
+        (parsed.scope.ptr && !commit->scope) ||
+        (parsed.body.ptr && !commit->body) ||
+        (parsed.footer.ptr && !commit->footer)) {
+        return CHANGELOG_ERR_MEMORY;
     }
+    return RELEASY_SUCCESS;
+}
+
+int changelog_parse_commit(const char *message, commit_info_t *commit) {
+    if (!message || !commit) return CHANGELOG_ERR_PARSE_FAILED;
     
-    // Create backup file
-    FILE *dst = fopen(backup_path, "w");
-    if (!dst) {
-        fclose(src);
-        free(backup_path);
+    memset(commit, 0, sizeof(commit_info_t));
+    int ret = commit_from_message(message, commit, NULL);
+    if (ret != RELEASY_SUCCESS) changelog_free_commit(commit);
+    return ret;
+}
+
+/*
+ * Incremental writer. The existing changelog is streamed once into a temp
+ * file next to it: its title and preamble first, then the new sections,
+ * then the older history, leaving out any old section for a version being
+ * written again. The temp file is synced and renamed over the original, so
+ * readers see either the old changelog or the new one.
+ */
+typedef struct {
+    const char *path;
+    char *tmp_path;
+    int fd;
+    changelog_markdown_t *out;
+    FILE *src;          // Existing changelog, NULL when there is none
+    char *line;         // First "## " heading of the old history, once read
+    size_t line_cap;
+    ssize_t line_len;
+} changelog_splice_t;
+
+static int is_section_heading(const char *line) {
+    return strncmp(line, "## ", 3) == 0;
+}
+
+static int is_title(const char *line) {
+    return line[0] == '#' && line[1] == ' ';
+}
+
+static void write_title(changelog_markdown_t *out) {
+    static const char title[] = "# Changelog\n\n";
+    changelog_markdown_text(out, title, sizeof(title) - 1);
+}
+
+static void splice_abort(changelog_splice_t *splice) {
+    changelog_markdown_close(splice->out);
+    if (splice->fd >= 0) close(splice->fd);
+    if (splice->src) fclose(splice->src);
+    if (splice->tmp_path) {
+        unlink(splice->tmp_path);
+        free(splice->tmp_path);
+    }
+    free(splice->line);
+    memset(splice, 0, sizeof(changelog_splice_t));
+    splice->fd = -1;
+}
+
+// Opens the temp file and copies everything before the first section
+static int splice_begin(const changelog_t *log, changelog_splice_t *splice) {
+    memset(splice, 0, sizeof(changelog_splice_t));
+    splice->path = log->file_path;
+    splice->fd = -1;
+    splice->line_len = -1;
+
+    splice->src = fopen(log->file_path, "r");
+    if (splice->src && log->backup) {
+        int ret = changelog_backup(log->file_path, &log->backup_policy, NULL);
+        if (ret != RELEASY_SUCCESS) {
+            splice_abort(splice);
+            return ret;
+        }
+    }
+
+    size_t len = strlen(log->file_path) + sizeof(".XXXXXX");
+    splice->tmp_path = malloc(len);
+    if (!splice->tmp_path) {
+        splice_abort(splice);
+        return CHANGELOG_ERR_MEMORY;
+    }
+    snprintf(splice->tmp_path, len, "%s.XXXXXX", log->file_path);
+
+    splice->fd = mkstemp(splice->tmp_path);
+    if (splice->fd < 0) {
+        free(splice->tmp_path);
+        splice->tmp_path = NULL;
+        splice_abort(splice);
         return CHANGELOG_ERR_FILE_ACCESS;
     }
-    
-    // Copy contents
-    char buffer[4096];
-    size_t bytes;
-    while ((bytes = fread(buffer, 1, sizeof(buffer), src)) > 0) {
-        if (fwrite(buffer, 1, bytes, dst) != bytes) {
-            fclose(src);
-            fclose(dst);
-            free(backup_path);
-            return CHANGELOG_ERR_FILE_ACCESS;
+
+    // mkstemp() creates 0600; keep the old file's mode, or the usual one
+    struct stat st;
+    mode_t mode;
+    if (splice->src && fstat(fileno(splice->src), &st) == 0) {
+        mode = st.st_mode & 07777;
+    } else {
+        mode_t mask = umask(0);
+        umask(mask);
+        mode = 0666 & ~mask;
+    }
+    fchmod(splice->fd, mode);
+
+    // Everything reaches the temp file through this one writer
+    splice->out = changelog_markdown_open(splice->fd, log->group_by_type, log->include_authors);
+    if (!splice->out) {
+        splice_abort(splice);
+        return CHANGELOG_ERR_MEMORY;
+    }
+
+    int titled = 0;
+    while (splice->src &&
+           (splice->line_len = getline(&splice->line, &splice->line_cap, splice->src)) >= 0) {
+        if (is_section_heading(splice->line)) break;
+        // Files without a title of their own get ours
+        if (!titled && !is_blank_line(splice->line, splice->line + splice->line_len)) {
+            if (!is_title(splice->line)) write_title(splice->out);
+            titled = 1;
         }
+        changelog_markdown_text(splice->out, splice->line, (size_t)splice->line_len);
     }
-    
-    fclose(src);
-    fclose(dst);
-    free(backup_path);
+    if (!titled) write_title(splice->out);
+
     return RELEASY_SUCCESS;
 }
 
-int changelog_write(changelog_t *log) {
-    if (!log || !log->entries || !log->count) return CHANGELOG_ERR_NO_COMMITS;
-    
-    // Create backup if enabled and file exists
-    if (log->backup) {
-        FILE *test = fopen(log->file_path, "r");
-        if (test) {
-            fclose(test);
-            int ret = create_backup_file(log->file_path);
-            if (ret != RELEASY_SUCCESS) return ret;
+static int is_replaced_section(const char *heading, const char **versions, size_t count) {
+    if (strncmp(heading, "## [", 4) != 0) return 0;
+
+    const char *version = heading + 4;
+    const char *close = strchr(version, ']');
+    if (!close) return 0;
+
+    size_t len = (size_t)(close - version);
+    for (size_t i = 0; i < count; i++) {
+        if (strlen(versions[i]) == len && strncmp(version, versions[i], len) == 0) return 1;
+    }
+    return 0;
+}
+
+// Copies the older history after the new sections and swaps the file in
+static int splice_finish(changelog_splice_t *splice, const char **versions, size_t count) {
+    int skipping = 0;
+    while (splice->src && splice->line_len >= 0) {
+        if (is_section_heading(splice->line)) {
+            skipping = is_replaced_section(splice->line, versions, count);
         }
+        if (!skipping) changelog_markdown_text(splice->out, splice->line, (size_t)splice->line_len);
+        splice->line_len = getline(&splice->line, &splice->line_cap, splice->src);
     }
+
+    int failed = splice->src && ferror(splice->src);
+    if (changelog_markdown_close(splice->out) != RELEASY_SUCCESS) failed = 1;
+    splice->out = NULL;
+    if (!failed && fsync(splice->fd) != 0) failed = 1;
+    if (close(splice->fd) != 0) failed = 1;
+    splice->fd = -1;
+
+    if (!failed && rename(splice->tmp_path, splice->path) != 0) failed = 1;
+    if (!failed) {
+        free(splice->tmp_path);
+        splice->tmp_path = NULL;
+    }
+
+    splice_abort(splice);
+    return failed ? CHANGELOG_ERR_FILE_ACCESS : RELEASY_SUCCESS;
+}
+
+// Renders the model's sections into the splice's temp file, after what
+// has been written so far
+static int splice_render(changelog_splice_t *splice, const changelog_model_t *model) {
+    changelog_markdown_sections(splice->out, model);
+    return changelog_markdown_flush(splice->out);
+}
+
+// CHANGELOG.md becomes CHANGELOG.json and so on
+static char *format_path(const char *file_path, changelog_format_t format) {
+    const char *ext = strrchr(file_path, '.');
+    const char *replacement = changelog_format_extension(format);
+    size_t stem = ext ? (size_t)(ext - file_path) : strlen(file_path);
+    char *path = malloc(stem + strlen(replacement) + 1);
+    if (!path) return NULL;
+    memcpy(path, file_path, stem);
+    strcpy(path + stem, replacement);
+    return path;
+}
+
+// The whole document in a temp file, renamed over the old one
+static int write_format_file(const changelog_t *log, const changelog_model_t *model, changelog_format_t format) {
+    char *path = format_path(log->file_path, format);
+    size_t len = path ? strlen(path) + sizeof(".XXXXXX") : 0;
+    char *tmp_path = path ? malloc(len) : NULL;
+    if (!tmp_path) {
+        free(path);
+        return CHANGELOG_ERR_MEMORY;
+    }
+    snprintf(tmp_path, len, "%s.XXXXXX", path);
+
+    int ret = RELEASY_SUCCESS;
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) ret = CHANGELOG_ERR_FILE_ACCESS;
+
+    if (ret == RELEASY_SUCCESS) {
+        mode_t mask = umask(0);
+        umask(mask);
+        fchmod(fd, 0666 & ~mask);
+
+        ret = changelog_model_render(model, format, fd);
+        if (ret == RELEASY_SUCCESS && fsync(fd) != 0) ret = CHANGELOG_ERR_FILE_ACCESS;
+        if (close(fd) != 0 && ret == RELEASY_SUCCESS) ret = CHANGELOG_ERR_FILE_ACCESS;
+        if (ret == RELEASY_SUCCESS && rename(tmp_path, path) != 0) ret = CHANGELOG_ERR_FILE_ACCESS;
+        if (ret != RELEASY_SUCCESS) unlink(tmp_path);
+    }
+
+    free(tmp_path);
+    free(path);
+    return ret;
+}
+
+/*
+ * The entries are bucketed once, in one counting pass each, and every
+ * format is rendered from those buckets.
+ */
+int changelog_write(changelog_t *log) {
+    if (!log || !log->entries || !log->count) return CHANGELOG_ERR_NO_COMMITS;
     
-    FILE *f = fopen(log->file_path, "w");
-    if (!f) return CHANGELOG_ERR_FILE_ACCESS;
-    
-    fprintf(f, "# Changelog\n\n");
-    
+    const char **versions = malloc(log->count * sizeof(char *));
+    if (!versions) return CHANGELOG_ERR_MEMORY;
     for (size_t i = 0; i < log->count; i++) {
-        changelog_entry_t *entry = log->entries[i];
-        
-        // Write version header
-        fprintf(f, "## [%s]", entry->version);
-        if (entry->date) {
-            fprintf(f, " - %s", entry->date);
-        }
-        fprintf(f, "\n");
-        
-        if (log->group_by_type) {
-            // Write commits grouped by type
-            for (int type = 0; type < COMMIT_TYPE_UNKNOWN; type++) {
-                write_commit_group(f, type, entry->commits, entry->count);
-            }
-        } else {
-            // Write commits in chronological order
-            for (size_t j = 0; j < entry->count; j++) {
-                commit_info_t *commit = entry->commits[j];
-                fprintf(f, "* %s: %s", 
-                        changelog_commit_type_string(commit->type),
-                        commit->description);
-                if (commit->is_breaking) {
-                    fprintf(f, " [BREAKING]");
-                }
-                if (log->include_authors && commit->author) {
-                    fprintf(f, " (%s)", commit->author);
-                }
-                fprintf(f, "\n");
-            }
+        versions[i] = log->entries[i]->version;
+    }
+
+    changelog_model_t model;
+    int ret = changelog_model_build(&model, log, log->entries, log->count);
+    if (ret != RELEASY_SUCCESS) {
+        free(versions);
+        return ret;
+    }
+
+    changelog_splice_t splice;
+    if (log->formats & CHANGELOG_FORMAT_MARKDOWN) {
+        ret = splice_begin(log, &splice);
+        if (ret == RELEASY_SUCCESS) ret = splice_render(&splice, &model);
+        if (ret == RELEASY_SUCCESS) {
+            ret = splice_finish(&splice, versions, log->count);
+        } else if (splice.out) {
+            splice_abort(&splice);
         }
-        
-        fprintf(f, "\n");
     }
-    
-    fclose(f);
+    if (ret == RELEASY_SUCCESS && (log->formats & CHANGELOG_FORMAT_JSON)) {
+        ret = write_format_file(log, &model, CHANGELOG_FORMAT_JSON);
+    }
+    if (ret == RELEASY_SUCCESS && (log->formats & CHANGELOG_FORMAT_HTML)) {
+        ret = write_format_file(log, &model, CHANGELOG_FORMAT_HTML);
+    }
+
+    changelog_model_free(&model);
+    free(versions);
+    return ret;
+}
+
+static int resolve_commit(git_oid *oid, git_repository *repo, const char *spec) {
+    git_object *obj = NULL, *commit = NULL;
+    if (git_revparse_single(&obj, repo, spec) != 0) return CHANGELOG_ERR_TAG_NOT_FOUND;
+
+    int error = git_object_peel(&commit, obj, GIT_OBJECT_COMMIT);
+    git_object_free(obj);
+    if (error) return CHANGELOG_ERR_INVALID_RANGE;
+
+    *oid = *git_object_id(commit);
+    git_object_free(commit);
     return RELEASY_SUCCESS;
 }
 
-static int get_commit_range(git_repository *repo, const char *from_tag, const char *to_tag,
-                          git_revwalk **walker) {
-    int error;
-    git_oid from_oid, to_oid;
+// The commits of a range in walk order: from the commit-graph when it
+// can answer, from a revwalk otherwise. With repo set, each merge on the
+// chain is followed by the commits it brought in.
+typedef struct commit_source commit_source_t;
 
-    // Get the "to" commit (newer)
-    if (to_tag) {
-        error = git_revparse_single((git_object **)&to_oid, repo, to_tag);
-        if (error) return error;
-    } else {
-        error = git_reference_name_to_id(&to_oid, repo, "HEAD");
-        if (error) return error;
+struct commit_source {
+    git_revwalk *walker;
+    git_oid *oids;
+    size_t count;
+    size_t next;
+    git_repository *repo;
+    const commit_graph_t *graph;
+    commit_source_t *branch;    // The last merge's commits, drained first
+};
+
+static void source_free(commit_source_t *source) {
+    if (source->branch) {
+        source_free(source->branch);
+        free(source->branch);
+    }
+    if (source->walker) git_revwalk_free(source->walker);
+    free(source->oids);
+    memset(source, 0, sizeof(commit_source_t));
+}
+
+// Without the graph (NULL when the repository has none) libgit2 has to
+// inflate every commit in the range, and the hidden side down to the merge
+// base, before yielding the first
+static int open_range(git_repository *repo, const commit_graph_t *graph, const git_oid *to,
+                      const git_oid *hide, int first_parent, commit_source_t *source) {
+    if (graph) {
+        int ret = first_parent
+            ? commit_graph_first_parent_range(graph, repo, to, hide, &source->oids, &source->count)
+            : commit_graph_range(graph, repo, to, hide, &source->oids, &source->count);
+        if (ret == RELEASY_SUCCESS) return RELEASY_SUCCESS;
     }
 
     // Initialize the revision walker
-    error = git_revwalk_new(walker, repo);
-    if (error) return error;
+    if (git_revwalk_new(&source->walker, repo) != 0) return CHANGELOG_ERR_GIT_WALK_FAILED;
 
-    git_revwalk_sorting(*walker, GIT_SORT_TIME);
-    error = git_revwalk_push(*walker, &to_oid);
-    if (error) {
-        git_revwalk_free(*walker);
-        return error;
+    // A first-parent chain is in topological order as it stands; sorting it
+    // would only make libgit2 read the whole range before the first commit
+    if (first_parent) {
+        git_revwalk_sorting(source->walker, GIT_SORT_NONE);
+        git_revwalk_simplify_first_parent(source->walker);
+    } else {
+        // Time alone leaves commits made in the same second in any order
+        git_revwalk_sorting(source->walker, GIT_SORT_TOPOLOGICAL | GIT_SORT_TIME);
+    }
+    if (git_revwalk_push(source->walker, to) != 0 ||
+        (hide && git_revwalk_hide(source->walker, hide) != 0)) {
+        source_free(source);
+        return CHANGELOG_ERR_GIT_WALK_FAILED;
     }
 
-    // If we have a from tag, stop at that commit
-    if (from_tag) {
-        error = git_revparse_single((git_object **)&from_oid, repo, from_tag);
-        if (error) {
-            git_revwalk_free(*walker);
-            return error;
+    return RELEASY_SUCCESS;
+}
+
+// Queues what a merge brought in, parents[0]..parents[1..n], to come out
+// right after it. Only merges the walk reaches are expanded, so nothing on
+// a branch is read before its merge is.
+static int source_expand(commit_source_t *source, const git_oid *merge) {
+    uint32_t pos = source->graph ? commit_graph_find(source->graph, merge) : COMMIT_GRAPH_NONE;
+    uint32_t parents[2];
+    if (pos != COMMIT_GRAPH_NONE && commit_graph_parents(source->graph, pos, parents, 2) < 2) return 0;
+
+    git_commit *commit = NULL;
+    if (git_commit_lookup(&commit, source->repo, merge) != 0) return 0;  // Reported when parsed
+    unsigned int count = git_commit_parentcount(commit);
+    if (count < 2) {
+        git_commit_free(commit);
+        return 0;
+    }
+
+    commit_source_t *branch = calloc(1, sizeof(commit_source_t));
+    int ret = branch ? RELEASY_SUCCESS : CHANGELOG_ERR_MEMORY;
+    if (ret == RELEASY_SUCCESS && count == 2) {
+        ret = open_range(source->repo, source->graph, git_commit_parent_id(commit, 1),
+                         git_commit_parent_id(commit, 0), 0, branch);
+    } else if (ret == RELEASY_SUCCESS) {
+        // Octopus: the graph ranges take a single tip
+        if (git_revwalk_new(&branch->walker, source->repo) != 0) ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+        if (ret == RELEASY_SUCCESS) git_revwalk_sorting(branch->walker, GIT_SORT_TIME);
+        for (unsigned int i = 1; ret == RELEASY_SUCCESS && i < count; i++) {
+            if (git_revwalk_push(branch->walker, git_commit_parent_id(commit, i)) != 0) {
+                ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+            }
         }
-        error = git_revwalk_hide(*walker, &from_oid);
-        if (error) {
-            git_revwalk_free(*walker);
-            return error;
+        if (ret == RELEASY_SUCCESS && git_revwalk_hide(branch->walker, git_commit_parent_id(commit, 0)) != 0) {
+            ret = CHANGELOG_ERR_GIT_WALK_FAILED;
         }
     }
+    git_commit_free(commit);
 
-    return RELEASY_SUCCESS;
+    if (ret != RELEASY_SUCCESS) {
+        if (branch) source_free(branch);
+        free(branch);
+        return -1;
+    }
+    source->branch = branch;
+    return 0;
 }
 
-static int extract_commit_metadata(git_commit *commit, commit_info_t *info) {
-    if (!commit || !info) return RELEASY_ERROR;
+static int source_next(commit_source_t *source, git_oid *oid) {
+    if (source->branch) {
+        int error = source_next(source->branch, oid);
+        if (error != GIT_ITEROVER) return error;
+        source_free(source->branch);
+        free(source->branch);
+        source->branch = NULL;
+    }
 
-    // Get commit hash
-    const git_oid *oid = git_commit_id(commit);
+    int error = 0;
+    if (source->walker) {
+        error = git_revwalk_next(oid, source->walker);
+    } else if (source->next == source->count) {
+        error = GIT_ITEROVER;
+    } else {
+        *oid = source->oids[source->next++];
+    }
+    if (error == 0 && source->repo) error = source_expand(source, oid);
+    return error;
+}
+
+static int get_commit_range(git_repository *repo, const commit_graph_t *graph,
+                            const char *from_tag, const char *to_tag,
+                            const changelog_walk_options_t *opts, commit_source_t *source) {
+    git_oid from_oid, to_oid;
+    memset(source, 0, sizeof(commit_source_t));
+
+    // Get the "to" commit (newer)
+    int error = resolve_commit(&to_oid, repo, to_tag ? to_tag : "HEAD");
+    if (error) return error;
+
+    // If we have a from tag, stop at that commit
+    if (from_tag) {
+        error = resolve_commit(&from_oid, repo, from_tag);
+        if (error) return error;
+    }
+
+    error = open_range(repo, graph, &to_oid, from_tag ? &from_oid : NULL, opts->first_parent, source);
+    if (error == RELEASY_SUCCESS && opts->first_parent && opts->expand_merges) {
+        source->repo = repo;
+        source->graph = graph;
+    }
+    return error;
+}
+
+static char *format_hash(const git_oid *oid, arena_t *arena) {
     char hash[GIT_OID_HEXSZ + 1] = {0};
     git_oid_fmt(hash, oid);
-    info->commit_hash = strdup(hash);
+    return arena_strdup(arena, hash);
+}
+
+/*
+ * The author table a walk interns into. Workers intern as they parse, so
+ * every intern is made under the lock, and the signature is read back
+ * under it as well since a grow moves the authors array. The strings
+ * themselves stay put in the table's arena.
+ */
+typedef struct {
+    author_table_t *table;
+    pthread_mutex_t lock;
+} walk_authors_t;
+
+// From the signature's parts, or with no email from a whole cached signature.
+// Out of memory the commit simply goes without an author.
+static void intern_author(walk_authors_t *authors, commit_info_t *info, const char *name, const char *email) {
+    pthread_mutex_lock(&authors->lock);
+    info->author_id = email ? author_table_intern_parts(authors->table, name, email)
+                            : author_table_intern(authors->table, name, strlen(name));
+    const author_t *author = author_table_get(authors->table, info->author_id);
+    info->author = author ? (char *)author->signature : NULL;
+    pthread_mutex_unlock(&authors->lock);
+}
+
+static int extract_commit_metadata(git_commit *commit, commit_info_t *info, arena_t *arena,
+                                   walk_authors_t *authors) {
+    if (!commit || !info || !arena || !authors) return RELEASY_ERROR;
+
+    // Get commit hash
+    info->commit_hash = format_hash(git_commit_id(commit), arena);
 
-    // Get author information
+    // Each commit keeps only the id of its author and the table's string
     const git_signature *author = git_commit_author(commit);
     if (author) {
-        size_t author_len = strlen(author->name) + strlen(author->email) + 4;
-        info->author = malloc(author_len);
-        if (info->author) {
-            snprintf(info->author, author_len, "%s <%s>", author->name, author->email);
-        }
+        intern_author(authors, info, author->name, author->email);
 
-        // Format date
-        struct tm *tm = localtime(&author->when.time);
-        char date[32];
-        strftime(date, sizeof(date), "%Y-%m-%d", tm);
-        info->date = strdup(date);
+        // Kept as a number; the renderer formats days, once each
+        info->timestamp = author->when.time;
     }
 
     return RELEASY_SUCCESS;
 }
 
-int changelog_generate(changelog_t *log, git_repository *repo, const char *version) {
-    if (!log || !repo || !version) return RELEASY_ERROR;
-    
-    // Validate version format
-    int ret = validate_version_tag(version);
-    if (ret != RELEASY_SUCCESS) return ret;
-    
-    // Validate configuration
-    ret = validate_config(log);
-    if (ret != RELEASY_SUCCESS) return ret;
+// A directory the walk is limited to, shared by every thread. keys is set
+// when the commit-graph has changed-path filters to probe first.
+typedef struct {
+    const char *path;
+    const commit_graph_t *graph;
+    commit_graph_bloom_key_t *keys;
+    size_t key_count;
+} path_filter_t;
 
-    // Create new changelog entry
-    changelog_entry_t *entry = calloc(1, sizeof(changelog_entry_t));
-    if (!entry) return RELEASY_ERROR;
+typedef struct {
+    git_oid commit;
+    git_oid subtree;
+    unsigned char state;    // 0 empty, 1 path absent, 2 path present
+} subtree_slot_t;
 
-    entry->version = strdup(version);
-    if (!entry->version) {
-        free(entry);
-        return RELEASY_ERROR;
+// Per thread: the filter and a direct-mapped cache of the tree each commit
+// has at the path. A commit's subtree is compared against its parents'
+// and the parent is usually the next commit walked, so most subtrees are
+// resolved once rather than once per child.
+typedef struct {
+    const path_filter_t *filter;
+    subtree_slot_t *slots;
+} path_scope_t;
+
+static int path_scope_init(path_scope_t *scope, const path_filter_t *filter) {
+    scope->filter = filter;
+    scope->slots = calloc(CHANGELOG_SUBTREE_SLOTS, sizeof(subtree_slot_t));
+    return scope->slots ? RELEASY_SUCCESS : CHANGELOG_ERR_MEMORY;
+}
+
+static void path_scope_cleanup(path_scope_t *scope) {
+    free(scope->slots);
+    scope->slots = NULL;
+}
+
+// Returns 1 and the subtree id when the commit has the path, 0 when it
+// does not, -1 when the commit cannot be read
+static int commit_subtree(git_repository *repo, path_scope_t *scope, const git_oid *oid,
+                          git_commit *commit, git_oid *subtree) {
+    subtree_slot_t *slot = &scope->slots[(oid->id[0] | (oid->id[1] << 8)) % CHANGELOG_SUBTREE_SLOTS];
+    if (slot->state && git_oid_equal(&slot->commit, oid)) {
+        *subtree = slot->subtree;
+        return slot->state - 1;
     }
 
-    // Get current date
-    time_t now = time(NULL);
-    struct tm *tm = localtime(&now);
-    char date[32];
-    strftime(date, sizeof(date), "%Y-%m-%d", tm);
-    entry->date = strdup(date);
-
-    // Find previous version tag
-    git_strarray tags = {0};
-    int error = git_tag_list(&tags, repo);
-    if (error == 0 && tags.count > 0) {
-        // Sort tags by version
-        qsort(tags.strings, tags.count, sizeof(char *), tag_sorting_callback);
-        for (size_t i = 0; i < tags.count; i++) {
-            if (git_ops_is_version_tag(NULL, tags.strings[i])) {
-                entry->previous_version = strdup(tags.strings[i]);
-                break;
-            }
-        }
+    git_commit *owned = NULL;
+    if (!commit) {
+        if (git_commit_lookup(&owned, repo, oid) != 0) return -1;
+        commit = owned;
     }
-    git_strarray_free(&tags);
 
-    // Initialize revision walker
-    git_revwalk *walker = NULL;
-    error = get_commit_range(repo, entry->previous_version, NULL, &walker);
-    if (error) {
-        changelog_free_entry(entry);
-        return error;
+    git_tree *tree = NULL;
+    git_tree_entry *entry = NULL;
+    int found = -1;
+    if (git_commit_tree(&tree, commit) == 0) {
+        int error = git_tree_entry_bypath(&entry, tree, scope->filter->path);
+        if (error == 0) {
+            *subtree = *git_tree_entry_id(entry);
+            found = 1;
+        } else if (error == GIT_ENOTFOUND) {
+            memset(subtree, 0, sizeof(git_oid));
+            found = 0;
+        }
     }
+    git_tree_entry_free(entry);
+    git_tree_free(tree);
+    git_commit_free(owned);
 
-    // Walk through commits
-    git_oid oid;
-    size_t max_commits = 1000;  // Reasonable limit
-    size_t commit_count = 0;
-    commit_info_t **commits = NULL;
+    if (found >= 0) {
+        slot->commit = *oid;
+        slot->subtree = *subtree;
+        slot->state = (unsigned char)(found + 1);
+    }
+    return found;
+}
 
-    while (git_revwalk_next(&oid, walker) == 0 && commit_count < max_commits) {
-        git_commit *commit = NULL;
-        error = git_commit_lookup(&commit, repo, &oid);
-        if (error) continue;
-
-        const char *message = git_commit_message(commit);
-        if (message) {
-            commit_info_t *info = calloc(1, sizeof(commit_info_t));
-            if (info) {
-                if (changelog_parse_commit(message, info) == RELEASY_SUCCESS) {
-                    extract_commit_metadata(commit, info);
-
-                    // Add to commits array
-                    commit_info_t **new_commits = realloc(commits, 
-                        (commit_count + 1) * sizeof(commit_info_t *));
-                    if (new_commits) {
-                        commits = new_commits;
-                        commits[commit_count++] = info;
-                    } else {
-                        changelog_free_commit(info);
-                        free(info);
-                    }
-                } else {
-                    changelog_free_commit(info);
-                    free(info);
-                }
-            }
+// Whether the commit changed the path relative to every parent, git's
+// TREESAME rule. The changed-path filter answers most commits without
+// reading a tree.
+static int commit_touches_path(git_repository *repo, path_scope_t *scope, const git_oid *oid) {
+    const path_filter_t *filter = scope->filter;
+    if (filter->keys) {
+        uint32_t pos = commit_graph_find(filter->graph, oid);
+        if (pos != COMMIT_GRAPH_NONE &&
+            !commit_graph_bloom_maybe_changed(filter->graph, pos, filter->keys, filter->key_count)) {
+            return 0;
         }
-        git_commit_free(commit);
     }
 
-    git_revwalk_free(walker);
-
-    // Update entry with commits
-    entry->commits = commits;
-    entry->count = commit_count;
+    git_commit *commit = NULL;
+    if (git_commit_lookup(&commit, repo, oid) != 0) return -1;
+
+    git_oid subtree;
+    int has_path = commit_subtree(repo, scope, oid, commit, &subtree);
+    unsigned int parents = git_commit_parentcount(commit);
+    int touches = parents ? 1 : has_path;
+    for (unsigned int i = 0; has_path >= 0 && touches && i < parents; i++) {
+        git_oid parent_subtree;
+        int parent_has_path = commit_subtree(repo, scope, git_commit_parent_id(commit, i), NULL,
+                                             &parent_subtree);
+        if (parent_has_path < 0) {
+            has_path = -1;
+        } else if (parent_has_path == has_path &&
+                   (!has_path || git_oid_equal(&parent_subtree, &subtree))) {
+            touches = 0;
+        }
+    }
+    git_commit_free(commit);
+    return has_path < 0 ? -1 : touches;
+}
+
+// What became of a walked commit
+enum {
+    WALKED_SKIPPED,         // Lookup failed or outside the path
+    WALKED_OTHER,           // Not a conventional commit
+    WALKED_PARSED,
+    WALKED_CACHED_OTHER,
+    WALKED_CACHED,
+    WALKED_MERGE            // Listed under its pull request title, which the cache does not keep
+};
+
+// "Merge pull request #12 from user/branch" says nothing; GitHub and GitLab
+// put the pull request's title on the first line of the body
+static int merge_title(git_commit *commit, commit_info_t *info, arena_t *arena, walk_authors_t *authors) {
+    const char *body = git_commit_body(commit);
+    if (!body) return CHANGELOG_ERR_INVALID_FORMAT;
+
+    memset(info, 0, sizeof(commit_info_t));
+    int ret = commit_from_message(body, info, arena);
+    if (ret == RELEASY_SUCCESS) extract_commit_metadata(commit, info, arena, authors);
+    return ret;
+}
+
+// Answers from the cache when it can, otherwise looks up and parses the
+// commit. Commits outside scope (NULL for the whole tree) are skipped
+// before either, so the cache holds the same entries whatever the path.
+// With merge_titles a merge that is not a conventional commit itself is
+// read again for its pull request title.
+static int parse_walked_commit(git_repository *repo, commit_cache_t *cache, path_scope_t *scope,
+                               int merge_titles, const git_oid *oid, commit_info_t *info,
+                               arena_t *arena, walk_authors_t *authors) {
+    if (scope && commit_touches_path(repo, scope, oid) != 1) return WALKED_SKIPPED;
+
+    int cached_other = 0;
+    if (cache) {
+        switch (commit_cache_lookup(cache, oid, info)) {
+            case COMMIT_CACHE_HIT:
+                info->commit_hash = format_hash(oid, arena);
+                if (info->author) intern_author(authors, info, info->author, NULL);
+                return WALKED_CACHED;
+            case COMMIT_CACHE_HIT_OTHER:
+                if (!merge_titles) return WALKED_CACHED_OTHER;
+                cached_other = 1;
+                break;
+            case COMMIT_CACHE_MISS:
+                break;
+        }
+    }
+
+    git_commit *commit = NULL;
+    if (git_commit_lookup(&commit, repo, oid) != 0) return WALKED_SKIPPED;
+
+    int state = cached_other ? WALKED_CACHED_OTHER : WALKED_OTHER;
+    const char *message = git_commit_message(commit);
+    memset(info, 0, sizeof(commit_info_t));
+    if (!cached_other && message && commit_from_message(message, info, arena) == RELEASY_SUCCESS) {
+        extract_commit_metadata(commit, info, arena, authors);
+        state = WALKED_PARSED;
+    } else if (merge_titles && git_commit_parentcount(commit) > 1 &&
+               merge_title(commit, info, arena, authors) == RELEASY_SUCCESS) {
+        state = WALKED_MERGE;
+    }
+    git_commit_free(commit);
+    return state;
+}
+
+// Runs on the calling thread: records fresh parses in the cache, then hands
+// conventional commits to the callback
+static int emit_walked(commit_cache_t *cache, const git_oid *oid, int state,
+                       const commit_info_t *info, changelog_commit_cb cb, void *payload) {
+    if (cache && (state == WALKED_PARSED || state == WALKED_OTHER)) {
+        // A commit that fails to go in is simply parsed again next time
+        commit_cache_add(cache, oid, state == WALKED_PARSED ? info : NULL);
+    }
+    if (state != WALKED_PARSED && state != WALKED_CACHED && state != WALKED_MERGE) return RELEASY_SUCCESS;
+    return cb(info, payload);
+}
+
+// Commits from the revwalk, parsed in place by the pool. Each worker carves
+// its strings from its own arena, rewound once the batch has been emitted.
+typedef struct {
+    git_oid *oids;
+    commit_info_t *infos;
+    unsigned char *parsed;
+    arena_t *arenas;
+    size_t count;
+    atomic_size_t next;
+} walk_batch_t;
+
+typedef struct walk_pool walk_pool_t;
+
+typedef struct {
+    walk_pool_t *pool;
+    git_repository *repo;   // Own handle, so object lookups never share a cache
+    path_scope_t scope;
+    int index;
+} walk_worker_t;
+
+struct walk_pool {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t idle;
+    walk_batch_t *batch;
+    commit_cache_t *cache;  // Shared, lookups only
+    walk_authors_t *authors;
+    const path_filter_t *filter;
+    int merge_titles;
+    unsigned int generation;
+    int busy;
+    int stop;
+    int started;
+    walk_worker_t *workers;
+    pthread_t *threads;
+};
+
+static void parse_batch(walk_batch_t *batch, git_repository *repo, commit_cache_t *cache,
+                        path_scope_t *scope, int merge_titles, arena_t *arena, walk_authors_t *authors) {
+    size_t start;
+    while ((start = atomic_fetch_add(&batch->next, CHANGELOG_WALK_SLICE)) < batch->count) {
+        size_t end = start + CHANGELOG_WALK_SLICE;
+        if (end > batch->count) end = batch->count;
+        for (size_t i = start; i < end; i++) {
+            batch->parsed[i] = (unsigned char)parse_walked_commit(repo, cache, scope, merge_titles,
+                                                                 &batch->oids[i], &batch->infos[i],
+                                                                 arena, authors);
+        }
+    }
+}
+
+static void *walk_worker(void *arg) {
+    walk_worker_t *worker = arg;
+    walk_pool_t *pool = worker->pool;
+    unsigned int seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        seen = pool->generation;
+        walk_batch_t *batch = pool->batch;
+        pthread_mutex_unlock(&pool->lock);
+
+        parse_batch(batch, worker->repo, pool->cache, pool->filter ? &worker->scope : NULL,
+                    pool->merge_titles, &batch->arenas[worker->index], pool->authors);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->idle);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+static void pool_start(walk_pool_t *pool, walk_batch_t *batch) {
+    atomic_store(&batch->next, 0);
+    pthread_mutex_lock(&pool->lock);
+    pool->batch = batch;
+    pool->busy = pool->started;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void pool_wait(walk_pool_t *pool) {
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) pthread_cond_wait(&pool->idle, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void pool_stop(walk_pool_t *pool, int workers) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->started; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; pool->workers && i < workers; i++) {
+        if (pool->workers[i].repo) git_repository_free(pool->workers[i].repo);
+        path_scope_cleanup(&pool->workers[i].scope);
+    }
+    free(pool->workers);
+    free(pool->threads);
+    pthread_cond_destroy(&pool->idle);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+// Opens a repository handle per worker and starts them waiting for batches.
+// Fewer than two running workers is no better than the calling thread.
+static int pool_init(walk_pool_t *pool, git_repository *repo, commit_cache_t *cache,
+                     walk_authors_t *authors, const path_filter_t *filter, int merge_titles, int workers) {
+    memset(pool, 0, sizeof(walk_pool_t));
+    pool->cache = cache;
+    pool->authors = authors;
+    pool->filter = filter;
+    pool->merge_titles = merge_titles;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+
+    pool->workers = calloc((size_t)workers, sizeof(walk_worker_t));
+    pool->threads = calloc((size_t)workers, sizeof(pthread_t));
+    if (!pool->workers || !pool->threads) return CHANGELOG_ERR_MEMORY;
+
+    for (int i = 0; i < workers; i++) {
+        walk_worker_t *worker = &pool->workers[pool->started];
+        worker->pool = pool;
+        worker->index = pool->started;
+        if (filter && path_scope_init(&worker->scope, filter) != RELEASY_SUCCESS) break;
+        if (git_repository_open(&worker->repo, git_repository_path(repo)) != 0) break;
+        if (pthread_create(&pool->threads[pool->started], NULL, walk_worker, worker) != 0) {
+            git_repository_free(worker->repo);
+            worker->repo = NULL;
+            break;
+        }
+        pool->started++;
+    }
+    return pool->started > 1 ? RELEASY_SUCCESS : CHANGELOG_ERR_GIT_LOOKUP_FAILED;
+}
+
+static int batch_init(walk_batch_t *batch, size_t size, int workers) {
+    memset(batch, 0, sizeof(walk_batch_t));
+    atomic_init(&batch->next, 0);
+    batch->oids = malloc(size * sizeof(git_oid));
+    batch->infos = malloc(size * sizeof(commit_info_t));
+    batch->parsed = malloc(size);
+    batch->arenas = calloc((size_t)workers, sizeof(arena_t));
+    if (!batch->oids || !batch->infos || !batch->parsed || !batch->arenas) return CHANGELOG_ERR_MEMORY;
+    return RELEASY_SUCCESS;
+}
+
+static void batch_cleanup(walk_batch_t *batch, int workers) {
+    for (int i = 0; batch->arenas && i < workers; i++) {
+        arena_cleanup(&batch->arenas[i]);
+    }
+    free(batch->arenas);
+    free(batch->parsed);
+    free(batch->infos);
+    free(batch->oids);
+}
+
+// Returns whether the walk may have more commits after this batch
+static int fill_batch(commit_source_t *source, walk_batch_t *batch, size_t size, int *walk_error) {
+    batch->count = 0;
+    while (batch->count < size) {
+        int error = source_next(source, &batch->oids[batch->count]);
+        if (error) {
+            if (error != GIT_ITEROVER) *walk_error = 1;
+            return 0;
+        }
+        batch->count++;
+    }
+    return 1;
+}
+
+static int emit_batch(walk_batch_t *batch, int workers, commit_cache_t *cache,
+                      changelog_commit_cb cb, void *payload) {
+    int ret = RELEASY_SUCCESS;
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < batch->count; i++) {
+        ret = emit_walked(cache, &batch->oids[i], batch->parsed[i], &batch->infos[i], cb, payload);
+    }
+    for (int i = 0; i < workers; i++) {
+        arena_reset(&batch->arenas[i]);
+    }
+    return ret;
+}
+
+// Handles commits on the calling thread, one in flight at a time, starting
+// with any already pulled into pending
+static int serial_walk(git_repository *repo, commit_cache_t *cache, walk_authors_t *authors,
+                       path_scope_t *scope, int merge_titles, commit_source_t *source,
+                       const walk_batch_t *pending, int more, changelog_commit_cb cb, void *payload,
+                       int *walk_error) {
+    arena_t scratch;
+    arena_init(&scratch);
+
+    int ret = RELEASY_SUCCESS;
+    commit_info_t info;
+    for (size_t i = 0; pending && ret == RELEASY_SUCCESS && i < pending->count; i++) {
+        const git_oid *oid = &pending->oids[i];
+        int state = parse_walked_commit(repo, cache, scope, merge_titles, oid, &info, &scratch, authors);
+        ret = emit_walked(cache, oid, state, &info, cb, payload);
+        arena_reset(&scratch);
+    }
+
+    git_oid oid;
+    int error = 0;
+    while (more && ret == RELEASY_SUCCESS && (error = source_next(source, &oid)) == 0) {
+        int state = parse_walked_commit(repo, cache, scope, merge_titles, &oid, &info, &scratch, authors);
+        ret = emit_walked(cache, &oid, state, &info, cb, payload);
+        arena_reset(&scratch);
+    }
+    if (error && error != GIT_ITEROVER) *walk_error = 1;
+
+    arena_cleanup(&scratch);
+    return ret;
+}
+
+/*
+ * While the pool parses one batch the calling thread pulls the next one off
+ * the revwalk, then hands the parsed batch to the callback in walk order as
+ * the pool moves on to the next. Every lookup in the pool goes through the
+ * worker's own repository handle.
+ */
+static int parallel_walk(walk_pool_t *pool, walk_batch_t batches[2], size_t batch_size,
+                         commit_source_t *source, changelog_commit_cb cb, void *payload,
+                         int *walk_error) {
+    walk_batch_t *current = &batches[0];
+    int more = 1;
+    int ret = RELEASY_SUCCESS;
+
+    pool_start(pool, current);
+    for (;;) {
+        walk_batch_t *next = current == &batches[0] ? &batches[1] : &batches[0];
+        next->count = 0;
+        if (more) more = fill_batch(source, next, batch_size, walk_error);
+
+        pool_wait(pool);
+        if (next->count) pool_start(pool, next);
+
+        ret = emit_batch(current, pool->started, pool->cache, cb, payload);
+        if (ret != RELEASY_SUCCESS || !next->count) {
+            if (next->count) {
+                atomic_store(&next->next, next->count);
+                pool_wait(pool);
+            }
+            break;
+        }
+        current = next;
+    }
+    return ret;
+}
+
+static int walk_worker_count(const changelog_walk_options_t *opts) {
+    long workers = opts->workers;
+    if (workers <= 0) workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    if (workers > CHANGELOG_MAX_WORKERS) workers = CHANGELOG_MAX_WORKERS;
+    return (int)workers;
+}
+
+// Strips "./" and trailing slashes; "" and "." mean the whole tree. Paths
+// leaving the repository are refused.
+static int normalize_walk_path(const char *path, char *out, size_t size) {
+    while (path[0] == '.' && path[1] == '/') path += 2;
+    if (strcmp(path, ".") == 0) path = "";
+    if (path[0] == '/' || strstr(path, "..")) return CHANGELOG_ERR_INVALID_PATH;
+
+    size_t len = strlen(path);
+    while (len > 0 && path[len - 1] == '/') len--;
+    if (len >= size) return CHANGELOG_ERR_INVALID_PATH;
+    memcpy(out, path, len);
+    out[len] = '\0';
+    return RELEASY_SUCCESS;
+}
+
+// Hashes the path for the graph's filters, if it has any, and sets up the
+// calling thread's scope. Nothing to do for the whole tree.
+static int path_filter_init(path_filter_t *filter, path_scope_t *scope) {
+    if (!filter->path[0]) return RELEASY_SUCCESS;
+    if (filter->graph) {
+        commit_graph_bloom_keys(filter->graph, filter->path, &filter->keys, &filter->key_count);
+    }
+    return path_scope_init(scope, filter);
+}
+
+static void path_filter_cleanup(path_filter_t *filter, path_scope_t *scope) {
+    path_scope_cleanup(scope);
+    free(filter->keys);
+    filter->keys = NULL;
+}
+
+static void walk_finish(commit_graph_t *graph, path_filter_t *filter, path_scope_t *scope,
+                        commit_source_t *source) {
+    source_free(source);
+    path_filter_cleanup(filter, scope);
+    if (graph) commit_graph_close(graph);
+}
+
+// A release index per commit id: the oldest release each commit belongs to
+// when rebuilding, or just the commits seen by a search. Open addressing on
+// the commit id, which is already well mixed; patch ids are keyed the same
+// way when duplicates are dropped.
+typedef struct {
+    git_oid oid;
+    size_t release;     // RELEASE_NONE marks an empty slot
+} release_mark_t;
+
+#define RELEASE_NONE ((size_t)-1)
+
+typedef struct {
+    release_mark_t *slots;
+    size_t capacity;    // Power of two
+    size_t count;
+} release_marks_t;
+
+static size_t mark_slot(const release_marks_t *marks, const git_oid *oid) {
+    size_t hash;
+    memcpy(&hash, oid->id, sizeof(hash));
+    size_t mask = marks->capacity - 1;
+    size_t i = hash & mask;
+    while (marks->slots[i].release != RELEASE_NONE && !git_oid_equal(&marks->slots[i].oid, oid)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static int marks_grow(release_marks_t *marks) {
+    release_marks_t grown = { NULL, marks->capacity ? marks->capacity * 2 : 1024, marks->count };
+    grown.slots = malloc(grown.capacity * sizeof(release_mark_t));
+    if (!grown.slots) return CHANGELOG_ERR_MEMORY;
+    for (size_t i = 0; i < grown.capacity; i++) grown.slots[i].release = RELEASE_NONE;
+
+    for (size_t i = 0; i < marks->capacity; i++) {
+        if (marks->slots[i].release != RELEASE_NONE) {
+            grown.slots[mark_slot(&grown, &marks->slots[i].oid)] = marks->slots[i];
+        }
+    }
+    free(marks->slots);
+    *marks = grown;
+    return RELEASY_SUCCESS;
+}
+
+// Records that oid is contained in release, keeping the oldest
+static int marks_lower(release_marks_t *marks, const git_oid *oid, size_t release) {
+    if ((marks->count + 1) * 2 > marks->capacity && marks_grow(marks) != RELEASY_SUCCESS) {
+        return CHANGELOG_ERR_MEMORY;
+    }
+
+    release_mark_t *mark = &marks->slots[mark_slot(marks, oid)];
+    if (mark->release == RELEASE_NONE) {
+        mark->oid = *oid;
+        mark->release = release;
+        marks->count++;
+    } else if (release < mark->release) {
+        mark->release = release;
+    }
+    return RELEASY_SUCCESS;
+}
+
+static size_t marks_find(const release_marks_t *marks, const git_oid *oid) {
+    if (!marks->capacity) return RELEASE_NONE;
+    return marks->slots[mark_slot(marks, oid)].release;
+}
+
+// Pulls every commit of the range, merges already expanded, into oids
+static int drain_source(commit_source_t *source, git_oid **oids, size_t *count, size_t *capacity) {
+    git_oid oid;
+    int error;
+    while ((error = source_next(source, &oid)) == 0) {
+        if (*count == *capacity) {
+            size_t grown_capacity = *capacity ? *capacity * 2 : 1024;
+            git_oid *grown = realloc(*oids, grown_capacity * sizeof(git_oid));
+            if (!grown) return CHANGELOG_ERR_MEMORY;
+            *oids = grown;
+            *capacity = grown_capacity;
+        }
+        (*oids)[(*count)++] = oid;
+    }
+    return error == GIT_ITEROVER ? RELEASY_SUCCESS : CHANGELOG_ERR_GIT_WALK_FAILED;
+}
+
+// The commits on compare that to does not have, the other side of
+// `git log --cherry-pick to...compare`
+static int drain_compare(git_repository *repo, const char *compare, const char *to,
+                         git_oid **oids, size_t *count, size_t *capacity) {
+    git_oid compare_oid, to_oid;
+    int ret = resolve_commit(&compare_oid, repo, compare);
+    if (ret == RELEASY_SUCCESS) ret = resolve_commit(&to_oid, repo, to ? to : "HEAD");
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    commit_source_t other = { 0 };
+    if (git_revwalk_new(&other.walker, repo) != 0) return CHANGELOG_ERR_GIT_WALK_FAILED;
+    git_revwalk_sorting(other.walker, GIT_SORT_NONE);
+    if (git_revwalk_push(other.walker, &compare_oid) != 0 || git_revwalk_hide(other.walker, &to_oid) != 0) {
+        ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+    }
+    if (ret == RELEASY_SUCCESS) ret = drain_source(&other, oids, count, capacity);
+    source_free(&other);
+    return ret;
+}
+
+static int is_zero_id(const unsigned char *id) {
+    for (size_t i = 0; i < GIT_OID_RAWSZ; i++) {
+        if (id[i]) return 0;
+    }
+    return 1;
+}
+
+/*
+ * Marks the range commits to leave out. Newest first, a revert whose
+ * commit is still listed cancels against it, so a revert of a revert takes
+ * out the first revert and leaves the original in. Then oldest first,
+ * a change already seen, on compare or earlier in the range, is a
+ * cherry-pick of it.
+ */
+static int mark_duplicates(const patch_id_entry_t *entries, size_t range_count, size_t total,
+                           unsigned char *drop) {
+    release_marks_t commits = { NULL, 0, 0 };
+    release_marks_t patches = { NULL, 0, 0 };
+    git_oid id;
+    int ret = RELEASY_SUCCESS;
+
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < range_count; i++) {
+        git_oid_fromraw(&id, entries[i].commit);
+        ret = marks_lower(&commits, &id, i);
+    }
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < range_count; i++) {
+        if (drop[i] || is_zero_id(entries[i].reverts)) continue;
+        git_oid_fromraw(&id, entries[i].reverts);
+        size_t original = marks_find(&commits, &id);
+        if (original != RELEASE_NONE && original != i && !drop[original]) {
+            drop[i] = 1;
+            drop[original] = 1;
+        }
+    }
+
+    for (size_t i = range_count; ret == RELEASY_SUCCESS && i < total; i++) {
+        if (is_zero_id(entries[i].patch)) continue;
+        git_oid_fromraw(&id, entries[i].patch);
+        ret = marks_lower(&patches, &id, i);
+    }
+    for (size_t i = range_count; ret == RELEASY_SUCCESS && i-- > 0;) {
+        if (drop[i] || is_zero_id(entries[i].patch)) continue;
+        git_oid_fromraw(&id, entries[i].patch);
+        if (marks_find(&patches, &id) != RELEASE_NONE) {
+            drop[i] = 1;
+        } else {
+            ret = marks_lower(&patches, &id, i);
+        }
+    }
+
+    free(patches.slots);
+    free(commits.slots);
+    return ret;
+}
+
+// Replaces the source with its commits minus cherry-picks and reverted
+// pairs. Patch ids for the range and compare are computed together on the
+// pool, answered from .git/releasy/patch-ids.cache where it has them.
+static int source_drop_duplicates(git_repository *repo, const char *to,
+                                  const changelog_walk_options_t *opts, commit_source_t *source) {
+    git_oid *oids = NULL;
+    size_t count = 0, capacity = 0;
+    int ret = drain_source(source, &oids, &count, &capacity);
+    size_t range_count = count;
+    if (ret == RELEASY_SUCCESS && opts->compare) {
+        ret = drain_compare(repo, opts->compare, to, &oids, &count, &capacity);
+    }
+
+    patch_id_entry_t *entries = NULL;
+    unsigned char *drop = NULL;
+    if (ret == RELEASY_SUCCESS && count) {
+        entries = malloc(count * sizeof(patch_id_entry_t));
+        drop = calloc(range_count ? range_count : 1, 1);
+        if (!entries || !drop) ret = CHANGELOG_ERR_MEMORY;
+    }
+
+    if (ret == RELEASY_SUCCESS && count) {
+        patch_id_cache_t cache_storage;
+        patch_id_cache_t *cache = NULL;
+        if (opts->use_cache && patch_id_cache_open(&cache_storage, repo) == RELEASY_SUCCESS) {
+            cache = &cache_storage;
+        }
+        ret = patch_id_compute_all(repo, cache, oids, count, opts->workers, entries);
+        if (cache) {
+            // As with the commit cache, a lost race only costs recomputing
+            patch_id_cache_save(cache, repo);
+            patch_id_cache_close(cache);
+        }
+        if (ret != RELEASY_SUCCESS) ret = CHANGELOG_ERR_MEMORY;
+    }
+    if (ret == RELEASY_SUCCESS && count) ret = mark_duplicates(entries, range_count, count, drop);
+
+    size_t kept = 0;
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < range_count; i++) {
+        if (!drop[i]) oids[kept++] = oids[i];
+    }
+
+    free(drop);
+    free(entries);
+    source_free(source);
+    if (ret != RELEASY_SUCCESS) {
+        free(oids);
+        return ret;
+    }
+    source->oids = oids;
+    source->count = kept;
+    return RELEASY_SUCCESS;
+}
+
+// changelog_walk() interning authors into table
+static int walk_range(git_repository *repo, const char *from, const char *to,
+                      const changelog_walk_options_t *opts, author_table_t *table,
+                      changelog_commit_cb cb, void *payload) {
+    if (!repo || !cb) return RELEASY_ERROR;
+
+    changelog_walk_options_t defaults = CHANGELOG_WALK_OPTIONS_INIT;
+    if (!opts) opts = &defaults;
+    int workers = walk_worker_count(opts);
+    size_t batch_size = opts->batch_size ? opts->batch_size : CHANGELOG_WALK_BATCH;
+
+    char path[PATH_MAX];
+    int ret = normalize_walk_path(opts->path ? opts->path : "", path, sizeof(path));
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    // The graph serves both the range and the changed-path filters
+    commit_graph_t graph_storage;
+    commit_graph_t *graph = NULL;
+    if (commit_graph_open(&graph_storage, repo) == RELEASY_SUCCESS) graph = &graph_storage;
+
+    path_filter_t filter = { path, graph, NULL, 0 };
+    path_scope_t serial_scope = { NULL, NULL };
+    commit_source_t source = { 0 };
+    ret = path_filter_init(&filter, &serial_scope);
+    if (ret == RELEASY_SUCCESS) ret = get_commit_range(repo, graph, from, to, opts, &source);
+    if (ret == RELEASY_SUCCESS && (opts->cherry_pick || opts->compare)) {
+        ret = source_drop_duplicates(repo, to, opts, &source);
+    }
+    if (ret != RELEASY_SUCCESS) {
+        walk_finish(graph, &filter, &serial_scope, &source);
+        return ret;
+    }
+    path_scope_t *scope = path[0] ? &serial_scope : NULL;
+
+    // The cache only saves work; without it every commit is parsed
+    commit_cache_t cache_storage;
+    commit_cache_t *cache = NULL;
+    if (opts->use_cache && commit_cache_open(&cache_storage, repo) == RELEASY_SUCCESS) {
+        cache = &cache_storage;
+    }
+
+    walk_authors_t authors = { table, PTHREAD_MUTEX_INITIALIZER };
+    int walk_error = 0;
+    if (workers <= 1) {
+        ret = serial_walk(repo, cache, &authors, scope, opts->first_parent, &source, NULL, 1, cb,
+                          payload, &walk_error);
+    } else {
+        walk_batch_t batches[2];
+        ret = batch_init(&batches[0], batch_size, workers);
+        if (ret == RELEASY_SUCCESS) ret = batch_init(&batches[1], batch_size, workers);
+
+        // A range that fits in one batch is not worth starting threads for
+        int more = 0;
+        if (ret == RELEASY_SUCCESS) more = fill_batch(&source, &batches[0], batch_size, &walk_error);
+
+        walk_pool_t pool;
+        int pooled = more && pool_init(&pool, repo, cache, &authors, scope ? &filter : NULL,
+                                       opts->first_parent, workers) == RELEASY_SUCCESS;
+        if (ret == RELEASY_SUCCESS) {
+            ret = pooled ? parallel_walk(&pool, batches, batch_size, &source, cb, payload, &walk_error)
+                         : serial_walk(repo, cache, &authors, scope, opts->first_parent, &source,
+                                       &batches[0], more, cb, payload, &walk_error);
+        }
+        if (more) pool_stop(&pool, workers);
+
+        batch_cleanup(&batches[0], workers);
+        batch_cleanup(&batches[1], workers);
+    }
+
+    walk_finish(graph, &filter, &serial_scope, &source);
+    if (cache) {
+        // Losing a race with another writer only costs the next run some parsing
+        commit_cache_save(cache, repo);
+        commit_cache_close(cache);
+    }
+    pthread_mutex_destroy(&authors.lock);
+    if (ret == RELEASY_SUCCESS && walk_error) ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+    return ret;
+}
+
+int changelog_walk(git_repository *repo, const char *from, const char *to,
+                   const changelog_walk_options_t *opts, changelog_commit_cb cb, void *payload) {
+    // Authors only need to outlive each callback
+    author_table_t table;
+    author_table_init(&table);
+    int ret = walk_range(repo, from, to, opts, &table, cb, payload);
+    author_table_cleanup(&table);
+    return ret;
+}
+
+// Nearest-tag search: every commit reachable from HEAD ordered by
+// generation, highest first, in a binary heap. Commits newer than the
+// graph file sort above all of it.
+typedef struct {
+    uint32_t generation;
+    uint32_t pos;       // COMMIT_GRAPH_NONE when the graph predates the commit
+    git_oid oid;
+} graph_node_t;
+
+typedef struct {
+    graph_node_t *nodes;
+    size_t count;
+    size_t capacity;
+} graph_queue_t;
+
+static int queue_push(graph_queue_t *queue, const commit_graph_t *graph, const git_oid *oid) {
+    if (queue->count == queue->capacity) {
+        size_t capacity = queue->capacity ? queue->capacity * 2 : 256;
+        graph_node_t *nodes = realloc(queue->nodes, capacity * sizeof(graph_node_t));
+        if (!nodes) return CHANGELOG_ERR_MEMORY;
+        queue->nodes = nodes;
+        queue->capacity = capacity;
+    }
+
+    graph_node_t node = { UINT32_MAX, commit_graph_find(graph, oid), *oid };
+    if (node.pos != COMMIT_GRAPH_NONE) node.generation = commit_graph_generation(graph, node.pos);
+
+    size_t i = queue->count++;
+    while (i > 0 && queue->nodes[(i - 1) / 2].generation < node.generation) {
+        queue->nodes[i] = queue->nodes[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    queue->nodes[i] = node;
+    return RELEASY_SUCCESS;
+}
+
+static graph_node_t queue_pop(graph_queue_t *queue) {
+    graph_node_t top = queue->nodes[0];
+    graph_node_t last = queue->nodes[--queue->count];
+
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count &&
+            queue->nodes[child + 1].generation > queue->nodes[child].generation) {
+            child++;
+        }
+        if (queue->nodes[child].generation <= last.generation) break;
+        queue->nodes[i] = queue->nodes[child];
+        i = child;
+    }
+    if (queue->count) queue->nodes[i] = last;
+    return top;
+}
+
+// Queues the parents of node not seen before, from the graph when it has
+// the commit and from the object database otherwise
+static int queue_parents(graph_queue_t *queue, release_marks_t *seen, const commit_graph_t *graph,
+                         git_repository *repo, const graph_node_t *node) {
+    size_t count = 0;
+    git_commit *commit = NULL;
+
+    uint32_t positions[16];
+    uint32_t *graph_parents = positions;
+    if (node->pos != COMMIT_GRAPH_NONE) {
+        count = commit_graph_parents(graph, node->pos, positions, 16);
+        if (count > 16) {
+            graph_parents = malloc(count * sizeof(uint32_t));
+            if (!graph_parents) return CHANGELOG_ERR_MEMORY;
+            commit_graph_parents(graph, node->pos, graph_parents, count);
+        }
+    } else {
+        if (git_commit_lookup(&commit, repo, &node->oid) != 0) return CHANGELOG_ERR_GIT_LOOKUP_FAILED;
+        count = git_commit_parentcount(commit);
+    }
+
+    int ret = RELEASY_SUCCESS;
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < count; i++) {
+        git_oid parent;
+        if (commit) {
+            parent = *git_commit_parent_id(commit, (unsigned int)i);
+        } else {
+            commit_graph_oid(graph, graph_parents[i], &parent);
+        }
+        if (marks_find(seen, &parent) != RELEASE_NONE) continue;
+        ret = marks_lower(seen, &parent, 0);
+        if (ret == RELEASY_SUCCESS) ret = queue_push(queue, graph, &parent);
+    }
+
+    if (graph_parents != positions) free(graph_parents);
+    if (commit) git_commit_free(commit);
+    return ret;
+}
+
+/*
+ * A commit can only reach commits of lower generation, so popping the
+ * highest generation first visits every candidate that could be closer to
+ * HEAD before the one it returns. Nothing but the commits since that tag
+ * and the ones racing alongside them is read.
+ */
+static size_t nearest_tag_by_graph(git_repository *repo, const commit_graph_t *graph,
+                                   const git_oid *head, const release_marks_t *tags, int *complete) {
+    graph_queue_t queue = { NULL, 0, 0 };
+    release_marks_t seen = { NULL, 0, 0 };
+    size_t found = RELEASE_NONE;
+
+    int ret = marks_lower(&seen, head, 0);
+    if (ret == RELEASY_SUCCESS) ret = queue_push(&queue, graph, head);
+    while (ret == RELEASY_SUCCESS && queue.count) {
+        graph_node_t node = queue_pop(&queue);
+        found = marks_find(tags, &node.oid);
+        if (found != RELEASE_NONE) break;
+        ret = queue_parents(&queue, &seen, graph, repo, &node);
+    }
+
+    *complete = ret == RELEASY_SUCCESS;
+    free(queue.nodes);
+    free(seen.slots);
+    return found;
+}
+
+// Without generation numbers: newest commits first, giving up after
+// CHANGELOG_DESCRIBE_MAX_COMMITS
+static size_t nearest_tag_by_walk(git_repository *repo, const git_oid *head,
+                                  const release_marks_t *tags, int *complete) {
+    *complete = 0;
+    git_revwalk *walker = NULL;
+    if (git_revwalk_new(&walker, repo) != 0) return RELEASE_NONE;
+
+    size_t found = RELEASE_NONE;
+    git_revwalk_sorting(walker, GIT_SORT_TIME);
+    if (git_revwalk_push(walker, head) == 0) {
+        git_oid oid;
+        int error = 0;
+        size_t walked = 0;
+        while (walked++ < CHANGELOG_DESCRIBE_MAX_COMMITS && (error = git_revwalk_next(&oid, walker)) == 0) {
+            found = marks_find(tags, &oid);
+            if (found != RELEASE_NONE) break;
+        }
+        *complete = found != RELEASE_NONE || error == GIT_ITEROVER;
+    }
+
+    git_revwalk_free(walker);
+    return found;
+}
+
+// The version tag closest to HEAD among those older than target, the way
+// git describe would pick it; NULL when none is an ancestor of HEAD
+static char *find_previous_version(git_repository *repo, const char *version) {
+    semver_key_t target;
+    if (semver_key_parse(version, strlen(version), &target) != 0) return NULL;
+
+    version_list_t versions;
+    version_list_init(&versions);
+    if (version_list_load(&versions, repo) != RELEASY_SUCCESS) {
+        version_list_cleanup(&versions);
+        return NULL;
+    }
+
+    // Newest first, so a commit with several tags answers with the newest
+    release_marks_t tags = { NULL, 0, 0 };
+    size_t newest = RELEASE_NONE;
+    int ret = RELEASY_SUCCESS;
+    for (size_t i = versions.count; ret == RELEASY_SUCCESS && i-- > 0;) {
+        version_list_item_t *item = &versions.items[i];
+        if (semver_key_compare_exact(&item->key, item->version, &target, version) >= 0) continue;
+        if (newest == RELEASE_NONE) newest = i;
+
+        if (git_oid_is_zero(&item->commit) && resolve_commit(&item->commit, repo, item->tag) != RELEASY_SUCCESS) {
+            continue;
+        }
+        if (marks_find(&tags, &item->commit) == RELEASE_NONE) ret = marks_lower(&tags, &item->commit, i);
+    }
+
+    size_t found = RELEASE_NONE;
+    int complete = 0;
+    git_oid head;
+    if (ret == RELEASY_SUCCESS && tags.count && resolve_commit(&head, repo, "HEAD") == RELEASY_SUCCESS) {
+        commit_graph_t graph;
+        if (commit_graph_open(&graph, repo) == RELEASY_SUCCESS) {
+            found = nearest_tag_by_graph(repo, &graph, &head, &tags, &complete);
+            commit_graph_close(&graph);
+        } else {
+            found = nearest_tag_by_walk(repo, &head, &tags, &complete);
+        }
+    }
+
+    // A search cut short still beats walking everything: fall back to the
+    // newest older version
+    if (found == RELEASE_NONE && !complete) found = newest;
+
+    char *previous = found != RELEASE_NONE ? strdup(versions.items[found].tag) : NULL;
+    free(tags.slots);
+    version_list_cleanup(&versions);
+    return previous;
+}
+
+// "v1.2.0" is the tag spelling of release 1.2.0; entries and the previous
+// release lookup use the bare version
+static const char *release_version(const char *version) {
+    return version && version[0] == 'v' ? version + 1 : version;
+}
+
+static int validate_generate(changelog_t *log, git_repository *repo, const char *version) {
+    if (!log || !version) return RELEASY_ERROR;
+
+    // A malformed version is reported even without a repository
+    int ret = validate_version_tag(version);
+    if (ret != RELEASY_SUCCESS) return ret;
+    if (!repo) return RELEASY_ERROR;
+
+    return validate_config(log);
+}
+
+static char *current_date(void) {
+    char date[DATE_DAY_LENGTH + 1];
+    if (date_format_day(time(NULL), date) != RELEASY_SUCCESS) return NULL;
+    return strdup(date);
+}
+
+typedef struct {
+    changelog_entry_t *entry;
+    size_t capacity;
+    arena_t *arena;
+} commit_collector_t;
+
+// Batch stage: copies the commit out of the walk's scratch arena into the
+// changelog's, growing the pointer vector geometrically
+static int collect_commit(const commit_info_t *commit, void *payload) {
+    commit_collector_t *collector = payload;
+    changelog_entry_t *entry = collector->entry;
+
+    if (entry->count == collector->capacity) {
+        size_t capacity = collector->capacity ? collector->capacity * 2 : 64;
+        commit_info_t **commits = realloc(entry->commits, capacity * sizeof(commit_info_t *));
+        if (!commits) return CHANGELOG_ERR_MEMORY;
+        entry->commits = commits;
+        collector->capacity = capacity;
+    }
+
+    arena_t *arena = collector->arena;
+    commit_info_t *info = arena_alloc(arena, sizeof(commit_info_t));
+    if (!info) return CHANGELOG_ERR_MEMORY;
+
+    *info = *commit;
+    info->scope = arena_strdup(arena, commit->scope);
+    info->description = arena_strdup(arena, commit->description);
+    info->body = arena_strdup(arena, commit->body);
+    info->footer = arena_strdup(arena, commit->footer);
+    info->commit_hash = arena_strdup(arena, commit->commit_hash);
+    if (!info->description) return CHANGELOG_ERR_MEMORY;
+
+    // The walk interned the author into the changelog's table; the id and
+    // the table's string are all a commit keeps
+
+    entry->commits[entry->count++] = info;
+    return RELEASY_SUCCESS;
+}
+
+int changelog_generate(changelog_t *log, git_repository *repo, const char *version) {
+    version = release_version(version);
+    int ret = validate_generate(log, repo, version);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    // Create new changelog entry
+    changelog_entry_t *entry = calloc(1, sizeof(changelog_entry_t));
+    if (!entry) return RELEASY_ERROR;
+
+    entry->version = strdup(version);
+    entry->date = current_date();
+    if (!entry->version || !entry->date) {
+        changelog_free_entry(entry);
+        free(entry);
+        return CHANGELOG_ERR_MEMORY;
+    }
+    entry->previous_version = find_previous_version(repo, version);
+    entry->pooled = 1;
+
+    commit_collector_t collector = { entry, 0, &log->arena };
+    ret = walk_range(repo, entry->previous_version, NULL, &log->walk, &log->authors, collect_commit, &collector);
+    if (ret != RELEASY_SUCCESS) {
+        changelog_free_entry(entry);
+        free(entry);
+        return ret;
+    }
 
     // Add entry to changelog
     changelog_entry_t **new_entries = realloc(log->entries,
         (log->count + 1) * sizeof(changelog_entry_t *));
     if (!new_entries) {
         changelog_free_entry(entry);
+        free(entry);
         return RELEASY_ERROR;
     }
 
@@ -486,6 +1881,374 @@ int changelog_generate(changelog_t *log, git_repository *repo, const char *versi
     return RELEASY_SUCCESS;
 }
 
+static char *commit_date(git_repository *repo, const git_oid *oid) {
+    git_commit *commit = NULL;
+    if (git_commit_lookup(&commit, repo, oid) != 0) return current_date();
+
+    int64_t when = git_commit_time(commit);
+    git_commit_free(commit);
+
+    char date[DATE_DAY_LENGTH + 1];
+    if (date_format_day(when, date) != RELEASY_SUCCESS) return NULL;
+    return strdup(date);
+}
+
+// One entry per version tag, dated by its commit and opened empty
+static int release_entries_init(changelog_entry_t **entries, commit_collector_t *collectors,
+                                const version_list_t *versions, git_repository *repo,
+                                arena_t *arena) {
+    for (size_t i = 0; i < versions->count; i++) {
+        const version_list_item_t *item = &versions->items[i];
+        changelog_entry_t *entry = calloc(1, sizeof(changelog_entry_t));
+        if (!entry) return CHANGELOG_ERR_MEMORY;
+        entries[i] = entry;
+
+        entry->version = strdup(item->version);
+        entry->date = commit_date(repo, &item->commit);
+        entry->previous_version = i > 0 ? strdup(versions->items[i - 1].tag) : NULL;
+        entry->pooled = 1;
+        if (!entry->version || !entry->date || (i > 0 && !entry->previous_version)) {
+            return CHANGELOG_ERR_MEMORY;
+        }
+
+        collectors[i].entry = entry;
+        collectors[i].capacity = 0;
+        collectors[i].arena = arena;
+    }
+    return RELEASY_SUCCESS;
+}
+
+/*
+ * Topological order hands out every child before its parents, so by the
+ * time a commit comes off the walk each release that contains it has
+ * already passed its mark down. The commit lands in the oldest of them and
+ * hands that on to its own parents.
+ */
+static int walk_releases(git_repository *repo, git_revwalk *walker, release_marks_t *marks,
+                         commit_collector_t *collectors, commit_cache_t *cache, walk_authors_t *authors,
+                         path_scope_t *scope) {
+    arena_t scratch;
+    arena_init(&scratch);
+
+    int ret = RELEASY_SUCCESS;
+    int error = 0;
+    git_oid oid;
+    while (ret == RELEASY_SUCCESS && (error = git_revwalk_next(&oid, walker)) == 0) {
+        size_t release = marks_find(marks, &oid);
+        if (release == RELEASE_NONE) continue;
+
+        git_commit *commit = NULL;
+        if (git_commit_lookup(&commit, repo, &oid) != 0) {
+            ret = CHANGELOG_ERR_GIT_LOOKUP_FAILED;
+            break;
+        }
+        unsigned int parents = git_commit_parentcount(commit);
+        for (unsigned int i = 0; ret == RELEASY_SUCCESS && i < parents; i++) {
+            ret = marks_lower(marks, git_commit_parent_id(commit, i), release);
+        }
+        git_commit_free(commit);
+        if (ret != RELEASY_SUCCESS) break;
+
+        commit_info_t info;
+        int state = parse_walked_commit(repo, cache, scope, 0, &oid, &info, &scratch, authors);
+        ret = emit_walked(cache, &oid, state, &info, collect_commit, &collectors[release]);
+        arena_reset(&scratch);
+    }
+    if (ret == RELEASY_SUCCESS && error && error != GIT_ITEROVER) ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+
+    arena_cleanup(&scratch);
+    return ret;
+}
+
+int changelog_generate_all(changelog_t *log, git_repository *repo) {
+    if (!log || !repo) return RELEASY_ERROR;
+
+    int ret = validate_config(log);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    version_list_t versions;
+    version_list_init(&versions);
+    ret = version_list_load(&versions, repo);
+    if (ret == RELEASY_SUCCESS && versions.count == 0) ret = CHANGELOG_ERR_TAG_NOT_FOUND;
+    if (ret != RELEASY_SUCCESS) {
+        version_list_cleanup(&versions);
+        return ret == CHANGELOG_ERR_TAG_NOT_FOUND ? ret : CHANGELOG_ERR_GIT_LOOKUP_FAILED;
+    }
+
+    changelog_entry_t **entries = calloc(versions.count, sizeof(changelog_entry_t *));
+    commit_collector_t *collectors = calloc(versions.count, sizeof(commit_collector_t));
+    changelog_entry_t **grown = realloc(log->entries,
+        (log->count + versions.count) * sizeof(changelog_entry_t *));
+    if (grown) log->entries = grown;
+    if (!entries || !collectors || !grown) ret = CHANGELOG_ERR_MEMORY;
+
+    git_revwalk *walker = NULL;
+    if (ret == RELEASY_SUCCESS && git_revwalk_new(&walker, repo) != 0) ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+    if (ret == RELEASY_SUCCESS) git_revwalk_sorting(walker, GIT_SORT_TOPOLOGICAL | GIT_SORT_TIME);
+
+    // Every tag starts the walk and marks its own commit
+    release_marks_t marks = { NULL, 0, 0 };
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < versions.count; i++) {
+        version_list_item_t *item = &versions.items[i];
+        if (git_oid_is_zero(&item->commit)) ret = resolve_commit(&item->commit, repo, item->tag);
+        if (ret == RELEASY_SUCCESS) ret = marks_lower(&marks, &item->commit, i);
+        if (ret == RELEASY_SUCCESS && git_revwalk_push(walker, &item->commit) != 0) {
+            ret = CHANGELOG_ERR_GIT_WALK_FAILED;
+        }
+    }
+    if (ret == RELEASY_SUCCESS) {
+        ret = release_entries_init(entries, collectors, &versions, repo, &log->arena);
+    }
+
+    commit_cache_t cache_storage;
+    commit_cache_t *cache = NULL;
+    if (ret == RELEASY_SUCCESS && log->walk.use_cache &&
+        commit_cache_open(&cache_storage, repo) == RELEASY_SUCCESS) {
+        cache = &cache_storage;
+    }
+
+    // Releases of one package: commits elsewhere in the tree still carry the
+    // marks down, they just stay out of the entries
+    char path[PATH_MAX] = "";
+    const char *requested = log->walk.path ? log->walk.path : "";
+    if (ret == RELEASY_SUCCESS) ret = normalize_walk_path(requested, path, sizeof(path));
+    commit_graph_t graph_storage;
+    commit_graph_t *graph = NULL;
+    if (path[0] && commit_graph_open(&graph_storage, repo) == RELEASY_SUCCESS) graph = &graph_storage;
+    path_filter_t filter = { path, graph, NULL, 0 };
+    path_scope_t scope = { NULL, NULL };
+    if (ret == RELEASY_SUCCESS) ret = path_filter_init(&filter, &scope);
+
+    if (ret == RELEASY_SUCCESS) {
+        walk_authors_t authors = { &log->authors, PTHREAD_MUTEX_INITIALIZER };
+        ret = walk_releases(repo, walker, &marks, collectors, cache, &authors, path[0] ? &scope : NULL);
+        pthread_mutex_destroy(&authors.lock);
+    }
+    if (cache) {
+        commit_cache_save(cache, repo);
+        commit_cache_close(cache);
+    }
+    path_filter_cleanup(&filter, &scope);
+    if (graph) commit_graph_close(graph);
+
+    // Newest release first, the way changelog_write() lays them out
+    for (size_t i = versions.count; ret == RELEASY_SUCCESS && i-- > 0;) {
+        log->entries[log->count++] = entries[i];
+        entries[i] = NULL;
+    }
+    for (size_t i = 0; entries && i < versions.count; i++) {
+        if (!entries[i]) continue;
+        changelog_free_entry(entries[i]);
+        free(entries[i]);
+    }
+
+    free(marks.slots);
+    if (walker) git_revwalk_free(walker);
+    free(collectors);
+    free(entries);
+    version_list_cleanup(&versions);
+    return ret;
+}
+
+/*
+ * Render stage of the streaming pipeline. Ungrouped lines go straight to the
+ * changelog; grouped lines are spooled to one temporary file per commit type
+ * and copied out in type order once the walk is done, so memory stays flat
+ * however long the range is. Every line is formatted by changelog_render.c.
+ */
+typedef struct {
+    changelog_markdown_t *out;
+    int group_by_type;
+    int include_authors;
+    FILE *spools[COMMIT_TYPE_UNKNOWN];                  // Hold the unlinked files open
+    changelog_markdown_t *groups[COMMIT_TYPE_UNKNOWN];  // Write to them
+    author_table_t *authors;    // Set when the entry credits its contributors
+    size_t *credits;            // Commits per author id
+    size_t credits_capacity;
+} changelog_renderer_t;
+
+// The walk has interned the author into the log's table already
+static int credit_author(changelog_renderer_t *renderer, const commit_info_t *commit) {
+    uint32_t id = commit->author_id;
+    if (!renderer->authors || id == AUTHOR_NONE) return RELEASY_SUCCESS;
+
+    if (id >= renderer->credits_capacity) {
+        size_t capacity = renderer->credits_capacity ? renderer->credits_capacity * 2 : 64;
+        while (capacity <= id) capacity *= 2;
+        size_t *credits = realloc(renderer->credits, capacity * sizeof(size_t));
+        if (!credits) return CHANGELOG_ERR_MEMORY;
+        memset(credits + renderer->credits_capacity, 0,
+               (capacity - renderer->credits_capacity) * sizeof(size_t));
+        renderer->credits = credits;
+        renderer->credits_capacity = capacity;
+    }
+    renderer->credits[id]++;
+    return RELEASY_SUCCESS;
+}
+
+static int render_commit(const commit_info_t *commit, void *payload) {
+    changelog_renderer_t *renderer = payload;
+
+    if (!renderer->group_by_type) {
+        int ret = credit_author(renderer, commit);
+        if (ret == RELEASY_SUCCESS) changelog_markdown_commit(renderer->out, commit);
+        return ret;
+    }
+
+    // Same as the batch writer: commits without a known type are left out
+    if (commit->type >= COMMIT_TYPE_UNKNOWN) return RELEASY_SUCCESS;
+
+    int ret = credit_author(renderer, commit);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    changelog_markdown_t **group = &renderer->groups[commit->type];
+    if (!*group) {
+        FILE *spool = tmpfile();
+        if (!spool) return CHANGELOG_ERR_FILE_ACCESS;
+        *group = changelog_markdown_open(fileno(spool), 1, renderer->include_authors);
+        if (!*group) {
+            fclose(spool);
+            return CHANGELOG_ERR_MEMORY;
+        }
+        renderer->spools[commit->type] = spool;
+    }
+    changelog_markdown_commit(*group, commit);
+    return RELEASY_SUCCESS;
+}
+
+// The counts kept during the walk, in the order the model sorts them
+static int render_contributors(changelog_renderer_t *renderer) {
+    size_t count = 0;
+    for (size_t id = 1; id < renderer->credits_capacity; id++) {
+        if (renderer->credits[id]) count++;
+    }
+    if (!count) return RELEASY_SUCCESS;
+
+    changelog_contributor_t *contributors = malloc(count * sizeof(changelog_contributor_t));
+    if (!contributors) return CHANGELOG_ERR_MEMORY;
+    count = 0;
+    for (size_t id = 1; id < renderer->credits_capacity; id++) {
+        if (!renderer->credits[id]) continue;
+        contributors[count].author = (uint32_t)id;
+        contributors[count].signature = author_table_get(renderer->authors, (uint32_t)id)->signature;
+        contributors[count].commits = renderer->credits[id];
+        count++;
+    }
+    changelog_contributors_sort(contributors, count);
+    changelog_markdown_contributors(renderer->out, contributors, count);
+    free(contributors);
+    return RELEASY_SUCCESS;
+}
+
+// Copies a spool, written through its own writer, into the changelog
+static int copy_spool(changelog_markdown_t *out, int fd) {
+    char buffer[8192];
+    if (lseek(fd, 0, SEEK_SET) != 0) return CHANGELOG_ERR_FILE_ACCESS;
+    for (;;) {
+        ssize_t bytes = read(fd, buffer, sizeof(buffer));
+        if (bytes == 0) return RELEASY_SUCCESS;
+        if (bytes < 0) {
+            if (errno == EINTR) continue;
+            return CHANGELOG_ERR_FILE_ACCESS;
+        }
+        changelog_markdown_text(out, buffer, (size_t)bytes);
+    }
+}
+
+static int render_finish(changelog_renderer_t *renderer) {
+    int ret = RELEASY_SUCCESS;
+
+    for (int type = 0; type < COMMIT_TYPE_UNKNOWN; type++) {
+        if (!renderer->groups[type]) continue;
+
+        int closed = changelog_markdown_close(renderer->groups[type]);
+        if (ret == RELEASY_SUCCESS) ret = closed;
+        if (ret == RELEASY_SUCCESS) {
+            changelog_markdown_type(renderer->out, (commit_type_t)type);
+            ret = copy_spool(renderer->out, fileno(renderer->spools[type]));
+        }
+        fclose(renderer->spools[type]);
+        renderer->groups[type] = NULL;
+        renderer->spools[type] = NULL;
+    }
+
+    if (ret == RELEASY_SUCCESS) ret = render_contributors(renderer);
+    free(renderer->credits);
+    renderer->credits = NULL;
+
+    changelog_markdown_text(renderer->out, "\n", 1);
+    int flushed = changelog_markdown_flush(renderer->out);
+    return ret == RELEASY_SUCCESS ? flushed : ret;
+}
+
+int changelog_generate_stream(changelog_t *log, git_repository *repo, const char *version) {
+    version = release_version(version);
+    int ret = validate_generate(log, repo, version);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    char *date = current_date();
+    if (!date) return CHANGELOG_ERR_MEMORY;
+    char *previous = find_previous_version(repo, version);
+
+    const char **versions = malloc((log->count + 1) * sizeof(char *));
+    if (!versions) {
+        free(previous);
+        free(date);
+        return CHANGELOG_ERR_MEMORY;
+    }
+    for (size_t i = 0; i < log->count; i++) {
+        versions[i] = log->entries[i]->version;
+    }
+    versions[log->count] = version;
+
+    changelog_splice_t splice;
+    ret = splice_begin(log, &splice);
+    if (ret != RELEASY_SUCCESS) {
+        free(versions);
+        free(previous);
+        free(date);
+        return ret;
+    }
+
+    changelog_renderer_t renderer = {0};
+    renderer.out = splice.out;
+    renderer.group_by_type = log->group_by_type;
+    renderer.include_authors = log->include_authors;
+    renderer.authors = log->include_contributors ? &log->authors : NULL;
+
+    // Entries already held in memory keep their place ahead of the new one
+    changelog_model_t model;
+    ret = changelog_model_build(&model, log, log->entries, log->count);
+    if (ret == RELEASY_SUCCESS) {
+        ret = splice_render(&splice, &model);
+        changelog_model_free(&model);
+    }
+    if (ret != RELEASY_SUCCESS) {
+        splice_abort(&splice);
+        free(versions);
+        free(previous);
+        free(date);
+        return ret;
+    }
+
+    changelog_markdown_entry(renderer.out, version, date);
+    ret = walk_range(repo, previous, NULL, &log->walk, &log->authors, render_commit, &renderer);
+    int finish = render_finish(&renderer);
+    if (ret == RELEASY_SUCCESS) ret = finish;
+
+    // A failed walk leaves the old changelog untouched
+    if (ret == RELEASY_SUCCESS) {
+        ret = splice_finish(&splice, versions, log->count + 1);
+    } else {
+        splice_abort(&splice);
+    }
+
+    free(versions);
+    free(previous);
+    free(date);
+    return ret;
+}
+
 int changelog_free_commit(commit_info_t *commit) {
     if (!commit) return RELEASY_SUCCESS;
     
@@ -495,7 +2258,6 @@ int changelog_free_commit(commit_info_t *commit) {
     free(commit->footer);
     free(commit->commit_hash);
     free(commit->author);
-    free(commit->date);
     
     memset(commit, 0, sizeof(commit_info_t));
     return RELEASY_SUCCESS;
@@ -504,13 +2266,14 @@ int changelog_free_commit(commit_info_t *commit) {
 int changelog_free_entry(changelog_entry_t *entry) {
     if (!entry) return RELEASY_SUCCESS;
     
-    if (entry->commits) {
+    // Pooled commits go away with the changelog arena
+    if (entry->commits && !entry->pooled) {
         for (size_t i = 0; i < entry->count; i++) {
             changelog_free_commit(entry->commits[i]);
             free(entry->commits[i]);
         }
-        free(entry->commits);
     }
+    free(entry->commits);
     
     free(entry->version);
     free(entry->previous_version);
@@ -531,6 +2294,8 @@ void changelog_cleanup(changelog_t *log) {
         free(log->entries);
     }
     
+    arena_cleanup(&log->arena);
+    author_table_cleanup(&log->authors);
     free(log->file_path);
     memset(log, 0, sizeof(changelog_t));
 }
@@ -563,6 +2328,8 @@ const char *changelog_error_string(int error_code) {
             return "Invalid changelog configuration";
         case CHANGELOG_ERR_INVALID_VERSION:
             return "Invalid version tag format";
+        case CHANGELOG_ERR_SECTION_NOT_FOUND:
+            return "Version not found in changelog";
         default:
             return "Unknown error";
     }
@@ -0,0 +1,402 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+#include "changelog.h"
+#include "changelog_backup.h"
+#include "hash.h"
+
+// One backup found beside the changelog
+typedef struct {
+    char *name;
+    const char *stamp;  // Inside name
+    uint64_t hash;
+    int has_hash;       // Not set for backups from before content hashes
+} backup_file_t;
+
+typedef struct {
+    backup_file_t *files;
+    size_t count;
+    size_t capacity;
+} backup_list_t;
+
+// The changelog's content, mapped once for hashing and copying
+typedef struct {
+    int fd;
+    const char *data;
+    size_t size;
+    mode_t mode;
+} backup_source_t;
+
+static int source_open(backup_source_t *source, const char *path) {
+    memset(source, 0, sizeof(backup_source_t));
+    source->fd = open(path, O_RDONLY);
+    if (source->fd < 0) return CHANGELOG_ERR_FILE_ACCESS;
+
+    struct stat st;
+    if (fstat(source->fd, &st) != 0) {
+        close(source->fd);
+        return CHANGELOG_ERR_FILE_ACCESS;
+    }
+    source->size = (size_t)st.st_size;
+    source->mode = st.st_mode & 07777;
+    if (source->size == 0) return RELEASY_SUCCESS;
+
+    void *map = mmap(NULL, source->size, PROT_READ, MAP_PRIVATE, source->fd, 0);
+    if (map == MAP_FAILED) {
+        close(source->fd);
+        return CHANGELOG_ERR_FILE_ACCESS;
+    }
+    source->data = map;
+    return RELEASY_SUCCESS;
+}
+
+static void source_close(backup_source_t *source) {
+    if (source->data) munmap((void *)source->data, source->size);
+    if (source->fd >= 0) close(source->fd);
+}
+
+// "CHANGELOG.md" in "docs/CHANGELOG.md", and the directory it is in
+static char *split_path(const char *path, const char **base) {
+    const char *slash = strrchr(path, '/');
+    *base = slash ? slash + 1 : path;
+    if (!slash) return strdup(".");
+    if (slash == path) return strdup("/");
+    return strndup(path, (size_t)(slash - path));
+}
+
+static int is_stamp(const char *s) {
+    for (int i = 0; i < CHANGELOG_BACKUP_STAMP_LENGTH; i++) {
+        if (i == 8 ? s[i] != '_' : !isdigit((unsigned char)s[i])) return 0;
+    }
+    return 1;
+}
+
+// <base>.<stamp>.bak, or <base>.<stamp>.<hash>.bak
+static int parse_backup_name(const char *name, const char *base, size_t base_len, backup_file_t *file) {
+    if (strncmp(name, base, base_len) != 0 || name[base_len] != '.') return 0;
+
+    const char *stamp = name + base_len + 1;
+    if (strlen(stamp) < CHANGELOG_BACKUP_STAMP_LENGTH || !is_stamp(stamp)) return 0;
+
+    const char *rest = stamp + CHANGELOG_BACKUP_STAMP_LENGTH;
+    file->has_hash = 0;
+    file->hash = 0;
+    if (strcmp(rest, CHANGELOG_BACKUP_SUFFIX) == 0) {
+        file->stamp = stamp;
+        return 1;
+    }
+
+    if (rest[0] != '.' || strlen(rest) != 1 + CHANGELOG_BACKUP_HASH_LENGTH + strlen(CHANGELOG_BACKUP_SUFFIX) ||
+        strcmp(rest + 1 + CHANGELOG_BACKUP_HASH_LENGTH, CHANGELOG_BACKUP_SUFFIX) != 0) {
+        return 0;
+    }
+    for (int i = 1; i <= CHANGELOG_BACKUP_HASH_LENGTH; i++) {
+        if (!isxdigit((unsigned char)rest[i])) return 0;
+    }
+    file->stamp = stamp;
+    file->hash = strtoull(rest + 1, NULL, 16);
+    file->has_hash = 1;
+    return 1;
+}
+
+static void list_free(backup_list_t *list) {
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->files[i].name);
+    }
+    free(list->files);
+    memset(list, 0, sizeof(backup_list_t));
+}
+
+// Newest first; the stamp is fixed width, so it sorts as text
+static int compare_backup(const void *a, const void *b) {
+    const backup_file_t *x = a, *y = b;
+    int cmp = strncmp(y->stamp, x->stamp, CHANGELOG_BACKUP_STAMP_LENGTH);
+    return cmp ? cmp : strcmp(y->name, x->name);
+}
+
+static int list_backups(const char *dir, const char *base, backup_list_t *list) {
+    memset(list, 0, sizeof(backup_list_t));
+    DIR *d = opendir(dir);
+    if (!d) return CHANGELOG_ERR_FILE_ACCESS;
+
+    size_t base_len = strlen(base);
+    int ret = RELEASY_SUCCESS;
+    struct dirent *entry;
+    while (ret == RELEASY_SUCCESS && (entry = readdir(d)) != NULL) {
+        backup_file_t file;
+        if (!parse_backup_name(entry->d_name, base, base_len, &file)) continue;
+
+        if (list->count == list->capacity) {
+            size_t capacity = list->capacity ? list->capacity * 2 : 16;
+            backup_file_t *files = realloc(list->files, capacity * sizeof(backup_file_t));
+            if (!files) {
+                ret = CHANGELOG_ERR_MEMORY;
+                break;
+            }
+            list->files = files;
+            list->capacity = capacity;
+        }
+
+        file.name = strdup(entry->d_name);
+        if (!file.name) {
+            ret = CHANGELOG_ERR_MEMORY;
+            break;
+        }
+        file.stamp = file.name + (file.stamp - entry->d_name);
+        list->files[list->count++] = file;
+    }
+    closedir(d);
+
+    if (ret != RELEASY_SUCCESS) {
+        list_free(list);
+        return ret;
+    }
+    if (list->count > 1) qsort(list->files, list->count, sizeof(backup_file_t), compare_backup);
+    return RELEASY_SUCCESS;
+}
+
+static char *join_path(const char *dir, const char *name) {
+    size_t len = strlen(dir) + strlen(name) + 2;
+    char *path = malloc(len);
+    if (path) snprintf(path, len, "%s/%s", dir, name);
+    return path;
+}
+
+// A matching hash is only a hint; the bytes decide
+static int same_content(const char *path, const backup_source_t *source) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    int same = fstat(fd, &st) == 0 && (size_t)st.st_size == source->size;
+    if (same && source->size > 0) {
+        void *map = mmap(NULL, source->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        same = map != MAP_FAILED && memcmp(map, source->data, source->size) == 0;
+        if (map != MAP_FAILED) munmap(map, source->size);
+    }
+    close(fd);
+    return same;
+}
+
+/*
+ * Fills dst with the changelog as cheaply as the filesystem allows: a
+ * reflink shares its extents outright, copy_file_range() keeps the bytes in
+ * the kernel (and lets NFS or XFS copy server side), and anything left is
+ * written from the mapping.
+ */
+static int copy_content(const backup_source_t *source, int dst, changelog_backup_method_t *method) {
+#ifdef FICLONE
+    if (ioctl(dst, FICLONE, source->fd) == 0) {
+        *method = CHANGELOG_BACKUP_CLONED;
+        return RELEASY_SUCCESS;
+    }
+#endif
+
+    size_t done = 0;
+    *method = CHANGELOG_BACKUP_COPIED;
+#ifdef __linux__
+    loff_t in = 0, out = 0;
+    while (done < source->size) {
+        ssize_t n = copy_file_range(source->fd, &in, dst, &out, source->size - done, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += (size_t)n;
+    }
+    if (done > 0 || source->size == 0) *method = CHANGELOG_BACKUP_COPY_RANGE;
+#endif
+
+    while (done < source->size) {
+        ssize_t n = pwrite(dst, source->data + done, source->size - done, (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return CHANGELOG_ERR_BACKUP_FAILED;
+        done += (size_t)n;
+    }
+    return RELEASY_SUCCESS;
+}
+
+// Copies into a temp file and renames it into place, so a backup name
+// always holds the content its hash says
+static int write_backup(const backup_source_t *source, const char *backup_path,
+                        changelog_backup_method_t *method) {
+    size_t len = strlen(backup_path) + sizeof(".XXXXXX");
+    char *tmp_path = malloc(len);
+    if (!tmp_path) return CHANGELOG_ERR_MEMORY;
+    snprintf(tmp_path, len, "%s.XXXXXX", backup_path);
+
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        free(tmp_path);
+        return CHANGELOG_ERR_BACKUP_FAILED;
+    }
+
+    int ret = copy_content(source, fd, method);
+    if (ret == RELEASY_SUCCESS && fchmod(fd, source->mode) != 0) ret = CHANGELOG_ERR_BACKUP_FAILED;
+    if (close(fd) != 0 && ret == RELEASY_SUCCESS) ret = CHANGELOG_ERR_BACKUP_FAILED;
+    if (ret == RELEASY_SUCCESS && rename(tmp_path, backup_path) != 0) ret = CHANGELOG_ERR_BACKUP_FAILED;
+    if (ret != RELEASY_SUCCESS) unlink(tmp_path);
+
+    free(tmp_path);
+    return ret;
+}
+
+static time_t stamp_time(const char *stamp) {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    if (sscanf(stamp, "%4d%2d%2d_%2d%2d%2d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+               &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6) {
+        return (time_t)-1;
+    }
+    tm.tm_year -= 1900;
+    tm.tm_mon -= 1;
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+static int prune_list(const char *dir, const backup_list_t *list, const changelog_backup_policy_t *policy,
+                      time_t now, size_t *removed) {
+    size_t count = 0;
+    int ret = RELEASY_SUCCESS;
+
+    // The newest stays whatever the policy says
+    for (size_t i = 1; i < list->count; i++) {
+        const backup_file_t *file = &list->files[i];
+        int drop = policy->keep && i >= policy->keep;
+        if (!drop && policy->max_age > 0) {
+            time_t when = stamp_time(file->stamp);
+            drop = when != (time_t)-1 && (int64_t)(now - when) > policy->max_age;
+        }
+        if (!drop) continue;
+
+        char *path = join_path(dir, file->name);
+        if (!path) {
+            ret = CHANGELOG_ERR_MEMORY;
+            break;
+        }
+        if (unlink(path) == 0) {
+            count++;
+        } else if (errno != ENOENT) {
+            ret = CHANGELOG_ERR_BACKUP_FAILED;
+        }
+        free(path);
+    }
+
+    if (removed) *removed = count;
+    return ret;
+}
+
+int changelog_backup_prune(const char *path, const changelog_backup_policy_t *policy,
+                           time_t now, size_t *removed) {
+    if (removed) *removed = 0;
+    if (!path || !policy || policy->max_age < 0) return CHANGELOG_ERR_INVALID_CONFIG;
+
+    const char *base;
+    char *dir = split_path(path, &base);
+    if (!dir) return CHANGELOG_ERR_MEMORY;
+
+    backup_list_t list;
+    int ret = list_backups(dir, base, &list);
+    if (ret == RELEASY_SUCCESS) {
+        ret = prune_list(dir, &list, policy, now, removed);
+        list_free(&list);
+    }
+    free(dir);
+    return ret;
+}
+
+/*
+ * The backup is named for the time and its content hash. An older backup
+ * with the same hash and the same bytes is hard linked under the new name
+ * instead of copied, so a changelog that did not change between releases
+ * costs a directory entry rather than another few megabytes.
+ */
+int changelog_backup(const char *path, const changelog_backup_policy_t *policy,
+                     changelog_backup_result_t *result) {
+    if (result) memset(result, 0, sizeof(changelog_backup_result_t));
+    if (!path || !policy || policy->max_age < 0) return CHANGELOG_ERR_INVALID_CONFIG;
+
+    backup_source_t source;
+    int ret = source_open(&source, path);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    const char *base;
+    char *dir = split_path(path, &base);
+    char *backup_path = NULL;
+    backup_list_t list = {0};
+    changelog_backup_method_t method = CHANGELOG_BACKUP_COPIED;
+    if (!dir) ret = CHANGELOG_ERR_MEMORY;
+    if (ret == RELEASY_SUCCESS) ret = list_backups(dir, base, &list);
+
+    time_t now = time(NULL);
+    uint64_t hash = hash_fnv1a(HASH_FNV1A_INIT, source.data, source.size);
+    if (ret == RELEASY_SUCCESS) {
+        struct tm tm;
+        char stamp[32];
+        localtime_r(&now, &tm);
+        strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm);
+
+        size_t len = strlen(path) + strlen(stamp) + CHANGELOG_BACKUP_HASH_LENGTH +
+                     strlen(CHANGELOG_BACKUP_SUFFIX) + 3;
+        backup_path = malloc(len);
+        if (!backup_path) ret = CHANGELOG_ERR_MEMORY;
+        else snprintf(backup_path, len, "%s.%s.%016llx%s", path, stamp,
+                      (unsigned long long)hash, CHANGELOG_BACKUP_SUFFIX);
+    }
+
+    int saved = 0;
+    for (size_t i = 0; ret == RELEASY_SUCCESS && !saved && i < list.count; i++) {
+        const backup_file_t *file = &list.files[i];
+        if (!file->has_hash || file->hash != hash) continue;
+
+        char *match = join_path(dir, file->name);
+        if (!match) {
+            ret = CHANGELOG_ERR_MEMORY;
+            break;
+        }
+        if (same_content(match, &source)) {
+            if (strcmp(match, backup_path) == 0) {
+                method = CHANGELOG_BACKUP_EXISTING;
+                saved = 1;
+            } else if (link(match, backup_path) == 0 || errno == EEXIST) {
+                method = CHANGELOG_BACKUP_LINKED;
+                saved = 1;
+            }
+        }
+        free(match);
+    }
+    if (ret == RELEASY_SUCCESS && !saved) ret = write_backup(&source, backup_path, &method);
+    source_close(&source);
+
+    // The listing predates the new backup, so it is listed again. Pruning
+    // is housekeeping: a backup that was made is not failed by it.
+    size_t removed = 0;
+    if (ret == RELEASY_SUCCESS) changelog_backup_prune(path, policy, now, &removed);
+
+    list_free(&list);
+    free(dir);
+    if (ret == RELEASY_SUCCESS && result) {
+        result->path = backup_path;
+        result->method = method;
+        result->removed = removed;
+    } else {
+        free(backup_path);
+    }
+    return ret;
+}
+
+void changelog_backup_result_free(changelog_backup_result_t *result) {
+    if (!result) return;
+    free(result->path);
+    memset(result, 0, sizeof(changelog_backup_result_t));
+}
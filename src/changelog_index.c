@@ -0,0 +1,300 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "changelog_index.h"
+#include "hash.h"
+#include "sidecar.h"
+
+// Sidecars are a few entries per release; anything past this is not ours
+#define CHANGELOG_INDEX_MAX_ENTRIES (1024 * 1024)
+
+static int compare_name(const char *a, size_t a_len, const char *b, size_t b_len) {
+    int cmp = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (cmp) return cmp;
+    return a_len < b_len ? -1 : a_len > b_len;
+}
+
+// "v1.2.0" and "1.2.0" name the same section
+static const char *skip_v(const char *version, size_t *len) {
+    if (*len > 0 && (version[0] == 'v' || version[0] == 'V')) {
+        (*len)--;
+        return version + 1;
+    }
+    return version;
+}
+
+typedef struct {
+    const char *name;
+    changelog_index_entry_t entry;
+    size_t seq;
+} scanned_section_t;
+
+// By version, then file order, so the first of two same-named sections wins
+static int compare_scanned(const void *a, const void *b) {
+    const scanned_section_t *x = a, *y = b;
+    int cmp = compare_name(x->name, x->entry.name_length, y->name, y->entry.name_length);
+    if (cmp) return cmp;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+/*
+ * One pass over the mapping. A section runs from its "## [version]" line up
+ * to the next "## " line of any kind, the same boundary the incremental
+ * writer uses when it replaces a section.
+ */
+static int scan_sections(changelog_index_t *index) {
+    scanned_section_t *sections = NULL;
+    size_t count = 0, capacity = 0, names_size = 0;
+    scanned_section_t *open_section = NULL;
+
+    const char *data = index->data, *end = index->data + index->size;
+    for (const char *line = data; line < end;) {
+        const char *eol = memchr(line, '\n', (size_t)(end - line));
+        const char *next = eol ? eol + 1 : end;
+        size_t len = (size_t)(next - line);
+
+        if (len >= 3 && memcmp(line, "## ", 3) == 0) {
+            if (open_section) {
+                open_section->entry.end = (uint64_t)(line - data);
+                open_section = NULL;
+            }
+
+            const char *close = len > 4 && line[3] == '[' ? memchr(line + 4, ']', len - 4) : NULL;
+            if (close) {
+                if (count == capacity) {
+                    capacity = capacity ? capacity * 2 : 64;
+                    scanned_section_t *grown = realloc(sections, capacity * sizeof(scanned_section_t));
+                    if (!grown || capacity > CHANGELOG_INDEX_MAX_ENTRIES) {
+                        free(grown ? grown : sections);
+                        return CHANGELOG_ERR_MEMORY;
+                    }
+                    sections = grown;
+                }
+
+                size_t name_length = (size_t)(close - (line + 4));
+                open_section = &sections[count];
+                open_section->name = skip_v(line + 4, &name_length);
+                open_section->entry.start = (uint64_t)(line - data);
+                open_section->entry.end = (uint64_t)index->size;
+                open_section->entry.name_length = (uint32_t)name_length;
+                open_section->seq = count++;
+            }
+        }
+        line = next;
+    }
+
+    if (count > 1) qsort(sections, count, sizeof(scanned_section_t), compare_scanned);
+
+    // A version written twice is looked up by its first section only
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (kept && compare_name(sections[kept - 1].name, sections[kept - 1].entry.name_length,
+                                 sections[i].name, sections[i].entry.name_length) == 0) {
+            continue;
+        }
+        sections[kept++] = sections[i];
+        names_size += sections[i].entry.name_length + 1;
+    }
+
+    index->built = malloc((kept ? kept : 1) * sizeof(changelog_index_entry_t));
+    index->built_names = malloc(names_size ? names_size : 1);
+    if (!index->built || !index->built_names) {
+        free(sections);
+        return CHANGELOG_ERR_MEMORY;
+    }
+
+    uint32_t offset = 0;
+    for (size_t i = 0; i < kept; i++) {
+        changelog_index_entry_t *entry = &index->built[i];
+        *entry = sections[i].entry;
+        entry->name_offset = offset;
+        memcpy(index->built_names + offset, sections[i].name, entry->name_length);
+        index->built_names[offset + entry->name_length] = '\0';
+        offset += entry->name_length + 1;
+    }
+    free(sections);
+
+    index->entries = index->built;
+    index->names = index->built_names;
+    index->count = kept;
+    return RELEASY_SUCCESS;
+}
+
+static int mtime_before(const struct stat *older, const struct stat *newer) {
+    if (older->st_mtim.tv_sec != newer->st_mtim.tv_sec) {
+        return older->st_mtim.tv_sec < newer->st_mtim.tv_sec;
+    }
+    return older->st_mtim.tv_nsec < newer->st_mtim.tv_nsec;
+}
+
+static uint64_t names_size_of(const changelog_index_t *index) {
+    if (!index->count) return 0;
+    const changelog_index_entry_t *last = &index->entries[index->count - 1];
+    return (uint64_t)last->name_offset + last->name_length + 1;
+}
+
+/*
+ * Uses the sidecar only when it was built from a changelog of this size and
+ * mtime. A changelog rewritten within the sidecar's own clock tick could
+ * keep both, so its mtime must be strictly older than the sidecar's.
+ */
+static int load_sidecar(changelog_index_t *index, const char *cache_path, const struct stat *source) {
+    void *map = NULL;
+    size_t size = 0;
+    struct stat st;
+    if (sidecar_map(cache_path, sizeof(changelog_index_header_t), &map, &size, &st) != RELEASY_SUCCESS) return 0;
+    if (!mtime_before(source, &st)) {
+        munmap(map, size);
+        return 0;
+    }
+
+    const changelog_index_header_t *header = map;
+    int valid = memcmp(header->magic, CHANGELOG_INDEX_MAGIC, sizeof(header->magic)) == 0 &&
+                header->format == CHANGELOG_INDEX_FORMAT &&
+                header->byte_order == SIDECAR_BYTE_ORDER &&
+                header->entry_size == sizeof(changelog_index_entry_t) &&
+                header->count <= CHANGELOG_INDEX_MAX_ENTRIES &&
+                header->source_size == (int64_t)source->st_size &&
+                header->source_mtime_sec == (int64_t)source->st_mtim.tv_sec &&
+                header->source_mtime_nsec == (int64_t)source->st_mtim.tv_nsec &&
+                sizeof(changelog_index_header_t) + (uint64_t)header->count * sizeof(changelog_index_entry_t) +
+                    header->names_size == (uint64_t)size;
+
+    const changelog_index_entry_t *entries = (const changelog_index_entry_t *)(header + 1);
+    for (uint32_t i = 0; valid && i < header->count; i++) {
+        valid = entries[i].start <= entries[i].end && entries[i].end <= (uint64_t)source->st_size &&
+                (uint64_t)entries[i].name_offset + entries[i].name_length < header->names_size;
+    }
+    if (!valid) {
+        munmap(map, size);
+        return 0;
+    }
+
+    index->sidecar = map;
+    index->sidecar_size = size;
+    index->entries = entries;
+    index->count = header->count;
+    index->names = (const char *)(entries + header->count);
+    index->from_cache = 1;
+    return 1;
+}
+
+static int write_sidecar(FILE *f, const changelog_index_t *index, const struct stat *source) {
+    changelog_index_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHANGELOG_INDEX_MAGIC, sizeof(header.magic));
+    header.format = CHANGELOG_INDEX_FORMAT;
+    header.byte_order = SIDECAR_BYTE_ORDER;
+    header.entry_size = sizeof(changelog_index_entry_t);
+    header.count = (uint32_t)index->count;
+    header.names_size = names_size_of(index);
+    header.source_size = (int64_t)source->st_size;
+    header.source_mtime_sec = (int64_t)source->st_mtim.tv_sec;
+    header.source_mtime_nsec = (int64_t)source->st_mtim.tv_nsec;
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && index->count) {
+        ok = fwrite(index->entries, sizeof(changelog_index_entry_t), index->count, f) == index->count &&
+             fwrite(index->names, 1, header.names_size, f) == header.names_size;
+    }
+    return ok;
+}
+
+// Failing to save is not an error, the next run scans again
+static void save_sidecar(const changelog_index_t *index, const char *cache_path, const struct stat *source) {
+    sidecar_writer_t writer;
+    if (sidecar_begin(&writer, cache_path) == RELEASY_SUCCESS) {
+        sidecar_commit(&writer, write_sidecar(writer.file, index, source));
+    }
+}
+
+int changelog_index_open(changelog_index_t *index, const char *changelog_path, const char *cache_path) {
+    if (!index) return RELEASY_ERROR;
+    memset(index, 0, sizeof(changelog_index_t));
+    if (!changelog_path) return CHANGELOG_ERR_INVALID_PATH;
+
+    int fd = open(changelog_path, O_RDONLY);
+    if (fd < 0) return CHANGELOG_ERR_FILE_ACCESS;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return CHANGELOG_ERR_FILE_ACCESS;
+    }
+    if (st.st_size > 0) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            close(fd);
+            return CHANGELOG_ERR_FILE_ACCESS;
+        }
+        index->data = map;
+        index->size = (size_t)st.st_size;
+    }
+    close(fd);
+
+    if (cache_path && load_sidecar(index, cache_path, &st)) return RELEASY_SUCCESS;
+
+    int ret = scan_sections(index);
+    if (ret != RELEASY_SUCCESS) {
+        changelog_index_close(index);
+        return ret;
+    }
+    if (cache_path) save_sidecar(index, cache_path, &st);
+    return RELEASY_SUCCESS;
+}
+
+int changelog_index_find(const changelog_index_t *index, const char *version,
+                         const char **section, size_t *length) {
+    if (!index || !version || !section || !length) return RELEASY_ERROR;
+
+    size_t version_len = strlen(version);
+    version = skip_v(version, &version_len);
+
+    size_t lo = 0, hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const changelog_index_entry_t *entry = &index->entries[mid];
+        int cmp = compare_name(index->names + entry->name_offset, entry->name_length, version, version_len);
+        if (cmp == 0) {
+            *section = index->data + entry->start;
+            *length = (size_t)(entry->end - entry->start);
+            return RELEASY_SUCCESS;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return CHANGELOG_ERR_SECTION_NOT_FOUND;
+}
+
+void changelog_index_close(changelog_index_t *index) {
+    if (!index) return;
+
+    if (index->data) munmap((void *)index->data, index->size);
+    if (index->sidecar) munmap(index->sidecar, index->sidecar_size);
+    free(index->built);
+    free(index->built_names);
+    memset(index, 0, sizeof(changelog_index_t));
+}
+
+char *changelog_index_cache_path(const char *git_dir, const char *changelog_path) {
+    if (!git_dir || !changelog_path) return NULL;
+
+    // The same changelog reached by another relative path shares its sidecar
+    char resolved[PATH_MAX];
+    const char *key = realpath(changelog_path, resolved) ? resolved : changelog_path;
+    uint64_t hash = hash_fnv1a(HASH_FNV1A_INIT, key, strlen(key));
+
+    char name[40];
+    snprintf(name, sizeof(name), "changelog-%016llx.idx", (unsigned long long)hash);
+    return sidecar_path(git_dir, name);
+}
@@ -0,0 +1,706 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "changelog_render.h"
+#include "date_cache.h"
+
+/*
+ * Output goes through one large buffer. Short pieces are copied into it,
+ * long strings are pointed at where they already are, and the lot is
+ * handed to writev() once the buffer or the iovec array fills up.
+ */
+typedef struct {
+    int fd;
+    char *buf;
+    size_t capacity;
+    size_t used;
+    struct iovec iov[CHANGELOG_RENDER_IOVECS];
+    int iovcnt;
+    int borrow;             // Long strings outlive the next flush
+    int failed;
+    date_cache_t dates;     // Commit days, formatted once each
+} render_out_t;
+
+static void out_flush(render_out_t *out) {
+    struct iovec *iov = out->iov;
+    int count = out->iovcnt;
+    while (!out->failed && count > 0) {
+        ssize_t written = writev(out->fd, iov, count);
+        if (written < 0) {
+            if (errno != EINTR) out->failed = 1;
+            continue;
+        }
+        // Nothing written with something left to write will not get better
+        if (written == 0) {
+            out->failed = 1;
+            break;
+        }
+        // Short write: skip what went out and go again
+        size_t left = (size_t)written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    out->iovcnt = 0;
+    out->used = 0;
+}
+
+// Adjacent pieces of the buffer share an iovec
+static void out_iov(render_out_t *out, const char *ptr, size_t len) {
+    if (out->iovcnt > 0) {
+        struct iovec *last = &out->iov[out->iovcnt - 1];
+        if ((const char *)last->iov_base + last->iov_len == ptr) {
+            last->iov_len += len;
+            return;
+        }
+    }
+    if (out->iovcnt == CHANGELOG_RENDER_IOVECS) out_flush(out);
+    out->iov[out->iovcnt].iov_base = (void *)ptr;
+    out->iov[out->iovcnt].iov_len = len;
+    out->iovcnt++;
+}
+
+static void out_copy(render_out_t *out, const char *data, size_t len) {
+    while (len > 0 && !out->failed) {
+        if (out->used == out->capacity || out->iovcnt == CHANGELOG_RENDER_IOVECS) {
+            out_flush(out);
+        }
+        size_t room = out->capacity - out->used;
+        size_t n = len < room ? len : room;
+        memcpy(out->buf + out->used, data, n);
+        out_iov(out, out->buf + out->used, n);
+        out->used += n;
+        data += n;
+        len -= n;
+    }
+}
+
+// Commit strings outlive a model render, so long ones are not copied
+static void out_ref(render_out_t *out, const char *data, size_t len) {
+    if (len == 0 || out->failed) return;
+    if (!out->borrow || len < CHANGELOG_RENDER_ZERO_COPY) {
+        out_copy(out, data, len);
+    } else {
+        out_iov(out, data, len);
+    }
+}
+
+static void out_str(render_out_t *out, const char *s) {
+    out_ref(out, s, strlen(s));
+}
+
+#define out_lit(out, s) out_copy((out), (s), sizeof(s) - 1)
+
+// Runs that need no escaping go out as they are
+static void out_json_string(render_out_t *out, const char *s) {
+    if (!s) {
+        out_lit(out, "null");
+        return;
+    }
+
+    out_lit(out, "\"");
+    const char *run = s;
+    for (const char *p = s; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out_ref(out, run, (size_t)(p - run));
+        run = p + 1;
+        switch (c) {
+            case '"': out_lit(out, "\\\""); break;
+            case '\\': out_lit(out, "\\\\"); break;
+            case '\n': out_lit(out, "\\n"); break;
+            case '\r': out_lit(out, "\\r"); break;
+            case '\t': out_lit(out, "\\t"); break;
+            default: {
+                char escape[8];
+                snprintf(escape, sizeof(escape), "\\u%04x", c);
+                out_copy(out, escape, 6);
+                break;
+            }
+        }
+    }
+    out_str(out, run);
+    out_lit(out, "\"");
+}
+
+static void out_html(render_out_t *out, const char *s) {
+    const char *run = s;
+    for (const char *p = s; *p; p++) {
+        const char *entity;
+        switch (*p) {
+            case '&': entity = "&amp;"; break;
+            case '<': entity = "&lt;"; break;
+            case '>': entity = "&gt;"; break;
+            case '"': entity = "&quot;"; break;
+            case '\'': entity = "&#39;"; break;
+            default: continue;
+        }
+        out_ref(out, run, (size_t)(p - run));
+        out_str(out, entity);
+        run = p + 1;
+    }
+    out_str(out, run);
+}
+
+static void out_number(render_out_t *out, size_t value) {
+    char digits[24];
+    int len = snprintf(digits, sizeof(digits), "%zu", value);
+    out_copy(out, digits, (size_t)len);
+}
+
+// " (3 commits)" after a contributor
+static void out_commit_count(render_out_t *out, size_t commits) {
+    out_lit(out, " (");
+    out_number(out, commits);
+    if (commits == 1) {
+        out_lit(out, " commit)");
+    } else {
+        out_lit(out, " commits)");
+    }
+}
+
+typedef struct {
+    const commit_info_t *commit;
+    size_t seq;
+} scoped_commit_t;
+
+// Unscoped commits first, then by scope; walk order within a scope
+static int compare_scope(const void *a, const void *b) {
+    const scoped_commit_t *x = a, *y = b;
+    const char *sx = x->commit->scope, *sy = y->commit->scope;
+    if (sx != sy) {
+        if (!sx) return -1;
+        if (!sy) return 1;
+        int cmp = strcmp(sx, sy);
+        if (cmp) return cmp;
+    }
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+static int sort_by_scope(const commit_info_t **commits, size_t count) {
+    if (count < 2) return RELEASY_SUCCESS;
+
+    scoped_commit_t *sorted = malloc(count * sizeof(scoped_commit_t));
+    if (!sorted) return CHANGELOG_ERR_MEMORY;
+    for (size_t i = 0; i < count; i++) {
+        sorted[i].commit = commits[i];
+        sorted[i].seq = i;
+    }
+    qsort(sorted, count, sizeof(scoped_commit_t), compare_scope);
+    for (size_t i = 0; i < count; i++) {
+        commits[i] = sorted[i].commit;
+    }
+    free(sorted);
+    return RELEASY_SUCCESS;
+}
+
+// A counting sort on the type; commits of unknown type land in the last
+// bucket, which grouped output leaves out
+static int buckets_build(changelog_buckets_t *buckets, const changelog_entry_t *entry,
+                         int group_by_type, int group_by_scope) {
+    memset(buckets, 0, sizeof(changelog_buckets_t));
+    buckets->commits = malloc((entry->count ? entry->count : 1) * sizeof(commit_info_t *));
+    if (!buckets->commits) return CHANGELOG_ERR_MEMORY;
+
+    if (!group_by_type) {
+        for (size_t i = 0; i < entry->count; i++) {
+            buckets->commits[i] = entry->commits[i];
+        }
+        for (int t = 1; t <= COMMIT_TYPE_UNKNOWN + 1; t++) {
+            buckets->starts[t] = entry->count;
+        }
+        return RELEASY_SUCCESS;
+    }
+
+    size_t next[COMMIT_TYPE_UNKNOWN + 1] = {0};
+    for (size_t i = 0; i < entry->count; i++) {
+        commit_type_t type = entry->commits[i]->type;
+        if (type < 0 || type > COMMIT_TYPE_UNKNOWN) type = COMMIT_TYPE_UNKNOWN;
+        buckets->starts[type + 1]++;
+    }
+    for (int t = 0; t <= COMMIT_TYPE_UNKNOWN; t++) {
+        buckets->starts[t + 1] += buckets->starts[t];
+        next[t] = buckets->starts[t];
+    }
+    for (size_t i = 0; i < entry->count; i++) {
+        commit_type_t type = entry->commits[i]->type;
+        if (type < 0 || type > COMMIT_TYPE_UNKNOWN) type = COMMIT_TYPE_UNKNOWN;
+        buckets->commits[next[type]++] = entry->commits[i];
+    }
+
+    for (int t = 0; group_by_scope && t < COMMIT_TYPE_UNKNOWN; t++) {
+        int ret = sort_by_scope(&buckets->commits[buckets->starts[t]],
+                                buckets->starts[t + 1] - buckets->starts[t]);
+        if (ret != RELEASY_SUCCESS) return ret;
+    }
+    return RELEASY_SUCCESS;
+}
+
+static int compare_contributor(const void *a, const void *b) {
+    const changelog_contributor_t *x = a, *y = b;
+    if (x->commits != y->commits) return x->commits > y->commits ? -1 : 1;
+    return strcmp(x->signature, y->signature);
+}
+
+void changelog_contributors_sort(changelog_contributor_t *contributors, size_t count) {
+    if (count > 1) qsort(contributors, count, sizeof(changelog_contributor_t), compare_contributor);
+}
+
+// Tallies the listed commits by author id in counts, which is left zeroed
+// again for the next entry
+static int count_contributors(changelog_buckets_t *buckets, int group_by_type,
+                              const author_table_t *authors, size_t *counts) {
+    size_t listed = buckets->starts[group_by_type ? COMMIT_TYPE_UNKNOWN : 1];
+    size_t distinct = 0;
+    for (size_t j = 0; j < listed; j++) {
+        uint32_t id = buckets->commits[j]->author_id;
+        if (id == AUTHOR_NONE || id > authors->count) continue;
+        if (counts[id]++ == 0) distinct++;
+    }
+    if (!distinct) return RELEASY_SUCCESS;
+
+    buckets->contributors = malloc(distinct * sizeof(changelog_contributor_t));
+    int ret = buckets->contributors ? RELEASY_SUCCESS : CHANGELOG_ERR_MEMORY;
+    for (size_t j = 0; j < listed; j++) {
+        uint32_t id = buckets->commits[j]->author_id;
+        if (id == AUTHOR_NONE || id > authors->count || !counts[id]) continue;
+        if (ret == RELEASY_SUCCESS) {
+            changelog_contributor_t *contributor = &buckets->contributors[buckets->contributor_count++];
+            contributor->author = id;
+            contributor->signature = author_table_get(authors, id)->signature;
+            contributor->commits = counts[id];
+        }
+        counts[id] = 0;
+    }
+    if (ret == RELEASY_SUCCESS) changelog_contributors_sort(buckets->contributors, buckets->contributor_count);
+    return ret;
+}
+
+int changelog_model_build(changelog_model_t *model, const changelog_t *log,
+                          changelog_entry_t *const *entries, size_t count) {
+    if (!model || !log || (count && !entries)) return RELEASY_ERROR;
+
+    memset(model, 0, sizeof(changelog_model_t));
+    model->entries = entries;
+    model->count = count;
+    model->group_by_type = log->group_by_type;
+    model->group_by_scope = log->group_by_scope;
+    model->include_metadata = log->include_metadata;
+    model->include_authors = log->include_authors;
+    model->include_contributors = log->include_contributors;
+
+    // Credits are counted by author id, one counter per interned author
+    size_t *counts = NULL;
+    if (log->include_contributors && log->authors.count) {
+        counts = calloc((size_t)log->authors.count + 1, sizeof(size_t));
+        if (!counts) return CHANGELOG_ERR_MEMORY;
+    }
+
+    model->buckets = calloc(count ? count : 1, sizeof(changelog_buckets_t));
+    int ret = model->buckets ? RELEASY_SUCCESS : CHANGELOG_ERR_MEMORY;
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < count; i++) {
+        model->count = i + 1;
+        ret = buckets_build(&model->buckets[i], entries[i], log->group_by_type, log->group_by_scope);
+        if (ret == RELEASY_SUCCESS && counts) {
+            ret = count_contributors(&model->buckets[i], log->group_by_type, &log->authors, counts);
+        }
+    }
+    model->count = count;
+
+    free(counts);
+    if (ret != RELEASY_SUCCESS) changelog_model_free(model);
+    return ret;
+}
+
+void changelog_model_free(changelog_model_t *model) {
+    if (!model) return;
+
+    for (size_t i = 0; model->buckets && i < model->count; i++) {
+        free(model->buckets[i].commits);
+        free(model->buckets[i].contributors);
+    }
+    free(model->buckets);
+    memset(model, 0, sizeof(changelog_model_t));
+}
+
+// The types a grouped entry lists, in order; ungrouped, the one bucket
+#define FOR_EACH_BUCKET(model, t) \
+    for (int t = 0; t < ((model)->group_by_type ? COMMIT_TYPE_UNKNOWN : 1); t++)
+
+static size_t bucket_size(const changelog_buckets_t *buckets, int t) {
+    return buckets->starts[t + 1] - buckets->starts[t];
+}
+
+// "## [version] - date", the line every Markdown section starts with
+static void markdown_entry(render_out_t *out, const char *version, const char *date) {
+    out_lit(out, "## [");
+    out_str(out, version);
+    out_lit(out, "]");
+    if (date) {
+        out_lit(out, " - ");
+        out_str(out, date);
+    }
+    out_lit(out, "\n");
+}
+
+static void markdown_type(render_out_t *out, commit_type_t type) {
+    out_lit(out, "\n### ");
+    out_str(out, changelog_commit_type_string(type));
+    out_lit(out, "\n\n");
+}
+
+// One bullet line; grouped lines carry the scope instead of the type
+static void markdown_commit(render_out_t *out, int grouped, int include_authors, const commit_info_t *commit) {
+    out_lit(out, "* ");
+    if (grouped) {
+        if (commit->scope) {
+            out_lit(out, "**");
+            out_str(out, commit->scope);
+            out_lit(out, ":** ");
+        }
+    } else {
+        out_str(out, changelog_commit_type_string(commit->type));
+        out_lit(out, ": ");
+    }
+    out_str(out, commit->description);
+    if (commit->is_breaking) out_lit(out, " [BREAKING]");
+    if ((grouped || include_authors) && commit->author) {
+        out_lit(out, " (");
+        out_str(out, commit->author);
+        out_lit(out, ")");
+    }
+    out_lit(out, "\n");
+}
+
+static void markdown_contributors(render_out_t *out, const changelog_contributor_t *contributors, size_t count) {
+    if (count) out_lit(out, "\n### Contributors\n\n");
+    for (size_t j = 0; j < count; j++) {
+        out_lit(out, "* ");
+        out_str(out, contributors[j].signature);
+        out_commit_count(out, contributors[j].commits);
+        out_lit(out, "\n");
+    }
+}
+
+static void render_markdown(render_out_t *out, const changelog_model_t *model) {
+    for (size_t i = 0; i < model->count; i++) {
+        const changelog_entry_t *entry = model->entries[i];
+        const changelog_buckets_t *buckets = &model->buckets[i];
+
+        markdown_entry(out, entry->version, entry->date);
+        FOR_EACH_BUCKET(model, t) {
+            if (model->group_by_type && bucket_size(buckets, t) > 0) {
+                markdown_type(out, (commit_type_t)t);
+            }
+            for (size_t j = buckets->starts[t]; j < buckets->starts[t + 1]; j++) {
+                markdown_commit(out, model->group_by_type, model->include_authors, buckets->commits[j]);
+            }
+        }
+        markdown_contributors(out, buckets->contributors, buckets->contributor_count);
+        out_lit(out, "\n");
+    }
+}
+
+struct changelog_markdown {
+    render_out_t out;
+    int group_by_type;
+    int include_authors;
+};
+
+changelog_markdown_t *changelog_markdown_open(int fd, int group_by_type, int include_authors) {
+    if (fd < 0) return NULL;
+
+    changelog_markdown_t *md = calloc(1, sizeof(changelog_markdown_t));
+    if (!md) return NULL;
+    md->out.fd = fd;
+    md->out.capacity = CHANGELOG_MARKDOWN_BUFFER;
+    md->out.buf = malloc(md->out.capacity);
+    if (!md->out.buf) {
+        free(md);
+        return NULL;
+    }
+    md->group_by_type = group_by_type;
+    md->include_authors = include_authors;
+    return md;
+}
+
+void changelog_markdown_text(changelog_markdown_t *md, const char *text, size_t len) {
+    out_copy(&md->out, text, len);
+}
+
+// The model's strings are only borrowed up to the flush at the end
+void changelog_markdown_sections(changelog_markdown_t *md, const changelog_model_t *model) {
+    md->out.borrow = 1;
+    render_markdown(&md->out, model);
+    out_flush(&md->out);
+    md->out.borrow = 0;
+}
+
+void changelog_markdown_entry(changelog_markdown_t *md, const char *version, const char *date) {
+    markdown_entry(&md->out, version, date);
+}
+
+void changelog_markdown_type(changelog_markdown_t *md, commit_type_t type) {
+    markdown_type(&md->out, type);
+}
+
+void changelog_markdown_commit(changelog_markdown_t *md, const commit_info_t *commit) {
+    markdown_commit(&md->out, md->group_by_type, md->include_authors, commit);
+}
+
+void changelog_markdown_contributors(changelog_markdown_t *md, const changelog_contributor_t *contributors,
+                                     size_t count) {
+    markdown_contributors(&md->out, contributors, count);
+}
+
+int changelog_markdown_flush(changelog_markdown_t *md) {
+    out_flush(&md->out);
+    return md->out.failed ? CHANGELOG_ERR_FILE_ACCESS : RELEASY_SUCCESS;
+}
+
+int changelog_markdown_close(changelog_markdown_t *md) {
+    if (!md) return RELEASY_SUCCESS;
+
+    int ret = changelog_markdown_flush(md);
+    free(md->out.buf);
+    free(md);
+    return ret;
+}
+
+static void json_commit(render_out_t *out, const changelog_model_t *model, const commit_info_t *commit) {
+    out_lit(out, "{\"type\":");
+    out_json_string(out, changelog_commit_type_string(commit->type));
+    out_lit(out, ",\"scope\":");
+    out_json_string(out, commit->scope);
+    out_lit(out, ",\"description\":");
+    out_json_string(out, commit->description);
+    if (commit->is_breaking) {
+        out_lit(out, ",\"breaking\":true");
+    } else {
+        out_lit(out, ",\"breaking\":false");
+    }
+    if (model->include_metadata) {
+        out_lit(out, ",\"hash\":");
+        out_json_string(out, commit->commit_hash);
+        // Dated by the author signature, like the timestamp itself
+        out_lit(out, ",\"date\":");
+        out_json_string(out, commit->author ? date_cache_day(&out->dates, commit->timestamp) : NULL);
+    }
+    if (model->include_authors) {
+        out_lit(out, ",\"author\":");
+        out_json_string(out, commit->author);
+    }
+    out_lit(out, "}");
+}
+
+static void json_commits(render_out_t *out, const changelog_model_t *model,
+                         const changelog_buckets_t *buckets, int t) {
+    out_lit(out, "[");
+    for (size_t j = buckets->starts[t]; j < buckets->starts[t + 1]; j++) {
+        if (j > buckets->starts[t]) out_lit(out, ",");
+        out_lit(out, "\n      ");
+        json_commit(out, model, buckets->commits[j]);
+    }
+    out_lit(out, "]");
+}
+
+static void render_json(render_out_t *out, const changelog_model_t *model) {
+    out_lit(out, "{\"releases\":[");
+    for (size_t i = 0; i < model->count; i++) {
+        const changelog_entry_t *entry = model->entries[i];
+        const changelog_buckets_t *buckets = &model->buckets[i];
+
+        out_str(out, i ? ",\n  {\"version\":" : "\n  {\"version\":");
+        out_json_string(out, entry->version);
+        out_lit(out, ",\"date\":");
+        out_json_string(out, entry->date);
+        out_lit(out, ",\"previous_version\":");
+        out_json_string(out, entry->previous_version);
+
+        if (model->include_contributors) {
+            out_lit(out, ",\"contributors\":[");
+            for (size_t j = 0; j < buckets->contributor_count; j++) {
+                out_str(out, j ? ",{\"author\":" : "{\"author\":");
+                out_json_string(out, buckets->contributors[j].signature);
+                out_lit(out, ",\"commits\":");
+                out_number(out, buckets->contributors[j].commits);
+                out_lit(out, "}");
+            }
+            out_lit(out, "]");
+        }
+
+        if (!model->group_by_type) {
+            out_lit(out, ",\"commits\":");
+            json_commits(out, model, buckets, 0);
+            out_lit(out, "}");
+            continue;
+        }
+
+        out_lit(out, ",\"sections\":[");
+        int first = 1;
+        FOR_EACH_BUCKET(model, t) {
+            if (bucket_size(buckets, t) == 0) continue;
+            out_str(out, first ? "\n    {\"type\":" : ",\n    {\"type\":");
+            first = 0;
+            out_json_string(out, changelog_commit_type_string((commit_type_t)t));
+            out_lit(out, ",\"commits\":");
+            json_commits(out, model, buckets, t);
+            out_lit(out, "}");
+        }
+        out_lit(out, "]}");
+    }
+    out_lit(out, "\n]}\n");
+}
+
+static void html_commit(render_out_t *out, const changelog_model_t *model, const commit_info_t *commit) {
+    out_lit(out, "<li>");
+    if (model->group_by_type) {
+        if (commit->scope) {
+            out_lit(out, "<strong>");
+            out_html(out, commit->scope);
+            out_lit(out, ":</strong> ");
+        }
+    } else {
+        out_html(out, changelog_commit_type_string(commit->type));
+        out_lit(out, ": ");
+    }
+    out_html(out, commit->description);
+    if (commit->is_breaking) out_lit(out, " <em>[BREAKING]</em>");
+    if ((model->group_by_type || model->include_authors) && commit->author) {
+        out_lit(out, " (");
+        out_html(out, commit->author);
+        out_lit(out, ")");
+    }
+    out_lit(out, "</li>\n");
+}
+
+static void render_html(render_out_t *out, const changelog_model_t *model) {
+    out_lit(out, "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n"
+                 "<title>Changelog</title>\n</head>\n<body>\n<h1>Changelog</h1>\n");
+    for (size_t i = 0; i < model->count; i++) {
+        const changelog_entry_t *entry = model->entries[i];
+        const changelog_buckets_t *buckets = &model->buckets[i];
+
+        out_lit(out, "<section id=\"v");
+        out_html(out, entry->version);
+        out_lit(out, "\">\n<h2>");
+        out_html(out, entry->version);
+        if (entry->date) {
+            out_lit(out, " <small>");
+            out_html(out, entry->date);
+            out_lit(out, "</small>");
+        }
+        out_lit(out, "</h2>\n");
+
+        FOR_EACH_BUCKET(model, t) {
+            if (bucket_size(buckets, t) == 0) continue;
+            if (model->group_by_type) {
+                out_lit(out, "<h3>");
+                out_str(out, changelog_commit_type_string((commit_type_t)t));
+                out_lit(out, "</h3>\n");
+            }
+            out_lit(out, "<ul>\n");
+            for (size_t j = buckets->starts[t]; j < buckets->starts[t + 1]; j++) {
+                html_commit(out, model, buckets->commits[j]);
+            }
+            out_lit(out, "</ul>\n");
+        }
+
+        if (buckets->contributor_count) out_lit(out, "<h3>Contributors</h3>\n<ul>\n");
+        for (size_t j = 0; j < buckets->contributor_count; j++) {
+            out_lit(out, "<li>");
+            out_html(out, buckets->contributors[j].signature);
+            out_commit_count(out, buckets->contributors[j].commits);
+            out_lit(out, "</li>\n");
+        }
+        if (buckets->contributor_count) out_lit(out, "</ul>\n");
+        out_lit(out, "</section>\n");
+    }
+    out_lit(out, "</body>\n</html>\n");
+}
+
+int changelog_model_render(const changelog_model_t *model, changelog_format_t format, int fd) {
+    if (!model || fd < 0) return RELEASY_ERROR;
+
+    render_out_t out;
+    memset(&out, 0, sizeof(out));
+    out.fd = fd;
+    out.capacity = CHANGELOG_RENDER_BUFFER;
+    out.buf = malloc(out.capacity);
+    out.borrow = 1;
+    if (!out.buf) return CHANGELOG_ERR_MEMORY;
+    date_cache_init(&out.dates);
+
+    switch (format) {
+        case CHANGELOG_FORMAT_MARKDOWN:
+            render_markdown(&out, model);
+            break;
+        case CHANGELOG_FORMAT_JSON:
+            render_json(&out, model);
+            break;
+        case CHANGELOG_FORMAT_HTML:
+            render_html(&out, model);
+            break;
+        default:
+            free(out.buf);
+            return CHANGELOG_ERR_INVALID_CONFIG;
+    }
+    out_flush(&out);
+
+    free(out.buf);
+    return out.failed ? CHANGELOG_ERR_FILE_ACCESS : RELEASY_SUCCESS;
+}
+
+static const struct {
+    const char *name;
+    const char *extension;
+    changelog_format_t format;
+} format_names[] = {
+    { "md", ".md", CHANGELOG_FORMAT_MARKDOWN },
+    { "markdown", ".md", CHANGELOG_FORMAT_MARKDOWN },
+    { "json", ".json", CHANGELOG_FORMAT_JSON },
+    { "html", ".html", CHANGELOG_FORMAT_HTML },
+};
+
+#define FORMAT_NAME_COUNT (sizeof(format_names) / sizeof(format_names[0]))
+
+int changelog_parse_formats(const char *list, int *formats) {
+    if (!list || !formats) return RELEASY_ERROR;
+
+    int mask = 0;
+    const char *p = list;
+    while (*p) {
+        size_t len = strcspn(p, ",");
+        size_t i;
+        for (i = 0; i < FORMAT_NAME_COUNT; i++) {
+            if (strlen(format_names[i].name) == len && strncasecmp(p, format_names[i].name, len) == 0) break;
+        }
+        if (i == FORMAT_NAME_COUNT) return CHANGELOG_ERR_INVALID_CONFIG;
+        mask |= format_names[i].format;
+        p += len;
+        if (*p == ',') p++;
+    }
+    if (!mask) return CHANGELOG_ERR_INVALID_CONFIG;
+
+    *formats = mask;
+    return RELEASY_SUCCESS;
+}
+
+const char *changelog_format_extension(changelog_format_t format) {
+    for (size_t i = 0; i < FORMAT_NAME_COUNT; i++) {
+        if (format_names[i].format == format) return format_names[i].extension;
+    }
+    return NULL;
+}
@@ -0,0 +1,351 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "commit_cache.h"
+#include "sidecar.h"
+
+static char *cache_file_path(git_repository *repo) {
+    return sidecar_path(git_repository_commondir(repo), COMMIT_CACHE_FILE);
+}
+
+static void unmap_cache(commit_cache_t *cache) {
+    if (cache->map) munmap(cache->map, cache->map_size);
+    free(cache->used);
+    cache->map = NULL;
+    cache->map_size = 0;
+    cache->header = NULL;
+    cache->entries = NULL;
+    cache->data = NULL;
+    cache->count = 0;
+    cache->used = NULL;
+}
+
+// Every record must end inside the data area on a NUL
+static int records_valid(const commit_cache_t *cache) {
+    uint64_t data_size = cache->header->data_size;
+    for (size_t i = 0; i < cache->count; i++) {
+        const commit_cache_entry_t *entry = &cache->entries[i];
+        if (!(entry->flags & COMMIT_CACHE_CONVENTIONAL)) continue;
+
+        uint64_t end = (uint64_t)entry->data_offset + entry->data_length;
+        if (entry->data_length == 0 || end > data_size || cache->data[end - 1] != '\0') return 0;
+    }
+    return 1;
+}
+
+static int map_cache(commit_cache_t *cache, git_repository *repo) {
+    char *path = cache_file_path(repo);
+    if (!path) return COMMIT_CACHE_ERR_MEMORY;
+
+    int ret = sidecar_map(path, sizeof(commit_cache_header_t), &cache->map, &cache->map_size, NULL);
+    free(path);
+    if (ret != RELEASY_SUCCESS) {
+        return ret == SIDECAR_ERR_CORRUPT ? COMMIT_CACHE_ERR_CORRUPT : COMMIT_CACHE_ERR_FILE_ACCESS;
+    }
+    cache->header = cache->map;
+
+    const commit_cache_header_t *header = cache->header;
+    if (memcmp(header->magic, COMMIT_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->format != COMMIT_CACHE_FORMAT ||
+        header->byte_order != SIDECAR_BYTE_ORDER ||
+        header->entry_size != sizeof(commit_cache_entry_t)) {
+        unmap_cache(cache);
+        return COMMIT_CACHE_ERR_CORRUPT;
+    }
+
+    uint64_t expected = sizeof(commit_cache_header_t) +
+                        (uint64_t)header->count * sizeof(commit_cache_entry_t) +
+                        header->data_size;
+    if (expected != cache->map_size) {
+        unmap_cache(cache);
+        return COMMIT_CACHE_ERR_CORRUPT;
+    }
+
+    cache->entries = (const commit_cache_entry_t *)((const char *)cache->map + sizeof(commit_cache_header_t));
+    cache->data = (const char *)(cache->entries + header->count);
+    cache->count = header->count;
+
+    if (!records_valid(cache)) {
+        unmap_cache(cache);
+        return COMMIT_CACHE_ERR_CORRUPT;
+    }
+
+    cache->used = calloc(cache->count ? cache->count : 1, 1);
+    if (!cache->used) {
+        unmap_cache(cache);
+        return COMMIT_CACHE_ERR_MEMORY;
+    }
+    return RELEASY_SUCCESS;
+}
+
+int commit_cache_open(commit_cache_t *cache, git_repository *repo) {
+    if (!cache || !repo) return RELEASY_ERROR;
+
+    memset(cache, 0, sizeof(commit_cache_t));
+    cache->max_bytes = COMMIT_CACHE_MAX_BYTES;
+
+    int ret = map_cache(cache, repo);
+    return ret == COMMIT_CACHE_ERR_MEMORY ? ret : RELEASY_SUCCESS;
+}
+
+static const commit_cache_entry_t *find_entry(const commit_cache_t *cache, const git_oid *oid) {
+    size_t lo = 0, hi = cache->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = memcmp(cache->entries[mid].oid, oid->id, GIT_OID_RAWSZ);
+        if (cmp == 0) return &cache->entries[mid];
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
+// Takes the next NUL terminated string of a record
+static char *next_string(const char **cursor, int present) {
+    const char *str = *cursor;
+    *cursor += strlen(str) + 1;
+    return present ? (char *)str : NULL;
+}
+
+commit_cache_result_t commit_cache_lookup(commit_cache_t *cache, const git_oid *oid,
+                                          commit_info_t *info) {
+    if (!cache || !oid || !info) return COMMIT_CACHE_MISS;
+
+    const commit_cache_entry_t *entry = find_entry(cache, oid);
+    if (!entry) return COMMIT_CACHE_MISS;
+
+    // Each commit is looked up once per walk, so no two threads share a flag
+    cache->used[entry - cache->entries] = 1;
+    if (!(entry->flags & COMMIT_CACHE_CONVENTIONAL)) return COMMIT_CACHE_HIT_OTHER;
+
+    memset(info, 0, sizeof(commit_info_t));
+    info->type = entry->type < COMMIT_TYPE_UNKNOWN ? (commit_type_t)entry->type : COMMIT_TYPE_UNKNOWN;
+    info->is_breaking = (entry->flags & COMMIT_CACHE_BREAKING) != 0;
+    info->timestamp = entry->timestamp;
+
+    const char *cursor = cache->data + entry->data_offset;
+    info->scope = next_string(&cursor, entry->flags & COMMIT_CACHE_HAS_SCOPE);
+    info->description = next_string(&cursor, 1);
+    info->body = next_string(&cursor, entry->flags & COMMIT_CACHE_HAS_BODY);
+    info->footer = next_string(&cursor, entry->flags & COMMIT_CACHE_HAS_FOOTER);
+    info->author = next_string(&cursor, entry->flags & COMMIT_CACHE_HAS_AUTHOR);
+    return COMMIT_CACHE_HIT;
+}
+
+static int append_string(commit_cache_t *cache, const char *str) {
+    size_t len = (str ? strlen(str) : 0) + 1;
+    if (cache->added_size + len > cache->added_data_capacity) {
+        size_t capacity = cache->added_data_capacity ? cache->added_data_capacity * 2 : 4096;
+        while (capacity < cache->added_size + len) capacity *= 2;
+        char *data = realloc(cache->added_data, capacity);
+        if (!data) return COMMIT_CACHE_ERR_MEMORY;
+        cache->added_data = data;
+        cache->added_data_capacity = capacity;
+    }
+    memcpy(cache->added_data + cache->added_size, str ? str : "", len);
+    cache->added_size += len;
+    return RELEASY_SUCCESS;
+}
+
+int commit_cache_add(commit_cache_t *cache, const git_oid *oid, const commit_info_t *info) {
+    if (!cache || !oid) return RELEASY_ERROR;
+    if (info && !info->description) return RELEASY_ERROR;
+
+    if (cache->added_count == cache->added_capacity) {
+        size_t capacity = cache->added_capacity ? cache->added_capacity * 2 : 256;
+        commit_cache_entry_t *added = realloc(cache->added, capacity * sizeof(commit_cache_entry_t));
+        if (!added) return COMMIT_CACHE_ERR_MEMORY;
+        cache->added = added;
+        cache->added_capacity = capacity;
+    }
+
+    commit_cache_entry_t *entry = &cache->added[cache->added_count];
+    memset(entry, 0, sizeof(commit_cache_entry_t));
+    memcpy(entry->oid, oid->id, GIT_OID_RAWSZ);
+
+    if (info) {
+        size_t start = cache->added_size;
+        int ret = RELEASY_SUCCESS;
+        const char *fields[] = { info->scope, info->description, info->body, info->footer, info->author };
+        for (size_t i = 0; ret == RELEASY_SUCCESS && i < sizeof(fields) / sizeof(fields[0]); i++) {
+            ret = append_string(cache, fields[i]);
+        }
+        if (ret != RELEASY_SUCCESS) {
+            cache->added_size = start;
+            return ret;
+        }
+        if (cache->added_size - start > UINT32_MAX) {
+            cache->added_size = start;
+            return RELEASY_ERROR;
+        }
+
+        entry->timestamp = info->timestamp;
+        entry->type = (uint8_t)info->type;
+        entry->flags = COMMIT_CACHE_CONVENTIONAL;
+        if (info->is_breaking) entry->flags |= COMMIT_CACHE_BREAKING;
+        if (info->scope) entry->flags |= COMMIT_CACHE_HAS_SCOPE;
+        if (info->body) entry->flags |= COMMIT_CACHE_HAS_BODY;
+        if (info->footer) entry->flags |= COMMIT_CACHE_HAS_FOOTER;
+        if (info->author) entry->flags |= COMMIT_CACHE_HAS_AUTHOR;
+        entry->data_offset = (uint32_t)start;
+        entry->data_length = (uint32_t)(cache->added_size - start);
+    }
+
+    cache->added_count++;
+    return RELEASY_SUCCESS;
+}
+
+// An entry headed for the rewritten file, with where its record is now
+typedef struct {
+    commit_cache_entry_t entry;
+    const char *record;
+} cache_slot_t;
+
+static int compare_slot_oid(const void *a, const void *b) {
+    const cache_slot_t *sa = a, *sb = b;
+    int cmp = memcmp(sa->entry.oid, sb->entry.oid, GIT_OID_RAWSZ);
+    if (cmp) return cmp;
+    // Equal ids: mapped entries sort first, so the duplicate added later is dropped
+    return (sa->record > sb->record) - (sa->record < sb->record);
+}
+
+static int compare_slot_generation(const void *a, const void *b) {
+    const cache_slot_t *sa = a, *sb = b;
+    if (sa->entry.generation != sb->entry.generation) {
+        return sa->entry.generation < sb->entry.generation ? 1 : -1;
+    }
+    return memcmp(sa->entry.oid, sb->entry.oid, GIT_OID_RAWSZ);
+}
+
+static size_t slot_bytes(const cache_slot_t *slot) {
+    return sizeof(commit_cache_entry_t) + slot->entry.data_length;
+}
+
+static int write_slots(FILE *f, const cache_slot_t *slots, size_t count, uint64_t generation) {
+    commit_cache_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COMMIT_CACHE_MAGIC, sizeof(header.magic));
+    header.format = COMMIT_CACHE_FORMAT;
+    header.byte_order = SIDECAR_BYTE_ORDER;
+    header.entry_size = sizeof(commit_cache_entry_t);
+    header.count = (uint32_t)count;
+    header.generation = generation;
+    for (size_t i = 0; i < count; i++) {
+        header.data_size += slots[i].entry.data_length;
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    uint64_t offset = 0;
+    for (size_t i = 0; ok && i < count; i++) {
+        commit_cache_entry_t entry = slots[i].entry;
+        entry.data_offset = (uint32_t)offset;
+        offset += entry.data_length;
+        ok = fwrite(&entry, sizeof(entry), 1, f) == 1;
+    }
+
+    for (size_t i = 0; ok && i < count; i++) {
+        if (slots[i].entry.data_length == 0) continue;
+        ok = fwrite(slots[i].record, slots[i].entry.data_length, 1, f) == 1;
+    }
+    return ok;
+}
+
+/*
+ * Rewrites the file as the mapped entries plus everything added. Entries
+ * looked up since open take the new generation; past max_bytes, the oldest
+ * generations are dropped first. Readers that have the old file mapped keep
+ * their inode until they close.
+ */
+int commit_cache_save(commit_cache_t *cache, git_repository *repo) {
+    if (!cache || !repo) return RELEASY_ERROR;
+    if (cache->added_count == 0) return RELEASY_SUCCESS;
+
+    uint64_t generation = (cache->header ? cache->header->generation : 0) + 1;
+
+    size_t total = cache->count + cache->added_count;
+    cache_slot_t *slots = malloc(total * sizeof(cache_slot_t));
+    if (!slots) return COMMIT_CACHE_ERR_MEMORY;
+
+    for (size_t i = 0; i < cache->count; i++) {
+        slots[i].entry = cache->entries[i];
+        slots[i].record = cache->data + cache->entries[i].data_offset;
+        if (cache->used[i]) slots[i].entry.generation = generation;
+    }
+    for (size_t i = 0; i < cache->added_count; i++) {
+        cache_slot_t *slot = &slots[cache->count + i];
+        slot->entry = cache->added[i];
+        slot->entry.generation = generation;
+        slot->record = cache->added_data + cache->added[i].data_offset;
+    }
+
+    // Drop ids recorded twice, keeping the copy already on disk
+    qsort(slots, total, sizeof(cache_slot_t), compare_slot_oid);
+    size_t count = 0;
+    for (size_t i = 0; i < total; i++) {
+        if (count > 0 && memcmp(slots[count - 1].entry.oid, slots[i].entry.oid, GIT_OID_RAWSZ) == 0) continue;
+        slots[count++] = slots[i];
+    }
+
+    size_t bytes = sizeof(commit_cache_header_t);
+    for (size_t i = 0; i < count; i++) bytes += slot_bytes(&slots[i]);
+    if (bytes > cache->max_bytes) {
+        qsort(slots, count, sizeof(cache_slot_t), compare_slot_generation);
+        bytes = sizeof(commit_cache_header_t);
+        size_t keep = 0;
+        while (keep < count && bytes + slot_bytes(&slots[keep]) <= cache->max_bytes) {
+            bytes += slot_bytes(&slots[keep++]);
+        }
+        count = keep;
+        qsort(slots, count, sizeof(cache_slot_t), compare_slot_oid);
+    }
+
+    char *path = cache_file_path(repo);
+    sidecar_writer_t writer;
+    int ret = path ? sidecar_begin(&writer, path) : SIDECAR_ERR_MEMORY;
+    if (ret == RELEASY_SUCCESS) ret = sidecar_commit(&writer, write_slots(writer.file, slots, count, generation));
+    free(path);
+    free(slots);
+
+    switch (ret) {
+        case RELEASY_SUCCESS:
+            return RELEASY_SUCCESS;
+        case SIDECAR_ERR_LOCKED:
+            return COMMIT_CACHE_ERR_LOCKED;
+        case SIDECAR_ERR_MEMORY:
+            return COMMIT_CACHE_ERR_MEMORY;
+        default:
+            return COMMIT_CACHE_ERR_FILE_ACCESS;
+    }
+}
+
+void commit_cache_close(commit_cache_t *cache) {
+    if (!cache) return;
+
+    unmap_cache(cache);
+    free(cache->added);
+    free(cache->added_data);
+    memset(cache, 0, sizeof(commit_cache_t));
+}
+
+const char *commit_cache_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case COMMIT_CACHE_ERR_CORRUPT:
+            return "Commit cache is corrupt";
+        case COMMIT_CACHE_ERR_FILE_ACCESS:
+            return "Failed to access commit cache";
+        case COMMIT_CACHE_ERR_MEMORY:
+            return "Memory allocation failed";
+        case COMMIT_CACHE_ERR_LOCKED:
+            return "Commit cache is being written by another process";
+        default:
+            return "Unknown error";
+    }
+}
@@ -0,0 +1,697 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "commit_graph.h"
+#include "sidecar.h"
+
+// See Documentation/gitformat-commit-graph.txt in git
+#define GRAPH_SIGNATURE "CGPH"
+#define GRAPH_VERSION 1
+#define GRAPH_HASH_SHA1 1
+#define GRAPH_HEADER_SIZE 8
+#define GRAPH_CHUNK_ENTRY_SIZE 12
+#define GRAPH_TRAILER_SIZE GIT_OID_RAWSZ
+#define GRAPH_FANOUT_SIZE (256 * 4)
+#define GRAPH_DATA_SIZE (GIT_OID_RAWSZ + 16)
+
+#define GRAPH_CHUNK_FANOUT 0x4f494446u      // "OIDF"
+#define GRAPH_CHUNK_OIDS 0x4f49444cu        // "OIDL"
+#define GRAPH_CHUNK_DATA 0x43444154u        // "CDAT"
+#define GRAPH_CHUNK_EDGES 0x45444745u       // "EDGE"
+#define GRAPH_CHUNK_BLOOM_INDEX 0x42494458u // "BIDX"
+#define GRAPH_CHUNK_BLOOM_DATA 0x42444154u  // "BDAT"
+#define GRAPH_BLOOM_HEADER_SIZE 12
+#define GRAPH_BLOOM_SEED0 0x293ae76fu
+#define GRAPH_BLOOM_SEED1 0x7e646e2cu
+
+#define GRAPH_PARENT_NONE 0x70000000u
+#define GRAPH_EXTRA_EDGES 0x80000000u
+#define GRAPH_LAST_EDGE 0x80000000u
+
+static uint32_t read_be32(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint64_t read_be64(const unsigned char *p) {
+    return ((uint64_t)read_be32(p) << 32) | read_be32(p + 4);
+}
+
+// Points the graph at its chunks, checking each lies inside the file and
+// has the size its row count implies
+static int parse_chunks(commit_graph_t *graph) {
+    const unsigned char *base = graph->map;
+    size_t size = graph->map_size;
+    if (size < GRAPH_HEADER_SIZE + GRAPH_CHUNK_ENTRY_SIZE + GRAPH_TRAILER_SIZE) return COMMIT_GRAPH_ERR_CORRUPT;
+
+    // A graph that needs base layers is part of a split chain
+    if (memcmp(base, GRAPH_SIGNATURE, 4) != 0 || base[4] != GRAPH_VERSION ||
+        base[5] != GRAPH_HASH_SHA1 || base[7] != 0) {
+        return COMMIT_GRAPH_ERR_CORRUPT;
+    }
+
+    size_t chunks = base[6];
+    size_t table_end = GRAPH_HEADER_SIZE + (chunks + 1) * GRAPH_CHUNK_ENTRY_SIZE;
+    if (table_end > size - GRAPH_TRAILER_SIZE) return COMMIT_GRAPH_ERR_CORRUPT;
+
+    size_t data_size = 0, edges_size = 0, oids_size = 0, bloom_index_size = 0;
+    const unsigned char *bloom_data = NULL;
+    size_t bloom_data_size = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        const unsigned char *entry = base + GRAPH_HEADER_SIZE + i * GRAPH_CHUNK_ENTRY_SIZE;
+        uint64_t offset = read_be64(entry + 4);
+        uint64_t end = read_be64(entry + 4 + GRAPH_CHUNK_ENTRY_SIZE);
+        if (offset < table_end || end < offset || end > size - GRAPH_TRAILER_SIZE) {
+            return COMMIT_GRAPH_ERR_CORRUPT;
+        }
+
+        const unsigned char *chunk = base + offset;
+        size_t chunk_size = (size_t)(end - offset);
+        switch (read_be32(entry)) {
+            case GRAPH_CHUNK_FANOUT:
+                if (chunk_size != GRAPH_FANOUT_SIZE) return COMMIT_GRAPH_ERR_CORRUPT;
+                graph->fanout = chunk;
+                break;
+            case GRAPH_CHUNK_OIDS:
+                graph->oids = chunk;
+                oids_size = chunk_size;
+                break;
+            case GRAPH_CHUNK_DATA:
+                graph->commits = chunk;
+                data_size = chunk_size;
+                break;
+            case GRAPH_CHUNK_EDGES:
+                graph->extra_edges = chunk;
+                edges_size = chunk_size;
+                break;
+            case GRAPH_CHUNK_BLOOM_INDEX:
+                graph->bloom_index = chunk;
+                bloom_index_size = chunk_size;
+                break;
+            case GRAPH_CHUNK_BLOOM_DATA:
+                bloom_data = chunk;
+                bloom_data_size = chunk_size;
+                break;
+            default:
+                // Corrected dates and the like are not needed
+                break;
+        }
+    }
+    if (!graph->fanout || !graph->oids || !graph->commits) return COMMIT_GRAPH_ERR_CORRUPT;
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < 256; i++) {
+        uint32_t count = read_be32(graph->fanout + i * 4);
+        if (count < previous) return COMMIT_GRAPH_ERR_CORRUPT;
+        previous = count;
+    }
+    graph->count = previous;
+
+    if (oids_size != (size_t)graph->count * GIT_OID_RAWSZ ||
+        data_size != (size_t)graph->count * GRAPH_DATA_SIZE ||
+        edges_size % 4 != 0) {
+        return COMMIT_GRAPH_ERR_CORRUPT;
+    }
+    graph->extra_edges_count = edges_size / 4;
+
+    // Filters that do not add up are ignored; every commit then reads as
+    // possibly touching every path
+    if (graph->bloom_index && bloom_data && bloom_data_size >= GRAPH_BLOOM_HEADER_SIZE &&
+        bloom_index_size == (size_t)graph->count * 4) {
+        uint32_t version = read_be32(bloom_data);
+        uint32_t hashes = read_be32(bloom_data + 4);
+        if ((version == 1 || version == 2) && hashes > 0 && hashes <= 32) {
+            graph->bloom_version = version;
+            graph->bloom_hashes = hashes;
+            graph->bloom_data = bloom_data + GRAPH_BLOOM_HEADER_SIZE;
+            graph->bloom_data_size = bloom_data_size - GRAPH_BLOOM_HEADER_SIZE;
+        }
+    }
+    if (!graph->bloom_version) graph->bloom_index = NULL;
+    return RELEASY_SUCCESS;
+}
+
+int commit_graph_open(commit_graph_t *graph, git_repository *repo) {
+    if (!graph || !repo) return RELEASY_ERROR;
+    memset(graph, 0, sizeof(commit_graph_t));
+
+    char *path = sidecar_common_path(git_repository_commondir(repo), COMMIT_GRAPH_FILE);
+    if (!path) return COMMIT_GRAPH_ERR_MEMORY;
+
+    int ret = sidecar_map(path, 1, &graph->map, &graph->map_size, NULL);
+    free(path);
+    if (ret == SIDECAR_ERR_FILE_ACCESS) return COMMIT_GRAPH_ERR_NOT_FOUND;
+    if (ret != RELEASY_SUCCESS) return COMMIT_GRAPH_ERR_CORRUPT;
+    ret = parse_chunks(graph);
+    if (ret != RELEASY_SUCCESS) commit_graph_close(graph);
+    return ret;
+}
+
+uint32_t commit_graph_find(const commit_graph_t *graph, const git_oid *oid) {
+    if (!graph || !graph->map || !oid) return COMMIT_GRAPH_NONE;
+
+    // The fanout narrows the search to ids sharing the first byte
+    unsigned char first = oid->id[0];
+    uint32_t lo = first ? read_be32(graph->fanout + (first - 1) * 4) : 0;
+    uint32_t hi = read_be32(graph->fanout + first * 4);
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = memcmp(graph->oids + (size_t)mid * GIT_OID_RAWSZ, oid->id, GIT_OID_RAWSZ);
+        if (cmp == 0) return mid;
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return COMMIT_GRAPH_NONE;
+}
+
+void commit_graph_oid(const commit_graph_t *graph, uint32_t pos, git_oid *oid) {
+    git_oid_fromraw(oid, graph->oids + (size_t)pos * GIT_OID_RAWSZ);
+}
+
+static const unsigned char *commit_data(const commit_graph_t *graph, uint32_t pos) {
+    return graph->commits + (size_t)pos * GRAPH_DATA_SIZE;
+}
+
+uint32_t commit_graph_generation(const commit_graph_t *graph, uint32_t pos) {
+    return read_be32(commit_data(graph, pos) + GIT_OID_RAWSZ + 8) >> 2;
+}
+
+int64_t commit_graph_time(const commit_graph_t *graph, uint32_t pos) {
+    const unsigned char *data = commit_data(graph, pos) + GIT_OID_RAWSZ + 8;
+    return (int64_t)(((uint64_t)(read_be32(data) & 3) << 32) | read_be32(data + 4));
+}
+
+// Positions that point outside the graph are dropped rather than trusted
+static size_t add_parent(const commit_graph_t *graph, uint32_t parent, uint32_t *parents,
+                         size_t max, size_t count) {
+    if (parent >= graph->count) return count;
+    if (count < max) parents[count] = parent;
+    return count + 1;
+}
+
+size_t commit_graph_parents(const commit_graph_t *graph, uint32_t pos,
+                            uint32_t *parents, size_t max) {
+    const unsigned char *data = commit_data(graph, pos);
+    uint32_t first = read_be32(data + GIT_OID_RAWSZ);
+    uint32_t second = read_be32(data + GIT_OID_RAWSZ + 4);
+
+    size_t count = 0;
+    if (first != GRAPH_PARENT_NONE) count = add_parent(graph, first, parents, max, count);
+    if (second == GRAPH_PARENT_NONE) return count;
+    if (!(second & GRAPH_EXTRA_EDGES)) return add_parent(graph, second, parents, max, count);
+
+    // Octopus merge: the rest run on in EDGE until one has the last bit set
+    for (size_t i = second & ~GRAPH_EXTRA_EDGES; i < graph->extra_edges_count; i++) {
+        uint32_t edge = read_be32(graph->extra_edges + i * 4);
+        count = add_parent(graph, edge & ~GRAPH_LAST_EDGE, parents, max, count);
+        if (edge & GRAPH_LAST_EDGE) break;
+    }
+    return count;
+}
+
+static uint32_t rotate_left(uint32_t value, int count) {
+    return (value << count) | (value >> (32 - count));
+}
+
+// git's murmur3. Version 1 filters were written with bytes read as plain
+// char, so only ASCII paths hash the same everywhere; callers skip them.
+static uint32_t murmur3(uint32_t seed, const unsigned char *data, size_t len) {
+    const uint32_t c1 = 0xcc9e2d51, c2 = 0x1b873593;
+    size_t blocks = len / 4;
+    for (size_t i = 0; i < blocks; i++) {
+        const unsigned char *block = data + i * 4;
+        uint32_t k = (uint32_t)block[0] | ((uint32_t)block[1] << 8) |
+                     ((uint32_t)block[2] << 16) | ((uint32_t)block[3] << 24);
+        k *= c1;
+        k = rotate_left(k, 15);
+        k *= c2;
+        seed ^= k;
+        seed = rotate_left(seed, 13) * 5 + 0xe6546b64;
+    }
+
+    const unsigned char *tail = data + blocks * 4;
+    uint32_t k = 0;
+    switch (len & 3) {
+        case 3:
+            k ^= (uint32_t)tail[2] << 16;
+            // fall through
+        case 2:
+            k ^= (uint32_t)tail[1] << 8;
+            // fall through
+        case 1:
+            k ^= tail[0];
+            k *= c1;
+            k = rotate_left(k, 15);
+            k *= c2;
+            seed ^= k;
+            break;
+    }
+
+    seed ^= (uint32_t)len;
+    seed ^= seed >> 16;
+    seed *= 0x85ebca6b;
+    seed ^= seed >> 13;
+    seed *= 0xc2b2ae35;
+    seed ^= seed >> 16;
+    return seed;
+}
+
+int commit_graph_bloom_keys(const commit_graph_t *graph, const char *path,
+                            commit_graph_bloom_key_t **keys, size_t *count) {
+    if (!graph || !path || !keys || !count) return RELEASY_ERROR;
+    *keys = NULL;
+    *count = 0;
+    if (!graph->bloom_version) return COMMIT_GRAPH_ERR_NOT_FOUND;
+
+    size_t len = strlen(path);
+    size_t levels = len ? 1 : 0;
+    for (size_t i = 0; i < len; i++) {
+        if (graph->bloom_version == 1 && ((unsigned char)path[i] & 0x80)) return COMMIT_GRAPH_ERR_NOT_FOUND;
+        if (path[i] == '/') levels++;
+    }
+    if (!levels) return COMMIT_GRAPH_ERR_NOT_FOUND;
+
+    *keys = malloc(levels * sizeof(commit_graph_bloom_key_t));
+    if (!*keys) return COMMIT_GRAPH_ERR_MEMORY;
+
+    // "a/b/c" is probed as "a/b/c", "a/b" and "a"
+    for (size_t end = len; end > 0;) {
+        const unsigned char *data = (const unsigned char *)path;
+        commit_graph_bloom_key_t *key = &(*keys)[(*count)++];
+        key->hash0 = murmur3(GRAPH_BLOOM_SEED0, data, end);
+        key->hash1 = murmur3(GRAPH_BLOOM_SEED1, data, end);
+        while (end > 0 && path[end - 1] != '/') end--;
+        if (end > 0) end--;
+    }
+    return RELEASY_SUCCESS;
+}
+
+int commit_graph_bloom_maybe_changed(const commit_graph_t *graph, uint32_t pos,
+                                     const commit_graph_bloom_key_t *keys, size_t count) {
+    if (!graph || !graph->bloom_version || pos >= graph->count || !keys) return 1;
+
+    uint32_t start = pos ? read_be32(graph->bloom_index + (size_t)(pos - 1) * 4) : 0;
+    uint32_t end = read_be32(graph->bloom_index + (size_t)pos * 4);
+    if (end <= start || end > graph->bloom_data_size) return 1;
+
+    // An empty filter was never computed
+    const unsigned char *filter = graph->bloom_data + start;
+    uint64_t bits = (uint64_t)(end - start) * 8;
+    for (size_t i = 0; i < count; i++) {
+        for (uint32_t j = 0; j < graph->bloom_hashes; j++) {
+            uint64_t bit = (uint32_t)(keys[i].hash0 + j * keys[i].hash1) % bits;
+            if (!(filter[bit / 8] & (1u << (bit % 8)))) return 0;
+        }
+    }
+    return 1;
+}
+
+// A commit the graph does not have yet, read from the object database.
+// Its node id follows the graph's positions.
+typedef struct {
+    git_oid oid;
+    uint32_t generation;
+    int64_t time;
+    uint32_t *parents;
+    size_t parent_count;
+} overlay_commit_t;
+
+#define NODE_QUEUED 0x01
+#define NODE_DONE 0x02
+#define NODE_HIDDEN 0x04
+
+typedef struct {
+    const commit_graph_t *graph;
+    git_repository *repo;
+    overlay_commit_t *overlay;
+    size_t overlay_count;
+    size_t overlay_capacity;
+    uint32_t *overlay_slots;    // Overlay index + 1 by commit id, 0 when empty
+    size_t overlay_slot_capacity;
+    unsigned char *flags;       // NODE_* per node id
+    uint32_t *heap;             // Queued node ids, highest generation on top
+    size_t heap_count;
+    size_t heap_capacity;
+    uint32_t *parent_buffer;
+    size_t parent_buffer_size;
+    int first_parent;           // Visible commits queue their first parent only
+} range_walk_t;
+
+static uint32_t node_generation(const range_walk_t *walk, uint32_t id) {
+    if (id < walk->graph->count) return commit_graph_generation(walk->graph, id);
+    return walk->overlay[id - walk->graph->count].generation;
+}
+
+static int64_t node_time(const range_walk_t *walk, uint32_t id) {
+    if (id < walk->graph->count) return commit_graph_time(walk->graph, id);
+    return walk->overlay[id - walk->graph->count].time;
+}
+
+static void node_oid(const range_walk_t *walk, uint32_t id, git_oid *oid) {
+    if (id < walk->graph->count) {
+        commit_graph_oid(walk->graph, id, oid);
+    } else {
+        *oid = walk->overlay[id - walk->graph->count].oid;
+    }
+}
+
+static size_t overlay_slot(const range_walk_t *walk, const git_oid *oid) {
+    size_t hash;
+    memcpy(&hash, oid->id, sizeof(hash));
+    size_t mask = walk->overlay_slot_capacity - 1;
+    size_t i = hash & mask;
+    while (walk->overlay_slots[i] &&
+           !git_oid_equal(&walk->overlay[walk->overlay_slots[i] - 1].oid, oid)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Node id for oid, queueing it for the overlay when the graph lacks it
+static int node_for(range_walk_t *walk, const git_oid *oid, uint32_t *id) {
+    uint32_t pos = commit_graph_find(walk->graph, oid);
+    if (pos != COMMIT_GRAPH_NONE) {
+        *id = pos;
+        return RELEASY_SUCCESS;
+    }
+
+    if (walk->overlay_slot_capacity) {
+        uint32_t slot = walk->overlay_slots[overlay_slot(walk, oid)];
+        if (slot) {
+            *id = walk->graph->count + slot - 1;
+            return RELEASY_SUCCESS;
+        }
+    }
+    if (walk->overlay_count == COMMIT_GRAPH_MAX_OVERLAY) return COMMIT_GRAPH_ERR_STALE;
+
+    if (walk->overlay_count == walk->overlay_capacity) {
+        size_t capacity = walk->overlay_capacity ? walk->overlay_capacity * 2 : 64;
+        overlay_commit_t *overlay = realloc(walk->overlay, capacity * sizeof(overlay_commit_t));
+        if (!overlay) return COMMIT_GRAPH_ERR_MEMORY;
+        walk->overlay = overlay;
+        walk->overlay_capacity = capacity;
+
+        // Rehash at the same time, keeping the table at most half full
+        uint32_t *slots = calloc(capacity * 2, sizeof(uint32_t));
+        if (!slots) return COMMIT_GRAPH_ERR_MEMORY;
+        free(walk->overlay_slots);
+        walk->overlay_slots = slots;
+        walk->overlay_slot_capacity = capacity * 2;
+        for (size_t i = 0; i < walk->overlay_count; i++) {
+            walk->overlay_slots[overlay_slot(walk, &walk->overlay[i].oid)] = (uint32_t)i + 1;
+        }
+    }
+
+    overlay_commit_t *commit = &walk->overlay[walk->overlay_count];
+    memset(commit, 0, sizeof(overlay_commit_t));
+    commit->oid = *oid;
+    walk->overlay_slots[overlay_slot(walk, oid)] = (uint32_t)++walk->overlay_count;
+    *id = walk->graph->count + (uint32_t)walk->overlay_count - 1;
+    return RELEASY_SUCCESS;
+}
+
+/*
+ * Reads every commit reachable from the ends that the graph does not have.
+ * Graph commits only have graph parents, so this stops where the graph
+ * begins. Generations are then settled until no parent outranks a child.
+ */
+static int build_overlay(range_walk_t *walk) {
+    for (size_t i = 0; i < walk->overlay_count; i++) {
+        git_commit *commit = NULL;
+        if (git_commit_lookup(&commit, walk->repo, &walk->overlay[i].oid) != 0) {
+            return COMMIT_GRAPH_ERR_GIT_OPERATION;
+        }
+
+        size_t count = git_commit_parentcount(commit);
+        uint32_t *parents = count ? malloc(count * sizeof(uint32_t)) : NULL;
+        int ret = count && !parents ? COMMIT_GRAPH_ERR_MEMORY : RELEASY_SUCCESS;
+        for (size_t j = 0; ret == RELEASY_SUCCESS && j < count; j++) {
+            ret = node_for(walk, git_commit_parent_id(commit, (unsigned int)j), &parents[j]);
+        }
+
+        // node_for() may have moved the overlay
+        overlay_commit_t *entry = &walk->overlay[i];
+        entry->time = (int64_t)git_commit_time(commit);
+        entry->parents = parents;
+        entry->parent_count = count;
+        git_commit_free(commit);
+        if (ret != RELEASY_SUCCESS) return ret;
+    }
+
+    // Parents are mostly found after their children, so going backwards
+    // usually settles in one pass
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+        for (size_t i = walk->overlay_count; i-- > 0;) {
+            overlay_commit_t *entry = &walk->overlay[i];
+            uint32_t generation = 1;
+            for (size_t j = 0; j < entry->parent_count; j++) {
+                uint32_t parent = node_generation(walk, entry->parents[j]);
+                if (parent >= generation) generation = parent + 1;
+            }
+            if (generation != entry->generation) {
+                entry->generation = generation;
+                changed = 1;
+            }
+        }
+    }
+    return RELEASY_SUCCESS;
+}
+
+static int heap_push(range_walk_t *walk, uint32_t id) {
+    if (walk->heap_count == walk->heap_capacity) {
+        size_t capacity = walk->heap_capacity ? walk->heap_capacity * 2 : 256;
+        uint32_t *heap = realloc(walk->heap, capacity * sizeof(uint32_t));
+        if (!heap) return COMMIT_GRAPH_ERR_MEMORY;
+        walk->heap = heap;
+        walk->heap_capacity = capacity;
+    }
+
+    uint32_t generation = node_generation(walk, id);
+    size_t i = walk->heap_count++;
+    while (i > 0 && node_generation(walk, walk->heap[(i - 1) / 2]) < generation) {
+        walk->heap[i] = walk->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    walk->heap[i] = id;
+    return RELEASY_SUCCESS;
+}
+
+static uint32_t heap_pop(range_walk_t *walk) {
+    uint32_t top = walk->heap[0];
+    uint32_t last = walk->heap[--walk->heap_count];
+    uint32_t generation = node_generation(walk, last);
+
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= walk->heap_count) break;
+        if (child + 1 < walk->heap_count &&
+            node_generation(walk, walk->heap[child + 1]) > node_generation(walk, walk->heap[child])) {
+            child++;
+        }
+        if (node_generation(walk, walk->heap[child]) <= generation) break;
+        walk->heap[i] = walk->heap[child];
+        i = child;
+    }
+    if (walk->heap_count) walk->heap[i] = last;
+    return top;
+}
+
+// Queues id, or hides an already queued one; visible counts what is
+// queued and not hidden
+static int mark_node(range_walk_t *walk, uint32_t id, int hidden, size_t *visible) {
+    unsigned char flags = walk->flags[id];
+    if (!(flags & NODE_QUEUED)) {
+        walk->flags[id] = NODE_QUEUED | (hidden ? NODE_HIDDEN : 0);
+        if (!hidden) (*visible)++;
+        return heap_push(walk, id);
+    }
+    if (hidden && !(flags & NODE_HIDDEN)) {
+        walk->flags[id] |= NODE_HIDDEN;
+        if (!(flags & NODE_DONE)) (*visible)--;
+    }
+    return RELEASY_SUCCESS;
+}
+
+static size_t node_parents(range_walk_t *walk, uint32_t id, const uint32_t **parents) {
+    if (id >= walk->graph->count) {
+        const overlay_commit_t *entry = &walk->overlay[id - walk->graph->count];
+        *parents = entry->parents;
+        return entry->parent_count;
+    }
+
+    size_t count = commit_graph_parents(walk->graph, id, walk->parent_buffer, walk->parent_buffer_size);
+    if (count > walk->parent_buffer_size) {
+        uint32_t *buffer = realloc(walk->parent_buffer, count * sizeof(uint32_t));
+        if (!buffer) return (size_t)-1;
+        walk->parent_buffer = buffer;
+        walk->parent_buffer_size = count;
+        commit_graph_parents(walk->graph, id, walk->parent_buffer, count);
+    }
+    *parents = walk->parent_buffer;
+    return count;
+}
+
+typedef struct {
+    uint32_t generation;
+    int64_t time;
+    uint32_t order;
+    uint32_t id;
+} range_commit_t;
+
+// A child always has a higher generation than its parents, so this keeps
+// them in order even when a clock was skewed and a parent looks newer
+static int compare_range_commit(const void *a, const void *b) {
+    const range_commit_t *ra = a, *rb = b;
+    if (ra->generation != rb->generation) return ra->generation < rb->generation ? 1 : -1;
+    if (ra->time != rb->time) return ra->time < rb->time ? 1 : -1;
+    return (ra->order > rb->order) - (ra->order < rb->order);
+}
+
+/*
+ * Pops commits highest generation first, so every child is handled before
+ * its parents and a commit is known to be hidden by the time it comes off
+ * the heap. Stops once only hidden commits are left queued. Hidden commits
+ * always queue every parent, so a first-parent range still excludes all
+ * of hide's history, as `git log --first-parent` does.
+ */
+static int walk_range(range_walk_t *walk, uint32_t to, const uint32_t *hide,
+                      range_commit_t **out, size_t *count) {
+    size_t nodes = walk->graph->count + walk->overlay_count;
+    walk->flags = calloc(nodes ? nodes : 1, 1);
+    if (!walk->flags) return COMMIT_GRAPH_ERR_MEMORY;
+
+    size_t visible = 0;
+    int ret = mark_node(walk, to, 0, &visible);
+    if (ret == RELEASY_SUCCESS && hide) ret = mark_node(walk, *hide, 1, &visible);
+
+    range_commit_t *commits = NULL;
+    size_t used = 0, capacity = 0;
+    while (ret == RELEASY_SUCCESS && visible > 0 && walk->heap_count) {
+        uint32_t id = heap_pop(walk);
+        int hidden = (walk->flags[id] & NODE_HIDDEN) != 0;
+        walk->flags[id] |= NODE_DONE;
+
+        if (!hidden) {
+            visible--;
+            if (used == capacity) {
+                capacity = capacity ? capacity * 2 : 1024;
+                range_commit_t *grown = realloc(commits, capacity * sizeof(range_commit_t));
+                if (!grown) {
+                    ret = COMMIT_GRAPH_ERR_MEMORY;
+                    break;
+                }
+                commits = grown;
+            }
+            commits[used] = (range_commit_t){ node_generation(walk, id), node_time(walk, id),
+                                              (uint32_t)used, id };
+            used++;
+        }
+
+        const uint32_t *parents = NULL;
+        size_t parent_count = node_parents(walk, id, &parents);
+        if (parent_count == (size_t)-1) {
+            ret = COMMIT_GRAPH_ERR_MEMORY;
+            break;
+        }
+        if (walk->first_parent && !hidden && parent_count > 1) parent_count = 1;
+        for (size_t i = 0; ret == RELEASY_SUCCESS && i < parent_count; i++) {
+            ret = mark_node(walk, parents[i], hidden, &visible);
+        }
+    }
+
+    if (ret != RELEASY_SUCCESS) {
+        free(commits);
+        return ret;
+    }
+    // A first-parent chain comes off the heap in order already
+    if (used && !walk->first_parent) qsort(commits, used, sizeof(range_commit_t), compare_range_commit);
+    *out = commits;
+    *count = used;
+    return RELEASY_SUCCESS;
+}
+
+static int range_query(const commit_graph_t *graph, git_repository *repo, const git_oid *to,
+                       const git_oid *hide, int first_parent, git_oid **oids, size_t *count) {
+    if (!graph || !graph->map || !repo || !to || !oids || !count) return RELEASY_ERROR;
+    *oids = NULL;
+    *count = 0;
+
+    range_walk_t walk;
+    memset(&walk, 0, sizeof(range_walk_t));
+    walk.graph = graph;
+    walk.repo = repo;
+    walk.first_parent = first_parent;
+
+    uint32_t to_id = 0, hide_id = 0;
+    int ret = node_for(&walk, to, &to_id);
+    if (ret == RELEASY_SUCCESS && hide) ret = node_for(&walk, hide, &hide_id);
+    if (ret == RELEASY_SUCCESS) ret = build_overlay(&walk);
+
+    range_commit_t *commits = NULL;
+    size_t used = 0;
+    if (ret == RELEASY_SUCCESS) ret = walk_range(&walk, to_id, hide ? &hide_id : NULL, &commits, &used);
+    if (ret == RELEASY_SUCCESS && used) {
+        *oids = malloc(used * sizeof(git_oid));
+        if (!*oids) ret = COMMIT_GRAPH_ERR_MEMORY;
+    }
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < used; i++) {
+        node_oid(&walk, commits[i].id, &(*oids)[i]);
+    }
+    if (ret == RELEASY_SUCCESS) *count = used;
+
+    free(commits);
+    for (size_t i = 0; i < walk.overlay_count; i++) {
+        free(walk.overlay[i].parents);
+    }
+    free(walk.overlay);
+    free(walk.overlay_slots);
+    free(walk.flags);
+    free(walk.heap);
+    free(walk.parent_buffer);
+    return ret;
+}
+
+int commit_graph_range(const commit_graph_t *graph, git_repository *repo, const git_oid *to,
+                       const git_oid *hide, git_oid **oids, size_t *count) {
+    return range_query(graph, repo, to, hide, 0, oids, count);
+}
+
+int commit_graph_first_parent_range(const commit_graph_t *graph, git_repository *repo,
+                                    const git_oid *to, const git_oid *hide,
+                                    git_oid **oids, size_t *count) {
+    return range_query(graph, repo, to, hide, 1, oids, count);
+}
+
+void commit_graph_close(commit_graph_t *graph) {
+    if (!graph) return;
+    if (graph->map) munmap(graph->map, graph->map_size);
+    memset(graph, 0, sizeof(commit_graph_t));
+}
+
+const char *commit_graph_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case COMMIT_GRAPH_ERR_NOT_FOUND:
+            return "No commit-graph file";
+        case COMMIT_GRAPH_ERR_CORRUPT:
+            return "Commit-graph file is corrupt or unsupported";
+        case COMMIT_GRAPH_ERR_FILE_ACCESS:
+            return "Failed to access commit-graph file";
+        case COMMIT_GRAPH_ERR_MEMORY:
+            return "Memory allocation failed";
+        case COMMIT_GRAPH_ERR_STALE:
+            return "Commit-graph is too far behind the repository";
+        case COMMIT_GRAPH_ERR_GIT_OPERATION:
+            return "Failed to read a commit missing from the commit-graph";
+        default:
+            return "Unknown error";
+    }
+}
@@ -0,0 +1,91 @@
+#define _POSIX_C_SOURCE 200809L
+#include <string.h>
+#include <time.h>
+#include "date_cache.h"
+#include "releasy.h"
+
+#define SECONDS_PER_DAY 86400
+
+static int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+static int format_tm(const struct tm *tm, char *buf) {
+    return strftime(buf, DATE_DAY_LENGTH + 1, "%Y-%m-%d", tm) == DATE_DAY_LENGTH ? 0 : -1;
+}
+
+int date_format_day(int64_t timestamp, char *buf) {
+    time_t when = (time_t)timestamp;
+    struct tm tm;
+    if (!localtime_r(&when, &tm)) return RELEASY_ERROR;
+    return format_tm(&tm, buf) == 0 ? RELEASY_SUCCESS : RELEASY_ERROR;
+}
+
+static int is_clock(const struct tm *tm, int yday, int hour, int min, int sec) {
+    return tm->tm_yday == yday && tm->tm_hour == hour && tm->tm_min == min && tm->tm_sec == sec;
+}
+
+/*
+ * Formats the day holding timestamp and works out where it starts and ends.
+ * Midnight is the wall clock wound back; the span is only kept when the
+ * first and last second of it still read 00:00:00 and 23:59:59 on the same
+ * day, i.e. the offset from UTC held all day. Returns 1 for a whole day,
+ * 0 for a formatted day that must not be cached, -1 on failure.
+ */
+static int day_span(int64_t timestamp, date_span_t *span) {
+    time_t when = (time_t)timestamp;
+    struct tm tm;
+    if (!localtime_r(&when, &tm) || format_tm(&tm, span->day) != 0) return -1;
+
+    int64_t midnight = timestamp - (tm.tm_hour * 3600 + tm.tm_min * 60 + tm.tm_sec);
+    time_t first = (time_t)midnight, last = (time_t)(midnight + SECONDS_PER_DAY - 1);
+    struct tm first_tm, last_tm;
+    if (!localtime_r(&first, &first_tm) || !is_clock(&first_tm, tm.tm_yday, 0, 0, 0)) return 0;
+    if (!localtime_r(&last, &last_tm) || !is_clock(&last_tm, tm.tm_yday, 23, 59, 59)) return 0;
+
+    span->start = midnight;
+    span->end = midnight + SECONDS_PER_DAY;
+    return 1;
+}
+
+void date_cache_init(date_cache_t *cache) {
+    memset(cache, 0, sizeof(date_cache_t));
+    for (size_t i = 0; i < DATE_CACHE_SLOTS; i++) {
+        cache->slots[i].utc_day = INT64_MIN;
+    }
+}
+
+const char *date_cache_day(date_cache_t *cache, int64_t timestamp) {
+    int64_t utc_day = floor_div(timestamp, SECONDS_PER_DAY);
+    date_slot_t *slot = &cache->slots[(uint64_t)utc_day % DATE_CACHE_SLOTS];
+
+    if (slot->utc_day == utc_day) {
+        for (int i = 0; i < 2; i++) {
+            const date_span_t *span = &slot->spans[i];
+            if (timestamp >= span->start && timestamp < span->end) {
+                cache->hits++;
+                return span->day;
+            }
+        }
+    } else {
+        memset(slot, 0, sizeof(date_slot_t));
+        slot->utc_day = utc_day;
+    }
+    cache->misses++;
+
+    date_span_t span;
+    switch (day_span(timestamp, &span)) {
+        case 1: {
+            // The local day the UTC day starts in, or the one it ends in
+            date_span_t *kept = &slot->spans[span.start <= utc_day * SECONDS_PER_DAY ? 0 : 1];
+            *kept = span;
+            return kept->day;
+        }
+        case 0:
+            memcpy(cache->scratch, span.day, sizeof(cache->scratch));
+            return cache->scratch;
+        default:
+            return NULL;
+    }
+}
@@ -4,6 +4,9 @@
 #include "git_ops.h"
 #include "releasy.h"
 #include "semver.h"
+#include "version_list.h"
+#include "tag_index.h"
+#include "worktree_status.h"
 
 static int git_ops_get_signature(git_context_t *ctx) {
     if (ctx->signature) return RELEASY_SUCCESS;
@@ -43,26 +46,21 @@ int git_ops_set_user(git_context_t *ctx, const char *name, const char *email) {
 int git_ops_get_user_from_git(git_context_t *ctx) {
     if (!ctx || !ctx->repo) return RELEASY_ERROR;
     
-    git_config *cfg;
-    int error = git_repository_config(&cfg, ctx->repo);
-    if (error) return GIT_ERR_NO_USER_CONFIG;
-    
-    const char *name = NULL;
-    error = git_config_get_string(&name, cfg, "user.name");
-    if (error) {
-        git_config_free(cfg);
-        return GIT_ERR_NO_USER_CONFIG;
+    // Strings from git_config_get_string need a read-only config, so a
+    // snapshot is taken unless one was lent to us
+    git_config *cfg = ctx->config;
+    if (!cfg) {
+        int error = git_repository_config_snapshot(&cfg, ctx->repo);
+        if (error) return GIT_ERR_NO_USER_CONFIG;
     }
     
+    const char *name = NULL;
     const char *email = NULL;
-    error = git_config_get_string(&email, cfg, "user.email");
-    if (error) {
-        git_config_free(cfg);
-        return GIT_ERR_NO_USER_CONFIG;
-    }
+    int error = git_config_get_string(&name, cfg, "user.name");
+    if (!error) error = git_config_get_string(&email, cfg, "user.email");
     
-    error = git_ops_set_user(ctx, name, email);
-    git_config_free(cfg);
+    error = error ? GIT_ERR_NO_USER_CONFIG : git_ops_set_user(ctx, name, email);
+    if (cfg != ctx->config) git_config_free(cfg);
     return error;
 }
 
@@ -107,14 +105,9 @@ int git_ops_init(git_context_t *ctx) {
     return RELEASY_SUCCESS;
 }
 
-int git_ops_open_repo(git_context_t *ctx, const char *path) {
-    if (!ctx || !path) return RELEASY_ERROR;
-    
-    int error = git_repository_open(&ctx->repo, path);
-    if (error) return GIT_ERR_REPO_NOT_FOUND;
-    
+static int load_current_branch(git_context_t *ctx) {
     git_reference *head = NULL;
-    error = git_repository_head(&head, ctx->repo);
+    int error = git_repository_head(&head, ctx->repo);
     if (!error) {
         const char *branch_name = git_reference_shorthand(head);
         if (branch_name) {
@@ -127,91 +120,74 @@ int git_ops_open_repo(git_context_t *ctx, const char *path) {
         git_reference_free(head);
     }
     
-    return git_ops_check_dirty(ctx);
+    return RELEASY_SUCCESS;
 }
 
-int git_ops_check_dirty(git_context_t *ctx) {
-    if (!ctx || !ctx->repo) return RELEASY_ERROR;
+int git_ops_open_repo(git_context_t *ctx, const char *path) {
+    if (!ctx || !path) return RELEASY_ERROR;
     
-    git_status_options opts = GIT_STATUS_OPTIONS_INIT;
-    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
-    opts.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED;
+    int error = git_repository_open(&ctx->repo, path);
+    if (error) return GIT_ERR_REPO_NOT_FOUND;
     
-    git_status_list *status = NULL;
-    int error = git_status_list_new(&status, ctx->repo, &opts);
+    error = load_current_branch(ctx);
     if (error) return error;
     
-    size_t count = git_status_list_entrycount(status);
-    ctx->is_dirty = count > 0;
-    
-    git_status_list_free(status);
-    return RELEASY_SUCCESS;
+    return git_ops_check_dirty(ctx);
 }
 
-static int tag_sorting_callback(const void *a, const void *b) {
-    const char *tag_a = *(const char **)a;
-    const char *tag_b = *(const char **)b;
+/*
+ * Works on a repository opened elsewhere, usually the process-wide repo
+ * session. The handles are borrowed and git_ops_cleanup() leaves them open.
+ * Unlike git_ops_open_repo() this doesn't scan the worktree; call
+ * git_ops_check_dirty() when is_dirty is needed.
+ */
+int git_ops_use_repo(git_context_t *ctx, git_repository *repo, git_config *config) {
+    if (!ctx || !repo || ctx->repo) return RELEASY_ERROR;
     
-    // Skip 'v' prefix if present
-    if (tag_a[0] == 'v') tag_a++;
-    if (tag_b[0] == 'v') tag_b++;
+    ctx->repo = repo;
+    ctx->config = config;
+    ctx->borrowed = 1;
     
-    semver_t ver_a, ver_b;
-    semver_init(&ver_a);
-    semver_init(&ver_b);
-    
-    if (semver_parse(tag_a, &ver_a) != 0 || semver_parse(tag_b, &ver_b) != 0) {
-        semver_free(&ver_a);
-        semver_free(&ver_b);
-        return 0;
-    }
+    return load_current_branch(ctx);
+}
+
+int git_ops_check_dirty(git_context_t *ctx) {
+    if (!ctx || !ctx->repo) return RELEASY_ERROR;
     
-    int result = semver_compare(&ver_a, &ver_b);
-    semver_free(&ver_a);
-    semver_free(&ver_b);
-    return result;
+    return worktree_status_scan(ctx->repo, NULL, &ctx->is_dirty, NULL);
 }
 
-int git_ops_list_tags(git_context_t *ctx, char ***tags, size_t *count) {
-    if (!ctx || !ctx->repo || !tags || !count) return RELEASY_ERROR;
+// Every dirty path, for showing the user; free with worktree_report_cleanup()
+int git_ops_status_report(git_context_t *ctx, worktree_report_t *report) {
+    if (!ctx || !ctx->repo || !report) return RELEASY_ERROR;
     
+    return worktree_status_scan(ctx->repo, NULL, &ctx->is_dirty, report);
+}
+
+// Version tags, oldest first, through the shared version list
+static int list_version_tags(git_context_t *ctx, char ***tags, size_t *count) {
     *tags = NULL;
     *count = 0;
     
-    git_strarray tag_array;
-    int error = git_tag_list(&tag_array, ctx->repo);
-    if (error) return GIT_ERR_NO_TAGS;
+    version_list_t list;
+    version_list_init(&list);
     
-    if (tag_array.count == 0) {
-        git_strarray_free(&tag_array);
+    int error = version_list_load(&list, ctx->repo);
+    if (error != RELEASY_SUCCESS || list.count == 0) {
+        version_list_cleanup(&list);
         return GIT_ERR_NO_TAGS;
     }
     
-    *tags = calloc(tag_array.count, sizeof(char *));
-    if (!*tags) {
-        git_strarray_free(&tag_array);
-        return RELEASY_ERROR;
-    }
-    
-    *count = tag_array.count;
-    for (size_t i = 0; i < tag_array.count; i++) {
-        (*tags)[i] = strdup(tag_array.strings[i]);
-        if (!(*tags)[i]) {
-            for (size_t j = 0; j < i; j++) {
-                free((*tags)[j]);
-            }
-            free(*tags);
-            *tags = NULL;
-            *count = 0;
-            git_strarray_free(&tag_array);
-            return RELEASY_ERROR;
-        }
-    }
+    error = version_list_detach(&list, tags, count);
     
-    qsort(*tags, *count, sizeof(char *), tag_sorting_callback);
-    git_strarray_free(&tag_array);
+    version_list_cleanup(&list);
+    return error;
+}
+
+int git_ops_list_tags(git_context_t *ctx, char ***tags, size_t *count) {
+    if (!ctx || !ctx->repo || !tags || !count) return RELEASY_ERROR;
     
-    return RELEASY_SUCCESS;
+    return list_version_tags(ctx, tags, count);
 }
 
 int git_ops_get_latest_tag(git_context_t *ctx, char **tag) {
@@ -224,8 +200,8 @@ int git_ops_get_latest_tag(git_context_t *ctx, char **tag) {
     int error = git_ops_list_tags(ctx, &tags, &count);
     if (error) return error;
     
-    if (count > 0 && tags[0]) {
-        *tag = strdup(tags[0]);
+    if (count > 0 && tags[count - 1]) {
+        *tag = strdup(tags[count - 1]);
         if (!*tag) {
             error = RELEASY_ERROR;
         }
@@ -239,30 +215,20 @@ int git_ops_get_latest_tag(git_context_t *ctx, char **tag) {
     return error;
 }
 
-int git_ops_get_latest_version(git_context_t *ctx, char *version, size_t size) {
+int git_ops_find_latest_version(git_context_t *ctx, const version_filter_t *filter,
+                                char *version, size_t size) {
     if (!ctx || !version || size == 0) return RELEASY_ERROR;
+    if (!ctx->repo) return GIT_ERR_NO_TAGS;
 
-    git_strarray tags = {0};
-    int ret = git_tag_list(&tags, ctx->repo);
-    if (ret != 0) return GIT_ERR_NO_TAGS;
-
-    if (tags.count == 0) {
-        git_strarray_free(&tags);
+    int ret = version_list_select_latest(ctx->repo, filter, version, size);
+    if (ret == VERSION_LIST_ERR_NOT_FOUND || ret == VERSION_LIST_ERR_GIT_OPERATION) {
         return GIT_ERR_NO_TAGS;
     }
+    return ret == RELEASY_SUCCESS ? RELEASY_SUCCESS : RELEASY_ERROR;
+}
 
-    // Sort tags by version
-    qsort(tags.strings, tags.count, sizeof(char *), tag_sorting_callback);
-
-    // Get the latest version (last in sorted array)
-    const char *latest = tags.strings[tags.count - 1];
-    if (latest[0] == 'v') latest++; // Skip 'v' prefix if present
-
-    strncpy(version, latest, size - 1);
-    version[size - 1] = '\0';
-
-    git_strarray_free(&tags);
-    return RELEASY_SUCCESS;
+int git_ops_get_latest_version(git_context_t *ctx, char *version, size_t size) {
+    return git_ops_find_latest_version(ctx, NULL, version, size);
 }
 
 int git_ops_create_tag(git_context_t *ctx, const char *version, const char *user_name, const char *user_email) {
@@ -293,10 +259,20 @@ int git_ops_create_tag(git_context_t *ctx, const char *version, const char *user
     char tag_message[256];
     snprintf(tag_message, sizeof(tag_message), "Release version %s", version);
 
-    ret = git_tag_create(NULL, ctx->repo, tag_name, head, tagger, tag_message, 0);
+    // The tag index compares against this to see what else changed
+    tag_index_stamp_t refs_before;
+    int stamped = tag_index_read_stamp(ctx->repo, &refs_before) == RELEASY_SUCCESS;
+
+    // libgit2 writes the new object's id out, so it cannot be NULL
+    git_oid tag_id;
+    ret = git_tag_create(&tag_id, ctx->repo, tag_name, head, tagger, tag_message, 0);
     if (ret != 0) {
         // Try lightweight tag if annotated tag fails
-        ret = git_tag_create_lightweight(NULL, ctx->repo, tag_name, head, 0);
+        ret = git_tag_create_lightweight(&tag_id, ctx->repo, tag_name, head, 0);
+    }
+
+    if (ret == 0 && stamped) {
+        tag_index_note_created(ctx->repo, &refs_before, tag_name, git_object_id(head));
     }
 
     git_object_free(head);
@@ -390,7 +366,7 @@ void git_ops_cleanup(git_context_t *ctx) {
     if (!ctx) return;
     
     if (ctx->signature) git_signature_free(ctx->signature);
-    if (ctx->repo) git_repository_free(ctx->repo);
+    if (ctx->repo && !ctx->borrowed) git_repository_free(ctx->repo);
     free(ctx->current_branch);
     free(ctx->latest_tag);
     free(ctx->user_name);
@@ -464,55 +440,5 @@ int git_ops_is_version_tag(git_context_t *ctx, const char *tag_name) {
 int git_ops_get_version_history(git_context_t *ctx, char ***versions, size_t *count) {
     if (!ctx || !versions || !count) return RELEASY_ERROR;
 
-    *versions = NULL;
-    *count = 0;
-
-    git_strarray tags;
-    int ret = git_tag_list(&tags, ctx->repo);
-    if (ret != 0) return GIT_ERR_NO_TAGS;
-
-    // Count version tags
-    size_t version_count = 0;
-    for (size_t i = 0; i < tags.count; i++) {
-        if (git_ops_is_version_tag(ctx, tags.strings[i])) {
-            version_count++;
-        }
-    }
-
-    if (version_count == 0) {
-        git_strarray_free(&tags);
-        return GIT_ERR_NO_TAGS;
-    }
-
-    // Allocate memory for version array
-    *versions = calloc(version_count, sizeof(char *));
-    if (!*versions) {
-        git_strarray_free(&tags);
-        return RELEASY_ERROR;
-    }
-
-    // Copy version tags
-    size_t j = 0;
-    for (size_t i = 0; i < tags.count; i++) {
-        if (git_ops_is_version_tag(ctx, tags.strings[i])) {
-            (*versions)[j] = strdup(tags.strings[i]);
-            if (!(*versions)[j]) {
-                for (size_t k = 0; k < j; k++) {
-                    free((*versions)[k]);
-                }
-                free(*versions);
-                *versions = NULL;
-                git_strarray_free(&tags);
-                return RELEASY_ERROR;
-            }
-            j++;
-        }
-    }
-
-    *count = version_count;
-    git_strarray_free(&tags);
-
-    // Sort versions
-    qsort(*versions, *count, sizeof(char *), tag_sorting_callback);
-    return RELEASY_SUCCESS;
-} 
\ No newline at end of file
+    return list_version_tags(ctx, versions, count);
+}
@@ -6,6 +6,7 @@
 #include <getopt.h>
 #include <errno.h>
 #include <ctype.h>
+#include <limits.h>
 #include "releasy.h"
 #include "git_ops.h"
 #include "deploy.h"
@@ -14,6 +15,9 @@
 #include "config.h"
 #include "init.h"
 #include "changelog.h"
+#include "changelog_render.h"
+#include "changelog_index.h"
+#include "repo_session.h"
 
 releasy_config_t g_config = {0};
 
@@ -31,6 +35,16 @@ static struct option long_options[] = {
     {"no-metadata", no_argument, 0, 't'},
     {"no-authors", no_argument, 0, 'a'},
     {"backup-changelog", no_argument, 0, 'b'},
+    {"path", required_argument, 0, 'p'},
+    {"first-parent", no_argument, 0, 'f'},
+    {"expand-merges", no_argument, 0, 'x'},
+    {"cherry-pick", no_argument, 0, 'k'},
+    {"compare", required_argument, 0, 'r'},
+    {"group-scope", no_argument, 0, 's'},
+    {"format", required_argument, 0, 'F'},
+    {"contributors", no_argument, 0, 'C'},
+    {"backup-keep", required_argument, 0, 'K'},
+    {"backup-max-age", required_argument, 0, 'A'},
     {0, 0, 0, 0}
 };
 
@@ -49,10 +63,21 @@ static void print_usage(void) {
            "  -g, --no-group-changelog Don't group changelog by commit type\n"
            "  -t, --no-metadata       Don't include metadata in changelog\n"
            "  -a, --no-authors        Don't include authors in changelog\n"
-           "  -b, --backup-changelog  Create backup of existing changelog\n\n"
+           "  -b, --backup-changelog  Create backup of existing changelog\n"
+           "  -K, --backup-keep       Changelog backups to keep, 0 for all (default)\n"
+           "  -A, --backup-max-age    Remove changelog backups older than this many days\n"
+           "  -p, --path              Only include commits touching this directory\n"
+           "  -f, --first-parent      List merges by pull request title, not their commits\n"
+           "  -x, --expand-merges     With --first-parent, list each merge's commits too\n"
+           "  -k, --cherry-pick       Leave out cherry-picked duplicates and reverted commits\n"
+           "  -r, --compare           With --cherry-pick, leave out changes this branch has\n"
+           "  -s, --group-scope       Within each type, list commits of one scope together\n"
+           "  -F, --format            Changelog formats to write: md,json,html\n"
+           "  -C, --contributors      Credit each release's authors with their commit counts\n\n"
            "Commands:\n"
            "  init      Initialize release configuration\n"
            "  release   Create a new release\n"
+           "  changelog show VERSION  Print one version's section of the changelog\n"
            "  deploy    Deploy to target environment\n"
            "  rollback  Revert to previous release\n");
 }
@@ -67,8 +92,10 @@ int releasy_parse_args(int argc, char **argv) {
     g_config.changelog_include_metadata = 1;
     g_config.changelog_include_authors = 1;
     g_config.changelog_backup = 0;
+    g_config.changelog_backup_keep = 0;
+    g_config.changelog_formats = CHANGELOG_FORMAT_MARKDOWN;
 
-    while ((opt = getopt_long(argc, argv, "hvdc:e:n:m:il:gtab",
+    while ((opt = getopt_long(argc, argv, "hvdc:e:n:m:il:gtabp:fxkr:sF:CK:A:",
            long_options, &option_index)) != -1) {
         switch (opt) {
             case 'h':
@@ -115,6 +142,53 @@ int releasy_parse_args(int argc, char **argv) {
             case 'b':
                 g_config.changelog_backup = 1;
                 break;
+            case 'p':
+                free(g_config.changelog_scope);
+                g_config.changelog_scope = strdup(optarg);
+                break;
+            case 'f':
+                g_config.changelog_first_parent = 1;
+                break;
+            case 'x':
+                g_config.changelog_expand_merges = 1;
+                break;
+            case 'k':
+                g_config.changelog_cherry_pick = 1;
+                break;
+            case 'r':
+                free(g_config.changelog_compare);
+                g_config.changelog_compare = strdup(optarg);
+                g_config.changelog_cherry_pick = 1;
+                break;
+            case 's':
+                g_config.changelog_group_by_scope = 1;
+                break;
+            case 'F':
+                if (changelog_parse_formats(optarg, &g_config.changelog_formats) != RELEASY_SUCCESS) {
+                    fprintf(stderr, "Error: Unknown changelog format list '%s'\n", optarg);
+                    return RELEASY_ERROR;
+                }
+                break;
+            case 'C':
+                g_config.changelog_include_contributors = 1;
+                break;
+            case 'K':
+            case 'A': {
+                char *end;
+                errno = 0;
+                long value = strtol(optarg, &end, 10);
+                if (errno || end == optarg || *end || value < 0 || value > INT_MAX / 86400) {
+                    fprintf(stderr, "Error: Invalid number '%s'\n", optarg);
+                    return RELEASY_ERROR;
+                }
+                if (opt == 'K') {
+                    g_config.changelog_backup_keep = (int)value;
+                } else {
+                    g_config.changelog_backup_max_age_days = (int)value;
+                }
+                g_config.changelog_backup = 1;
+                break;
+            }
             default:
                 return RELEASY_ERROR;
         }
@@ -128,6 +202,11 @@ int releasy_ensure_user_config(void) {
     int ret = git_ops_init(&ctx);
     if (ret != RELEASY_SUCCESS) return ret;
 
+    // Outside a repository only the CLI and environment can provide the user
+    if (repo_session_is_open()) {
+        git_ops_use_repo(&ctx, repo_session_repo(), repo_session_config());
+    }
+
     // If user info was provided via CLI, use it
     if (g_config.user_name && g_config.user_email) {
         ret = git_ops_set_user(&ctx, g_config.user_name, g_config.user_email);
@@ -185,11 +264,14 @@ int releasy_ensure_user_config(void) {
 }
 
 void releasy_cleanup(void) {
+    repo_session_close();
     free(g_config.config_path);
     free(g_config.target_env);
     free(g_config.user_name);
     free(g_config.user_email);
     free(g_config.changelog_path);
+    free(g_config.changelog_scope);
+    free(g_config.changelog_compare);
 }
 
 static int handle_deploy_command(int argc, char **argv) {
@@ -347,6 +429,80 @@ static int handle_init_command(const char *config_path, const char *user_name, c
     return init_project(config_path ? config_path : "config/releasy.json", user_name, user_email);
 }
 
+// The full status walk is only worth it when someone is there to read it
+static void print_dirty_paths(git_context_t *ctx) {
+    worktree_report_t report;
+    if (git_ops_status_report(ctx, &report) != RELEASY_SUCCESS) return;
+
+    for (size_t i = 0; i < report.count; i++) {
+        unsigned int status = report.changes[i].status;
+
+        const char *label = "modified";
+        if (status & GIT_STATUS_WT_NEW) {
+            label = "untracked";
+        } else if (status & GIT_STATUS_CONFLICTED) {
+            label = "conflicted";
+        } else if (status & (GIT_STATUS_INDEX_NEW | GIT_STATUS_INDEX_MODIFIED |
+                             GIT_STATUS_INDEX_DELETED | GIT_STATUS_INDEX_RENAMED |
+                             GIT_STATUS_INDEX_TYPECHANGE)) {
+            label = "staged";
+        } else if (status & GIT_STATUS_WT_DELETED) {
+            label = "deleted";
+        }
+        fprintf(stderr, "  %-10s %s\n", label, report.changes[i].path);
+    }
+
+    worktree_report_cleanup(&report);
+}
+
+// Prints a section straight from the mapped changelog. Inside a repository
+// the section index is kept in .git/releasy between runs.
+static int handle_changelog_command(int argc, char **argv) {
+    if (optind >= argc || strcmp(argv[optind], "show") != 0 || optind + 1 >= argc) {
+        fprintf(stderr, "Error: Usage: releasy changelog show VERSION\n");
+        return RELEASY_ERROR;
+    }
+    const char *version = argv[optind + 1];
+
+    char *cache_path = NULL;
+    if (repo_session_is_open()) {
+        cache_path = changelog_index_cache_path(git_repository_commondir(repo_session_repo()),
+                                                g_config.changelog_path);
+    }
+
+    changelog_index_t index;
+    int ret = changelog_index_open(&index, g_config.changelog_path, cache_path);
+    free(cache_path);
+    if (ret != RELEASY_SUCCESS) {
+        fprintf(stderr, "Error: Failed to read %s: %s\n", g_config.changelog_path, changelog_error_string(ret));
+        return ret;
+    }
+
+    const char *section;
+    size_t length;
+    ret = changelog_index_find(&index, version, &section, &length);
+    if (ret != RELEASY_SUCCESS) {
+        fprintf(stderr, "Error: %s: %s\n", changelog_error_string(ret), version);
+        changelog_index_close(&index);
+        return ret;
+    }
+
+    fflush(stdout);
+    while (length > 0) {
+        ssize_t written = write(STDOUT_FILENO, section, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            ret = CHANGELOG_ERR_FILE_ACCESS;
+            break;
+        }
+        section += written;
+        length -= (size_t)written;
+    }
+
+    changelog_index_close(&index);
+    return ret;
+}
+
 static int handle_release_command(void) {
     git_context_t ctx;
     int ret = git_ops_init(&ctx);
@@ -355,10 +511,27 @@ static int handle_release_command(void) {
         return ret;
     }
 
-    // Check if working directory is clean
+    if (!repo_session_is_open()) {
+        fprintf(stderr, "Error: %s\n", repo_session_error_string(REPO_SESSION_ERR_NOT_FOUND));
+        git_ops_cleanup(&ctx);
+        return GIT_ERR_REPO_NOT_FOUND;
+    }
+
+    ret = git_ops_use_repo(&ctx, repo_session_repo(), repo_session_config());
+    if (ret != RELEASY_SUCCESS) {
+        fprintf(stderr, "Error: Failed to initialize git context\n");
+        git_ops_cleanup(&ctx);
+        return ret;
+    }
+
+    // Check if working directory is clean; this stops at the first change
     ret = git_ops_check_dirty(&ctx);
+    if (ret == RELEASY_SUCCESS && ctx.is_dirty) ret = GIT_ERR_DIRTY_REPO;
     if (ret != RELEASY_SUCCESS) {
         fprintf(stderr, "Error: Working directory is not clean. Please commit or stash your changes.\n");
+        if (ret == GIT_ERR_DIRTY_REPO && g_config.interactive) {
+            print_dirty_paths(&ctx);
+        }
         git_ops_cleanup(&ctx);
         return ret;
     }
@@ -448,53 +621,76 @@ static int handle_release_command(void) {
         git_ops_cleanup(&ctx);
         return ret;
     }
+    changelog.walk.path = g_config.changelog_scope;
+    changelog.walk.first_parent = g_config.changelog_first_parent;
+    changelog.walk.expand_merges = g_config.changelog_expand_merges;
+    changelog.walk.cherry_pick = g_config.changelog_cherry_pick;
+    changelog.walk.compare = g_config.changelog_compare;
+    changelog.group_by_scope = g_config.changelog_group_by_scope;
+    changelog.formats = g_config.changelog_formats;
+    changelog.include_contributors = g_config.changelog_include_contributors;
+    changelog.backup = g_config.changelog_backup;
+    changelog.backup_policy.keep = (size_t)g_config.changelog_backup_keep;
+    changelog.backup_policy.max_age = (int64_t)g_config.changelog_backup_max_age_days * 86400;
+
+    // Without a preview to show, render the changelog while walking history.
+    // The other formats are rendered from the collected commits.
+    if (!g_config.interactive && changelog.formats == CHANGELOG_FORMAT_MARKDOWN) {
+        ret = changelog_generate_stream(&changelog, ctx.repo, new_version);
+        if (ret != RELEASY_SUCCESS) {
+            fprintf(stderr, "Error: Failed to generate changelog: %s\n", changelog_error_string(ret));
+            changelog_cleanup(&changelog);
+            git_ops_cleanup(&ctx);
+            return ret;
+        }
+    } else {
+        ret = changelog_generate(&changelog, ctx.repo, new_version);
+        if (ret != RELEASY_SUCCESS) {
+            fprintf(stderr, "Error: Failed to generate changelog: %s\n", changelog_error_string(ret));
+            changelog_cleanup(&changelog);
+            git_ops_cleanup(&ctx);
+            return ret;
+        }
 
-    ret = changelog_generate(&changelog, ctx.repo, new_version);
-    if (ret != RELEASY_SUCCESS) {
-        fprintf(stderr, "Error: Failed to generate changelog: %s\n", changelog_error_string(ret));
-        changelog_cleanup(&changelog);
-        git_ops_cleanup(&ctx);
-        return ret;
-    }
-
-    // If in interactive mode, preview changelog
-    if (g_config.interactive) {
-        printf("\nChangelog preview for version %s:\n", new_version);
-        printf("----------------------------------------\n");
-        changelog_entry_t *entry = changelog.entries[changelog.count - 1];
-        if (entry->commits) {
-            for (size_t i = 0; i < entry->count; i++) {
-                commit_info_t *commit = entry->commits[i];
-                printf("* %s: %s", changelog_commit_type_string(commit->type),
-                       commit->description);
-                if (commit->is_breaking) {
-                    printf(" [BREAKING]");
+        if (g_config.interactive) {
+            // Preview changelog
+            printf("\nChangelog preview for version %s:\n", new_version);
+            printf("----------------------------------------\n");
+            changelog_entry_t *entry = changelog.entries[changelog.count - 1];
+            if (entry->commits) {
+                for (size_t i = 0; i < entry->count; i++) {
+                    commit_info_t *commit = entry->commits[i];
+                    printf("* %s: %s", changelog_commit_type_string(commit->type),
+                           commit->description);
+                    if (commit->is_breaking) {
+                        printf(" [BREAKING]");
+                    }
+                    printf("\n");
                 }
-                printf("\n");
             }
-        }
-        printf("----------------------------------------\n");
-        printf("Proceed with release? [y/N]: ");
-
-        char choice[8];
-        if (fgets(choice, sizeof(choice), stdin)) {
-            choice[strcspn(choice, "\n")] = 0;
-            if (tolower(choice[0]) != 'y') {
-                printf("Release cancelled\n");
-                changelog_cleanup(&changelog);
-                git_ops_cleanup(&ctx);
-                return RELEASY_SUCCESS;
+            printf("----------------------------------------\n");
+            printf("Proceed with release? [y/N]: ");
+
+            char choice[8];
+            if (fgets(choice, sizeof(choice), stdin)) {
+                choice[strcspn(choice, "\n")] = 0;
+                if (tolower(choice[0]) != 'y') {
+                    printf("Release cancelled\n");
+                    changelog_cleanup(&changelog);
+                    git_ops_cleanup(&ctx);
+                    return RELEASY_SUCCESS;
+                }
             }
         }
-    }
 
-    // Write changelog
-    ret = changelog_write(&changelog);
-    if (ret != RELEASY_SUCCESS) {
-        fprintf(stderr, "Error: Failed to write changelog: %s\n", changelog_error_string(ret));
-        changelog_cleanup(&changelog);
-        git_ops_cleanup(&ctx);
-        return ret;
+        // Write changelog
+        ret = changelog_write(&changelog);
+        if (ret != RELEASY_SUCCESS) {
+            fprintf(stderr, "Error: Failed to write changelog: %s\n", changelog_error_string(ret));
+            changelog_cleanup(&changelog);
+            git_ops_cleanup(&ctx);
+            return ret;
+        }
     }
 
     // Create release tag
@@ -523,10 +719,11 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    ret = releasy_ensure_user_config();
-    if (ret != RELEASY_SUCCESS) {
-        fprintf(stderr, "Error: %s\n", git_ops_error_string(ret));
-        fprintf(stderr, "Please configure git user.name and user.email, or use --user-name and --user-email options\n");
+    // Open the repository once for the whole command. Not being in one is
+    // only an error for commands that need it.
+    ret = repo_session_open(".");
+    if (ret != RELEASY_SUCCESS && ret != REPO_SESSION_ERR_NOT_FOUND) {
+        fprintf(stderr, "Error: %s\n", repo_session_error_string(ret));
         return ret;
     }
 
@@ -536,6 +733,16 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    // Reading the changelog commits nothing, so needs no identity
+    if (strcmp(command, "changelog") != 0) {
+        ret = releasy_ensure_user_config();
+        if (ret != RELEASY_SUCCESS) {
+            fprintf(stderr, "Error: %s\n", git_ops_error_string(ret));
+            fprintf(stderr, "Please configure git user.name and user.email, or use --user-name and --user-email options\n");
+            return ret;
+        }
+    }
+
     optind++;  // Move past the command
 
     if (strcmp(command, "deploy") == 0) {
@@ -546,6 +753,8 @@ int main(int argc, char **argv) {
         ret = handle_init_command(g_config.config_path, g_config.user_name, g_config.user_email);
     } else if (strcmp(command, "release") == 0) {
         ret = handle_release_command();
+    } else if (strcmp(command, "changelog") == 0) {
+        ret = handle_changelog_command(argc, argv);
     } else {
         fprintf(stderr, "Error: Unknown command: %s\n", command);
         print_usage();
@@ -0,0 +1,337 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include "patch_id.h"
+#include "sidecar.h"
+
+// Commits a worker claims at a time
+#define PATCH_ID_SLICE 16
+
+// Below this many misses threads cost more than they save
+#define PATCH_ID_MIN_PARALLEL 64
+
+static char *cache_file_path(git_repository *repo) {
+    return sidecar_path(git_repository_commondir(repo), PATCH_ID_CACHE_FILE);
+}
+
+static int compare_entry(const void *a, const void *b) {
+    return memcmp(((const patch_id_entry_t *)a)->commit, ((const patch_id_entry_t *)b)->commit,
+                  GIT_OID_RAWSZ);
+}
+
+static int map_cache(patch_id_cache_t *cache, git_repository *repo) {
+    char *path = cache_file_path(repo);
+    if (!path) return PATCH_ID_ERR_MEMORY;
+
+    void *map = NULL;
+    size_t size = 0;
+    int ret = sidecar_map(path, sizeof(patch_id_header_t), &map, &size, NULL);
+    free(path);
+    if (ret != RELEASY_SUCCESS) return ret == SIDECAR_ERR_CORRUPT ? PATCH_ID_ERR_CORRUPT : PATCH_ID_ERR_FILE_ACCESS;
+
+    const patch_id_header_t *header = map;
+    if (memcmp(header->magic, PATCH_ID_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->format != PATCH_ID_CACHE_FORMAT ||
+        header->byte_order != SIDECAR_BYTE_ORDER ||
+        header->entry_size != sizeof(patch_id_entry_t) ||
+        sizeof(patch_id_header_t) + (uint64_t)header->count * sizeof(patch_id_entry_t) != (uint64_t)size) {
+        munmap(map, size);
+        return PATCH_ID_ERR_CORRUPT;
+    }
+
+    cache->map = map;
+    cache->map_size = size;
+    cache->entries = (const patch_id_entry_t *)((const char *)map + sizeof(patch_id_header_t));
+    cache->count = header->count;
+    return RELEASY_SUCCESS;
+}
+
+int patch_id_cache_open(patch_id_cache_t *cache, git_repository *repo) {
+    if (!cache || !repo) return RELEASY_ERROR;
+
+    memset(cache, 0, sizeof(patch_id_cache_t));
+    int ret = map_cache(cache, repo);
+    return ret == PATCH_ID_ERR_MEMORY ? ret : RELEASY_SUCCESS;
+}
+
+int patch_id_cache_lookup(const patch_id_cache_t *cache, const git_oid *oid, patch_id_entry_t *entry) {
+    if (!cache || !oid || !entry) return 0;
+
+    size_t lo = 0, hi = cache->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = memcmp(cache->entries[mid].commit, oid->id, GIT_OID_RAWSZ);
+        if (cmp == 0) {
+            *entry = cache->entries[mid];
+            return 1;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return 0;
+}
+
+int patch_id_cache_add(patch_id_cache_t *cache, const patch_id_entry_t *entry) {
+    if (!cache || !entry) return RELEASY_ERROR;
+
+    if (cache->added_count == cache->added_capacity) {
+        size_t capacity = cache->added_capacity ? cache->added_capacity * 2 : 256;
+        patch_id_entry_t *grown = realloc(cache->added, capacity * sizeof(patch_id_entry_t));
+        if (!grown) return PATCH_ID_ERR_MEMORY;
+        cache->added = grown;
+        cache->added_capacity = capacity;
+    }
+    cache->added[cache->added_count++] = *entry;
+    return RELEASY_SUCCESS;
+}
+
+static int write_entries(FILE *f, const patch_id_entry_t *entries, size_t count) {
+    patch_id_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PATCH_ID_CACHE_MAGIC, sizeof(header.magic));
+    header.format = PATCH_ID_CACHE_FORMAT;
+    header.byte_order = SIDECAR_BYTE_ORDER;
+    header.entry_size = sizeof(patch_id_entry_t);
+    header.count = (uint32_t)count;
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && count) ok = fwrite(entries, sizeof(patch_id_entry_t), count, f) == count;
+    return ok;
+}
+
+/*
+ * Rewrites the file as the mapped entries plus everything added. Past
+ * PATCH_ID_CACHE_MAX_ENTRIES it starts over from this run's entries, which
+ * are the ones the next run of the same release is going to ask for.
+ */
+int patch_id_cache_save(patch_id_cache_t *cache, git_repository *repo) {
+    if (!cache || !repo) return RELEASY_ERROR;
+    if (cache->added_count == 0) return RELEASY_SUCCESS;
+
+    size_t kept = cache->count + cache->added_count > PATCH_ID_CACHE_MAX_ENTRIES ? 0 : cache->count;
+    size_t total = kept + cache->added_count;
+    patch_id_entry_t *entries = malloc(total * sizeof(patch_id_entry_t));
+    if (!entries) return PATCH_ID_ERR_MEMORY;
+    if (kept) memcpy(entries, cache->entries, kept * sizeof(patch_id_entry_t));
+    memcpy(entries + kept, cache->added, cache->added_count * sizeof(patch_id_entry_t));
+
+    qsort(entries, total, sizeof(patch_id_entry_t), compare_entry);
+    size_t count = 0;
+    for (size_t i = 0; i < total; i++) {
+        if (count > 0 && compare_entry(&entries[count - 1], &entries[i]) == 0) continue;
+        entries[count++] = entries[i];
+    }
+    if (count > PATCH_ID_CACHE_MAX_ENTRIES) count = PATCH_ID_CACHE_MAX_ENTRIES;
+
+    char *path = cache_file_path(repo);
+    sidecar_writer_t writer;
+    int ret = path ? sidecar_begin(&writer, path) : SIDECAR_ERR_MEMORY;
+    if (ret == RELEASY_SUCCESS) ret = sidecar_commit(&writer, write_entries(writer.file, entries, count));
+    free(path);
+    free(entries);
+
+    switch (ret) {
+        case RELEASY_SUCCESS:
+            return RELEASY_SUCCESS;
+        case SIDECAR_ERR_LOCKED:
+            return PATCH_ID_ERR_LOCKED;
+        case SIDECAR_ERR_MEMORY:
+            return PATCH_ID_ERR_MEMORY;
+        default:
+            return PATCH_ID_ERR_FILE_ACCESS;
+    }
+}
+
+void patch_id_cache_close(patch_id_cache_t *cache) {
+    if (!cache) return;
+
+    if (cache->map) munmap(cache->map, cache->map_size);
+    free(cache->added);
+    memset(cache, 0, sizeof(patch_id_cache_t));
+}
+
+// The id on git revert's "This reverts commit <id>." line, if there is one
+static void find_reverted(const char *message, unsigned char *reverts) {
+    static const char marker[] = "This reverts commit ";
+    const char *line = message ? strstr(message, marker) : NULL;
+    if (!line) return;
+
+    const char *hex = line + sizeof(marker) - 1;
+    for (size_t i = 0; i < GIT_OID_HEXSZ; i++) {
+        if (!isxdigit((unsigned char)hex[i])) return;
+    }
+
+    git_oid oid;
+    if (git_oid_fromstrn(&oid, hex, GIT_OID_HEXSZ) == 0) memcpy(reverts, oid.id, GIT_OID_RAWSZ);
+}
+
+int patch_id_compute(git_repository *repo, const git_oid *oid, patch_id_entry_t *entry) {
+    if (!repo || !oid || !entry) return RELEASY_ERROR;
+
+    memset(entry, 0, sizeof(patch_id_entry_t));
+    memcpy(entry->commit, oid->id, GIT_OID_RAWSZ);
+
+    git_commit *commit = NULL;
+    if (git_commit_lookup(&commit, repo, oid) != 0) return PATCH_ID_ERR_GIT_OPERATION;
+    find_reverted(git_commit_message(commit), entry->reverts);
+
+    // A merge's change is its branch's, and the branch is walked too
+    unsigned int parents = git_commit_parentcount(commit);
+    if (parents > 1) {
+        git_commit_free(commit);
+        return RELEASY_SUCCESS;
+    }
+
+    git_commit *parent = NULL;
+    git_tree *tree = NULL, *parent_tree = NULL;
+    git_diff *diff = NULL;
+    int ret = git_commit_tree(&tree, commit) == 0 ? RELEASY_SUCCESS : PATCH_ID_ERR_GIT_OPERATION;
+    if (ret == RELEASY_SUCCESS && parents == 1 &&
+        (git_commit_parent(&parent, commit, 0) != 0 || git_commit_tree(&parent_tree, parent) != 0)) {
+        ret = PATCH_ID_ERR_GIT_OPERATION;
+    }
+    if (ret == RELEASY_SUCCESS && git_diff_tree_to_tree(&diff, repo, parent_tree, tree, NULL) != 0) {
+        ret = PATCH_ID_ERR_GIT_OPERATION;
+    }
+
+    git_oid patch;
+    if (ret == RELEASY_SUCCESS && git_diff_num_deltas(diff) > 0) {
+        if (git_diff_patchid(&patch, diff, NULL) == 0) {
+            memcpy(entry->patch, patch.id, GIT_OID_RAWSZ);
+        } else {
+            ret = PATCH_ID_ERR_GIT_OPERATION;
+        }
+    }
+
+    git_diff_free(diff);
+    git_tree_free(parent_tree);
+    git_tree_free(tree);
+    git_commit_free(parent);
+    git_commit_free(commit);
+    return ret;
+}
+
+typedef struct {
+    git_repository *repo;
+    const patch_id_cache_t *cache;
+    const git_oid *oids;
+    patch_id_entry_t *entries;
+    unsigned char *fresh;
+    size_t count;
+    atomic_size_t next;
+} patch_id_job_t;
+
+typedef struct {
+    patch_id_job_t *job;
+    git_repository *repo;   // Own handle, so object lookups never share a cache
+} patch_id_worker_t;
+
+// A commit that cannot be diffed keeps a zero patch id and is simply never
+// matched; it is not cached, so the next run tries it again
+static void compute_slices(patch_id_job_t *job, git_repository *repo) {
+    size_t start;
+    while ((start = atomic_fetch_add(&job->next, PATCH_ID_SLICE)) < job->count) {
+        size_t end = start + PATCH_ID_SLICE;
+        if (end > job->count) end = job->count;
+        for (size_t i = start; i < end; i++) {
+            if (patch_id_cache_lookup(job->cache, &job->oids[i], &job->entries[i])) continue;
+            if (patch_id_compute(repo, &job->oids[i], &job->entries[i]) == RELEASY_SUCCESS) {
+                job->fresh[i] = 1;
+            }
+        }
+    }
+}
+
+static void *patch_id_worker(void *arg) {
+    patch_id_worker_t *worker = arg;
+    compute_slices(worker->job, worker->repo);
+    return NULL;
+}
+
+static int worker_count(int workers) {
+    long count = workers;
+    if (count <= 0) count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (count < 1) count = 1;
+    if (count > PATCH_ID_MAX_WORKERS) count = PATCH_ID_MAX_WORKERS;
+    return (int)count;
+}
+
+int patch_id_compute_all(git_repository *repo, patch_id_cache_t *cache, const git_oid *oids,
+                         size_t count, int workers, patch_id_entry_t *entries) {
+    if (!repo || (count && (!oids || !entries))) return RELEASY_ERROR;
+    if (count == 0) return RELEASY_SUCCESS;
+
+    patch_id_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.cache = cache;
+    job.oids = oids;
+    job.entries = entries;
+    job.count = count;
+    job.fresh = calloc(count, 1);
+    if (!job.fresh) return PATCH_ID_ERR_MEMORY;
+    atomic_init(&job.next, 0);
+
+    size_t misses = 0;
+    patch_id_entry_t probe;
+    for (size_t i = 0; i < count && misses < PATCH_ID_MIN_PARALLEL; i++) {
+        if (!patch_id_cache_lookup(cache, &oids[i], &probe)) misses++;
+    }
+
+    int threads = misses < PATCH_ID_MIN_PARALLEL ? 1 : worker_count(workers);
+    patch_id_worker_t *pool = threads > 1 ? calloc((size_t)threads, sizeof(patch_id_worker_t)) : NULL;
+    pthread_t *ids = threads > 1 ? calloc((size_t)threads, sizeof(pthread_t)) : NULL;
+    int started = 0;
+    for (int i = 0; pool && ids && i < threads; i++) {
+        pool[started].job = &job;
+        if (git_repository_open(&pool[started].repo, git_repository_path(repo)) != 0) break;
+        if (pthread_create(&ids[started], NULL, patch_id_worker, &pool[started]) != 0) {
+            git_repository_free(pool[started].repo);
+            break;
+        }
+        started++;
+    }
+
+    // Whatever the threads leave, or all of it without them
+    compute_slices(&job, repo);
+    for (int i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+        git_repository_free(pool[i].repo);
+    }
+    free(ids);
+    free(pool);
+
+    int ret = RELEASY_SUCCESS;
+    for (size_t i = 0; cache && ret == RELEASY_SUCCESS && i < count; i++) {
+        if (job.fresh[i]) ret = patch_id_cache_add(cache, &entries[i]);
+    }
+    free(job.fresh);
+    return ret;
+}
+
+const char *patch_id_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case PATCH_ID_ERR_CORRUPT:
+            return "Patch id cache is corrupt";
+        case PATCH_ID_ERR_FILE_ACCESS:
+            return "Failed to access patch id cache";
+        case PATCH_ID_ERR_MEMORY:
+            return "Memory allocation failed";
+        case PATCH_ID_ERR_LOCKED:
+            return "Patch id cache is being written by another process";
+        case PATCH_ID_ERR_GIT_OPERATION:
+            return "Failed to diff commit";
+        default:
+            return "Unknown error";
+    }
+}
@@ -7,6 +7,7 @@
 #include <sys/wait.h>
 #include "release.h"
 #include "git_ops.h"
+#include "repo_session.h"
 
 static int execute_command(const char *command, const char *log_file) {
     if (!command) return RELEASY_SUCCESS;
@@ -81,17 +82,16 @@ int release_prepare(release_state_t *state, const char *version) {
         return RELEASE_ERR_MEMORY;
     }
     
-    // Create release branch
-    git_repository *repo = NULL;
-    if (git_repository_open(&repo, ".") != 0) {
+    // Create release branch, reusing the repository the process already has open
+    if (repo_session_open(".") != RELEASY_SUCCESS) {
         version_cleanup(state->version);
         free(state->version);
         return RELEASE_ERR_GIT_OPERATION;
     }
+    git_repository *repo = repo_session_repo();
     
     int ret = version_create_release_branch(repo, state->version);
     if (ret != RELEASY_SUCCESS) {
-        git_repository_free(repo);
         version_cleanup(state->version);
         free(state->version);
         return ret;
@@ -101,7 +101,6 @@ int release_prepare(release_state_t *state, const char *version) {
     if (state->config->create_changelog) {
         state->changelog = calloc(1, sizeof(changelog_t));
         if (!state->changelog) {
-            git_repository_free(repo);
             version_cleanup(state->version);
             free(state->version);
             return RELEASE_ERR_MEMORY;
@@ -109,7 +108,6 @@ int release_prepare(release_state_t *state, const char *version) {
         
         if (changelog_init(state->changelog, "CHANGELOG.md") != RELEASY_SUCCESS) {
             free(state->changelog);
-            git_repository_free(repo);
             version_cleanup(state->version);
             free(state->version);
             return RELEASE_ERR_INVALID_STATE;
@@ -119,14 +117,12 @@ int release_prepare(release_state_t *state, const char *version) {
         if (ret != RELEASY_SUCCESS) {
             changelog_cleanup(state->changelog);
             free(state->changelog);
-            git_repository_free(repo);
             version_cleanup(state->version);
             free(state->version);
             return ret;
         }
     }
     
-    git_repository_free(repo);
     state->status = RELEASE_STATUS_IN_PROGRESS;
     return RELEASY_SUCCESS;
 }
@@ -175,8 +171,7 @@ int release_publish(release_state_t *state) {
     
     // Create tag if needed
     if (state->config->create_tag) {
-        git_repository *repo = NULL;
-        if (git_repository_open(&repo, ".") != 0) {
+        if (repo_session_open(".") != RELEASY_SUCCESS) {
             return RELEASE_ERR_GIT_OPERATION;
         }
         
@@ -184,8 +179,7 @@ int release_publish(release_state_t *state) {
         snprintf(tag_message, sizeof(tag_message), "Release %s", 
                  state->version->current_version);
         
-        int ret = version_create_tag(repo, state->version, tag_message);
-        git_repository_free(repo);
+        int ret = version_create_tag(repo_session_repo(), state->version, tag_message);
         if (ret != RELEASY_SUCCESS) return ret;
     }
     
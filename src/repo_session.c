@@ -0,0 +1,87 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "repo_session.h"
+
+static repo_session_t g_session = {0};
+
+/*
+ * Opens the repository at path along with its config and object database.
+ * Opening again while a session exists is a no-op, so every entry point can
+ * call this instead of git_repository_open() and share the same handles.
+ * The session holds its own libgit2 init reference, which keeps
+ * git_ops_init()/git_ops_cleanup() pairs from tearing down global state
+ * (packfile windows, caches) in between.
+ */
+int repo_session_open(const char *path) {
+    if (!path) return RELEASY_ERROR;
+    if (g_session.repo) return RELEASY_SUCCESS;
+
+    git_libgit2_init();
+
+    g_session.path = strdup(path);
+    if (!g_session.path) {
+        git_libgit2_shutdown();
+        return RELEASY_ERROR;
+    }
+
+    if (git_repository_open(&g_session.repo, path) != 0) {
+        repo_session_close();
+        return REPO_SESSION_ERR_NOT_FOUND;
+    }
+
+    if (git_repository_config_snapshot(&g_session.config, g_session.repo) != 0 ||
+        git_repository_odb(&g_session.odb, g_session.repo) != 0) {
+        repo_session_close();
+        return REPO_SESSION_ERR_GIT_OPERATION;
+    }
+
+    return RELEASY_SUCCESS;
+}
+
+int repo_session_is_open(void) {
+    return g_session.repo != NULL;
+}
+
+const repo_session_t *repo_session_get(void) {
+    return g_session.repo ? &g_session : NULL;
+}
+
+git_repository *repo_session_repo(void) {
+    return g_session.repo;
+}
+
+git_config *repo_session_config(void) {
+    return g_session.config;
+}
+
+git_odb *repo_session_odb(void) {
+    return g_session.odb;
+}
+
+void repo_session_close(void) {
+    // Nothing to release if open never got as far as libgit2
+    if (!g_session.path) return;
+
+    if (g_session.odb) git_odb_free(g_session.odb);
+    if (g_session.config) git_config_free(g_session.config);
+    if (g_session.repo) git_repository_free(g_session.repo);
+    free(g_session.path);
+
+    memset(&g_session, 0, sizeof(repo_session_t));
+    git_libgit2_shutdown();
+}
+
+const char *repo_session_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case REPO_SESSION_ERR_NOT_FOUND:
+            return "Not a git repository";
+        case REPO_SESSION_ERR_GIT_OPERATION:
+            return "Failed to load repository configuration or object database";
+        default:
+            return "Unknown error";
+    }
+}
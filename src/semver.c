@@ -1,13 +1,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 #include "semver.h"
 
-#define SEMVER_REGEX "^(0|[1-9][0-9]*)\\.(0|[1-9][0-9]*)\\.(0|[1-9][0-9]*)(\\-([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*))?(\\+([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*))?$"
-
-static regex_t semver_regex;
-static int regex_compiled = 0;
-
 int semver_init(semver_t *version) {
     if (!version) return RELEASY_ERROR;
     version->major = 0;
@@ -18,66 +14,138 @@ int semver_init(semver_t *version) {
     return RELEASY_SUCCESS;
 }
 
-static int compile_regex(void) {
-    if (!regex_compiled) {
-        if (regcomp(&semver_regex, SEMVER_REGEX, REG_EXTENDED) != 0) {
-            return SEMVER_ERR_INVALID_FORMAT;
+static int is_identifier_char(char c) {
+    return (c >= '0' && c <= '9') ||
+           (c >= 'A' && c <= 'Z') ||
+           (c >= 'a' && c <= 'z') ||
+           c == '-';
+}
+
+/*
+ * Scans a numeric component: 0|[1-9][0-9]*
+ * Returns the position after the digits, or NULL if there are none.
+ * Values that don't fit in an int set *overflow but still consume the digits
+ * so the caller can finish validating the grammar first.
+ */
+static const char *scan_numeric(const char *p, const char *end, int *value, int *overflow) {
+    if (p == end || *p < '0' || *p > '9') return NULL;
+
+    *value = 0;
+    *overflow = 0;
+    if (*p == '0') return p + 1;
+
+    while (p < end && *p >= '0' && *p <= '9') {
+        int digit = *p - '0';
+        if (*value > (INT_MAX - digit) / 10) {
+            *overflow = 1;
+        } else if (!*overflow) {
+            *value = *value * 10 + digit;
         }
-        regex_compiled = 1;
+        p++;
     }
-    return RELEASY_SUCCESS;
+    return p;
 }
 
-int semver_parse(const char *version_str, semver_t *version) {
-    if (!version_str || !version) return RELEASY_ERROR;
-    
-    int ret = compile_regex();
-    if (ret != RELEASY_SUCCESS) return ret;
+/*
+ * Scans a dot separated identifier list: [0-9A-Za-z-]+(\.[0-9A-Za-z-]+)*
+ * Returns the position after the list, or NULL on an empty identifier.
+ */
+static const char *scan_identifiers(const char *p, const char *end) {
+    for (;;) {
+        const char *start = p;
+        while (p < end && is_identifier_char(*p)) p++;
+        if (p == start) return NULL;
+        if (p == end || *p != '.') return p;
+        p++;
+    }
+}
+
+/*
+ * Single pass parser for the SemVer 2.0 grammar
+ *
+ *   (0|[1-9][0-9]*).(0|[1-9][0-9]*).(0|[1-9][0-9]*)
+ *   [-[0-9A-Za-z-]+(.[0-9A-Za-z-]+)*][+[0-9A-Za-z-]+(.[0-9A-Za-z-]+)*]
+ *
+ * anchored at both ends. Nothing is copied; prerelease and build come back as
+ * spans into version_str.
+ */
+int semver_parse_view(const char *version_str, size_t len, semver_view_t *view) {
+    if (!version_str || !view) return RELEASY_ERROR;
+
+    const char *p = version_str;
+    const char *end = version_str + len;
+    int overflow[3];
+
+    memset(view, 0, sizeof(semver_view_t));
+
+    p = scan_numeric(p, end, &view->major, &overflow[0]);
+    if (!p || p == end || *p++ != '.') return SEMVER_ERR_INVALID_FORMAT;
 
-    regmatch_t matches[10];
-    if (regexec(&semver_regex, version_str, 10, matches, 0) != 0) {
-        return SEMVER_ERR_INVALID_FORMAT;
+    p = scan_numeric(p, end, &view->minor, &overflow[1]);
+    if (!p || p == end || *p++ != '.') return SEMVER_ERR_INVALID_FORMAT;
+
+    p = scan_numeric(p, end, &view->patch, &overflow[2]);
+    if (!p) return SEMVER_ERR_INVALID_FORMAT;
+
+    if (p < end && *p == '-') {
+        const char *start = ++p;
+        p = scan_identifiers(p, end);
+        if (!p) return SEMVER_ERR_INVALID_FORMAT;
+        view->prerelease.offset = (size_t)(start - version_str);
+        view->prerelease.length = (size_t)(p - start);
     }
 
-    char buffer[256];
-    int len;
+    if (p < end && *p == '+') {
+        const char *start = ++p;
+        p = scan_identifiers(p, end);
+        if (!p) return SEMVER_ERR_INVALID_FORMAT;
+        view->build.offset = (size_t)(start - version_str);
+        view->build.length = (size_t)(p - start);
+    }
 
-    len = matches[1].rm_eo - matches[1].rm_so;
-    if (len >= sizeof(buffer)) return SEMVER_ERR_INVALID_MAJOR;
-    strncpy(buffer, version_str + matches[1].rm_so, len);
-    buffer[len] = '\0';
-    version->major = atoi(buffer);
+    if (p != end) return SEMVER_ERR_INVALID_FORMAT;
 
-    len = matches[2].rm_eo - matches[2].rm_so;
-    if (len >= sizeof(buffer)) return SEMVER_ERR_INVALID_MINOR;
-    strncpy(buffer, version_str + matches[2].rm_so, len);
-    buffer[len] = '\0';
-    version->minor = atoi(buffer);
+    if (overflow[0]) return SEMVER_ERR_INVALID_MAJOR;
+    if (overflow[1]) return SEMVER_ERR_INVALID_MINOR;
+    if (overflow[2]) return SEMVER_ERR_INVALID_PATCH;
 
-    len = matches[3].rm_eo - matches[3].rm_so;
-    if (len >= sizeof(buffer)) return SEMVER_ERR_INVALID_PATCH;
-    strncpy(buffer, version_str + matches[3].rm_so, len);
-    buffer[len] = '\0';
-    version->patch = atoi(buffer);
+    return RELEASY_SUCCESS;
+}
 
-    if (matches[5].rm_so != -1) {
-        len = matches[5].rm_eo - matches[5].rm_so;
-        version->prerelease = malloc(len + 1);
+static char *span_dup(const char *str, semver_span_t span) {
+    char *copy = malloc(span.length + 1);
+    if (!copy) return NULL;
+    memcpy(copy, str + span.offset, span.length);
+    copy[span.length] = '\0';
+    return copy;
+}
+
+int semver_parse(const char *version_str, semver_t *version) {
+    if (!version_str || !version) return RELEASY_ERROR;
+
+    version->prerelease = NULL;
+    version->build = NULL;
+
+    semver_view_t view;
+    int ret = semver_parse_view(version_str, strlen(version_str), &view);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    version->major = view.major;
+    version->minor = view.minor;
+    version->patch = view.patch;
+
+    if (view.prerelease.length) {
+        version->prerelease = span_dup(version_str, view.prerelease);
         if (!version->prerelease) return SEMVER_ERR_MEMORY;
-        strncpy(version->prerelease, version_str + matches[5].rm_so, len);
-        version->prerelease[len] = '\0';
     }
 
-    if (matches[8].rm_so != -1) {
-        len = matches[8].rm_eo - matches[8].rm_so;
-        version->build = malloc(len + 1);
+    if (view.build.length) {
+        version->build = span_dup(version_str, view.build);
         if (!version->build) {
             free(version->prerelease);
             version->prerelease = NULL;
             return SEMVER_ERR_MEMORY;
         }
-        strncpy(version->build, version_str + matches[8].rm_so, len);
-        version->build[len] = '\0';
     }
 
     return RELEASY_SUCCESS;
@@ -112,24 +180,188 @@ int semver_validate(const semver_t *version) {
     return RELEASY_SUCCESS;
 }
 
+static int is_numeric_identifier(const char *id, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (id[i] < '0' || id[i] > '9') return 0;
+    }
+    return len > 0;
+}
+
+static int compare_identifiers(const char *a, size_t a_len, const char *b, size_t b_len) {
+    int a_numeric = is_numeric_identifier(a, a_len);
+    int b_numeric = is_numeric_identifier(b, b_len);
+
+    // Numeric identifiers compare by value and sort before alphanumeric ones
+    if (a_numeric && b_numeric) {
+        while (a_len > 1 && *a == '0') { a++; a_len--; }
+        while (b_len > 1 && *b == '0') { b++; b_len--; }
+        if (a_len != b_len) return a_len < b_len ? -1 : 1;
+        int ret = memcmp(a, b, a_len);
+        return (ret > 0) - (ret < 0);
+    }
+    if (a_numeric) return -1;
+    if (b_numeric) return 1;
+
+    int ret = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (ret) return (ret > 0) - (ret < 0);
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+// Dot separated identifiers are compared left to right; when one list is a
+// prefix of the other the shorter one has lower precedence
+static int compare_prerelease(const char *a, const char *b) {
+    for (;;) {
+        size_t a_len = strcspn(a, ".");
+        size_t b_len = strcspn(b, ".");
+
+        int ret = compare_identifiers(a, a_len, b, b_len);
+        if (ret) return ret;
+
+        a += a_len;
+        b += b_len;
+        if (!*a || !*b) return (*a != '\0') - (*b != '\0');
+        a++;
+        b++;
+    }
+}
+
 int semver_compare(const semver_t *v1, const semver_t *v2) {
     if (!v1 || !v2) return 0;
 
     if (v1->major != v2->major) {
-        return v1->major - v2->major;
+        return v1->major < v2->major ? -1 : 1;
     }
     if (v1->minor != v2->minor) {
-        return v1->minor - v2->minor;
+        return v1->minor < v2->minor ? -1 : 1;
     }
     if (v1->patch != v2->patch) {
-        return v1->patch - v2->patch;
+        return v1->patch < v2->patch ? -1 : 1;
     }
 
     if (!v1->prerelease && !v2->prerelease) return 0;
     if (!v1->prerelease) return 1;
     if (!v2->prerelease) return -1;
 
-    return strcmp(v1->prerelease, v2->prerelease);
+    return compare_prerelease(v1->prerelease, v2->prerelease);
+}
+
+typedef struct {
+    unsigned char *buf;
+    size_t pos;
+    int truncated;
+} key_writer_t;
+
+static void key_put(key_writer_t *w, unsigned char byte) {
+    if (w->pos < SEMVER_KEY_SUFFIX_SIZE) {
+        w->buf[w->pos++] = byte;
+    } else {
+        w->truncated = 1;
+    }
+}
+
+/*
+ * Encodes prerelease identifiers so that memcmp() order equals SemVer
+ * precedence:
+ *   numeric       0x01 <digit count> <digits without leading zeros>
+ *   alphanumeric  0x02 <chars> 0x00
+ * The zero padding after the last identifier sorts before any further
+ * identifier, which gives shorter lists lower precedence.
+ */
+static int encode_prerelease(unsigned char *suffix, const char *pre, size_t len) {
+    key_writer_t w = { suffix, 0, 0 };
+    const char *end = pre + len;
+
+    while (pre < end) {
+        const char *id = pre;
+        while (pre < end && *pre != '.') pre++;
+        size_t id_len = (size_t)(pre - id);
+
+        if (is_numeric_identifier(id, id_len)) {
+            while (id_len > 1 && *id == '0') { id++; id_len--; }
+            key_put(&w, 0x01);
+            key_put(&w, id_len > 0xFF ? 0xFF : (unsigned char)id_len);
+            if (id_len > 0xFF) w.truncated = 1;
+            for (size_t i = 0; i < id_len; i++) key_put(&w, (unsigned char)id[i]);
+        } else {
+            key_put(&w, 0x02);
+            for (size_t i = 0; i < id_len; i++) key_put(&w, (unsigned char)id[i]);
+            key_put(&w, 0x00);
+        }
+
+        if (pre < end) pre++;
+    }
+
+    return w.truncated;
+}
+
+static void key_pack(semver_key_t *key, int major, int minor, int patch,
+                     const char *prerelease, size_t prerelease_len) {
+    memset(key, 0, sizeof(semver_key_t));
+    key->prefix[0] = (uint64_t)(uint32_t)major << 32 | (uint32_t)minor;
+    key->prefix[1] = (uint64_t)(uint32_t)patch << 32;
+
+    if (prerelease_len == 0) {
+        key->prefix[1] |= SEMVER_KEY_RELEASE;
+    } else if (encode_prerelease(key->suffix, prerelease, prerelease_len)) {
+        key->flags |= SEMVER_KEY_TRUNCATED;
+    }
+}
+
+int semver_key_from_view(semver_key_t *key, const char *version_str, const semver_view_t *view) {
+    if (!key || !version_str || !view) return RELEASY_ERROR;
+
+    key_pack(key, view->major, view->minor, view->patch,
+             version_str + view->prerelease.offset, view->prerelease.length);
+    return RELEASY_SUCCESS;
+}
+
+int semver_key_from_version(semver_key_t *key, const semver_t *version) {
+    if (!key || !version) return RELEASY_ERROR;
+
+    const char *pre = version->prerelease;
+    key_pack(key, version->major, version->minor, version->patch,
+             pre ? pre : "", pre ? strlen(pre) : 0);
+    return RELEASY_SUCCESS;
+}
+
+int semver_key_parse(const char *version_str, size_t len, semver_key_t *key) {
+    if (!version_str || !key) return RELEASY_ERROR;
+
+    semver_view_t view;
+    int ret = semver_parse_view(version_str, len, &view);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    return semver_key_from_view(key, version_str, &view);
+}
+
+int semver_key_compare(const semver_key_t *k1, const semver_key_t *k2) {
+    if (k1->prefix[0] != k2->prefix[0]) return k1->prefix[0] < k2->prefix[0] ? -1 : 1;
+    if (k1->prefix[1] != k2->prefix[1]) return k1->prefix[1] < k2->prefix[1] ? -1 : 1;
+    if (k1->prefix[1] & SEMVER_KEY_RELEASE) return 0;
+
+    int ret = memcmp(k1->suffix, k2->suffix, SEMVER_KEY_SUFFIX_SIZE);
+    return (ret > 0) - (ret < 0);
+}
+
+/*
+ * Same as semver_key_compare(), but settles ties between truncated keys by
+ * comparing the version strings the keys were built from
+ */
+int semver_key_compare_exact(const semver_key_t *k1, const char *version1,
+                             const semver_key_t *k2, const char *version2) {
+    int result = semver_key_compare(k1, k2);
+    if (result != 0 || !((k1->flags | k2->flags) & SEMVER_KEY_TRUNCATED)) return result;
+
+    semver_t v1, v2;
+    semver_init(&v1);
+    semver_init(&v2);
+    if (semver_parse(version1, &v1) == RELEASY_SUCCESS &&
+        semver_parse(version2, &v2) == RELEASY_SUCCESS) {
+        result = semver_compare(&v1, &v2);
+    }
+    semver_free(&v1);
+    semver_free(&v2);
+    return result;
 }
 
 char *semver_to_string(const semver_t *version) {
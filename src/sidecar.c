@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "sidecar.h"
+
+char *sidecar_common_path(const char *common_dir, const char *name) {
+    if (!common_dir || !name) return NULL;
+
+    size_t len = strlen(common_dir) + strlen(name) + 1;
+    char *path = malloc(len);
+    if (!path) return NULL;
+
+    // commondir comes back with a trailing slash
+    snprintf(path, len, "%s%s", common_dir, name);
+    return path;
+}
+
+char *sidecar_path(const char *common_dir, const char *name) {
+    if (!common_dir || !name) return NULL;
+
+    size_t len = strlen(common_dir) + strlen(SIDECAR_DIR "/") + strlen(name) + 1;
+    char *path = malloc(len);
+    if (!path) return NULL;
+
+    snprintf(path, len, "%s" SIDECAR_DIR "/%s", common_dir, name);
+    return path;
+}
+
+int sidecar_map(const char *path, size_t min_size, void **map, size_t *size, struct stat *st) {
+    if (!path || !map || !size) return RELEASY_ERROR;
+    *map = NULL;
+    *size = 0;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return SIDECAR_ERR_FILE_ACCESS;
+
+    struct stat file_st;
+    if (fstat(fd, &file_st) != 0 || (size_t)file_st.st_size < min_size || file_st.st_size == 0) {
+        close(fd);
+        return SIDECAR_ERR_CORRUPT;
+    }
+
+    void *mapped = mmap(NULL, (size_t)file_st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return SIDECAR_ERR_FILE_ACCESS;
+
+    *map = mapped;
+    *size = (size_t)file_st.st_size;
+    if (st) *st = file_st;
+    return RELEASY_SUCCESS;
+}
+
+static int take_lock(const char *lock_path) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int fd = open(lock_path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd >= 0) return fd;
+        if (errno != EEXIST) return -1;
+
+        struct stat st;
+        if (stat(lock_path, &st) != 0 || time(NULL) - st.st_mtime < SIDECAR_LOCK_STALE_SECONDS) {
+            errno = EEXIST;
+            return -1;
+        }
+        unlink(lock_path);
+    }
+    errno = EEXIST;
+    return -1;
+}
+
+static void writer_free(sidecar_writer_t *writer) {
+    free(writer->path);
+    free(writer->lock_path);
+    memset(writer, 0, sizeof(sidecar_writer_t));
+}
+
+int sidecar_begin(sidecar_writer_t *writer, const char *path) {
+    if (!writer || !path) return RELEASY_ERROR;
+    memset(writer, 0, sizeof(sidecar_writer_t));
+
+    size_t len = strlen(path) + sizeof(".lock");
+    writer->path = strdup(path);
+    writer->lock_path = malloc(len);
+    if (!writer->path || !writer->lock_path) {
+        writer_free(writer);
+        return SIDECAR_ERR_MEMORY;
+    }
+    snprintf(writer->lock_path, len, "%s.lock", path);
+
+    char *slash = strrchr(writer->path, '/');
+    if (slash && slash != writer->path) {
+        *slash = '\0';
+        mkdir(writer->path, 0755);
+        *slash = '/';
+    }
+
+    int fd = take_lock(writer->lock_path);
+    if (fd < 0) {
+        int locked = errno == EEXIST;
+        writer_free(writer);
+        return locked ? SIDECAR_ERR_LOCKED : SIDECAR_ERR_FILE_ACCESS;
+    }
+
+    writer->file = fdopen(fd, "wb");
+    if (!writer->file) {
+        close(fd);
+        unlink(writer->lock_path);
+        writer_free(writer);
+        return SIDECAR_ERR_FILE_ACCESS;
+    }
+    return RELEASY_SUCCESS;
+}
+
+// Readers that still have the old file mapped keep seeing the old inode
+int sidecar_commit(sidecar_writer_t *writer, int ok) {
+    if (!writer || !writer->file) return RELEASY_ERROR;
+
+    if (fclose(writer->file) != 0) ok = 0;
+    if (ok && rename(writer->lock_path, writer->path) != 0) ok = 0;
+    if (!ok) unlink(writer->lock_path);
+
+    writer_free(writer);
+    return ok ? RELEASY_SUCCESS : SIDECAR_ERR_FILE_ACCESS;
+}
@@ -0,0 +1,417 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "tag_index.h"
+#include "sidecar.h"
+#include "version_list.h"
+
+#define TAG_REF_PREFIX "refs/tags/"
+
+static char *index_file_path(git_repository *repo) {
+    return sidecar_path(git_repository_commondir(repo), TAG_INDEX_FILE);
+}
+
+static void stat_into(const char *path, int64_t *mtime_sec, int64_t *mtime_nsec, int64_t *size) {
+    struct stat st;
+    if (!path || stat(path, &st) != 0) return;
+
+    *mtime_sec = (int64_t)st.st_mtim.tv_sec;
+    *mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    if (size) *size = (int64_t)st.st_size;
+}
+
+static int read_stamp(git_repository *repo, tag_index_stamp_t *stamp) {
+    memset(stamp, 0, sizeof(tag_index_stamp_t));
+
+    const char *common_dir = git_repository_commondir(repo);
+    char *packed_refs = sidecar_common_path(common_dir, "packed-refs");
+    char *refs_tags = sidecar_common_path(common_dir, "refs/tags");
+    if (!packed_refs || !refs_tags) {
+        free(packed_refs);
+        free(refs_tags);
+        return TAG_INDEX_ERR_MEMORY;
+    }
+
+    // A missing file leaves its fields at zero, which is a valid stamp too
+    stat_into(packed_refs, &stamp->packed_refs_mtime_sec, &stamp->packed_refs_mtime_nsec,
+              &stamp->packed_refs_size);
+    stat_into(refs_tags, &stamp->refs_tags_mtime_sec, &stamp->refs_tags_mtime_nsec, NULL);
+
+    free(packed_refs);
+    free(refs_tags);
+    return RELEASY_SUCCESS;
+}
+
+static int mtime_before(int64_t sec, int64_t nsec, const struct stat *st) {
+    if (sec != (int64_t)st->st_mtim.tv_sec) return sec < (int64_t)st->st_mtim.tv_sec;
+    return nsec < (int64_t)st->st_mtim.tv_nsec;
+}
+
+static int stamp_matches(const tag_index_t *index, const tag_index_stamp_t *stamp) {
+    return !index->racy && memcmp(&index->header->stamp, stamp, sizeof(tag_index_stamp_t)) == 0;
+}
+
+static int map_index(tag_index_t *index, git_repository *repo) {
+    memset(index, 0, sizeof(tag_index_t));
+
+    char *path = index_file_path(repo);
+    if (!path) return TAG_INDEX_ERR_MEMORY;
+
+    struct stat st;
+    int ret = sidecar_map(path, sizeof(tag_index_header_t), &index->map, &index->map_size, &st);
+    free(path);
+    if (ret != RELEASY_SUCCESS) return ret == SIDECAR_ERR_CORRUPT ? TAG_INDEX_ERR_CORRUPT : TAG_INDEX_ERR_FILE_ACCESS;
+    index->header = index->map;
+
+    const tag_index_header_t *header = index->header;
+    if (memcmp(header->magic, TAG_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->format != TAG_INDEX_FORMAT ||
+        header->byte_order != SIDECAR_BYTE_ORDER ||
+        header->entry_size != sizeof(tag_index_entry_t)) {
+        tag_index_close(index);
+        return TAG_INDEX_ERR_CORRUPT;
+    }
+
+    uint64_t expected = sizeof(tag_index_header_t) +
+                        (uint64_t)header->count * sizeof(tag_index_entry_t) +
+                        header->names_size;
+    if (expected != index->map_size) {
+        tag_index_close(index);
+        return TAG_INDEX_ERR_CORRUPT;
+    }
+
+    // Filesystem timestamps can be coarse, so a ref written right after the
+    // index may leave the stamp unchanged. Only trust mtimes strictly older
+    // than the index itself.
+    const tag_index_stamp_t *stamp = &header->stamp;
+    index->racy = !mtime_before(stamp->packed_refs_mtime_sec, stamp->packed_refs_mtime_nsec, &st) ||
+                  !mtime_before(stamp->refs_tags_mtime_sec, stamp->refs_tags_mtime_nsec, &st);
+
+    index->entries = (const tag_index_entry_t *)((const char *)index->map + sizeof(tag_index_header_t));
+    index->names = (const char *)(index->entries + header->count);
+    index->count = header->count;
+    return RELEASY_SUCCESS;
+}
+
+static int write_entries(FILE *f, const version_list_t *list, const tag_index_stamp_t *stamp) {
+    tag_index_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TAG_INDEX_MAGIC, sizeof(header.magic));
+    header.format = TAG_INDEX_FORMAT;
+    header.byte_order = SIDECAR_BYTE_ORDER;
+    header.entry_size = sizeof(tag_index_entry_t);
+    header.count = (uint32_t)list->count;
+    header.stamp = *stamp;
+    for (size_t i = 0; i < list->count; i++) {
+        header.names_size += strlen(list->items[i].tag) + 1;
+    }
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+
+    uint32_t offset = 0;
+    for (size_t i = 0; ok && i < list->count; i++) {
+        tag_index_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.key = list->items[i].key;
+        memcpy(entry.commit, list->items[i].commit.id, GIT_OID_RAWSZ);
+        entry.name_offset = offset;
+        entry.name_length = (uint32_t)strlen(list->items[i].tag);
+        offset += entry.name_length + 1;
+        ok = fwrite(&entry, sizeof(entry), 1, f) == 1;
+    }
+
+    for (size_t i = 0; ok && i < list->count; i++) {
+        const char *tag = list->items[i].tag;
+        ok = fwrite(tag, strlen(tag) + 1, 1, f) == 1;
+    }
+    return ok;
+}
+
+static int write_index(git_repository *repo, const version_list_t *list,
+                       const tag_index_stamp_t *stamp) {
+    char *path = index_file_path(repo);
+    if (!path) return TAG_INDEX_ERR_MEMORY;
+
+    sidecar_writer_t writer;
+    int ret = sidecar_begin(&writer, path);
+    if (ret == RELEASY_SUCCESS) ret = sidecar_commit(&writer, write_entries(writer.file, list, stamp));
+    free(path);
+
+    if (ret == SIDECAR_ERR_MEMORY) return TAG_INDEX_ERR_MEMORY;
+    return ret == RELEASY_SUCCESS ? RELEASY_SUCCESS : TAG_INDEX_ERR_FILE_ACCESS;
+}
+
+// Leaves commit alone when the tag does not peel to one
+static int resolve_tag_commit(git_reference *ref, git_odb *odb, git_oid *commit) {
+    const git_oid *target = git_reference_target(ref);
+
+    // Lightweight tags usually point straight at a commit; checking the object
+    // header avoids inflating anything for those
+    if (target && odb) {
+        size_t len;
+        git_object_t type = GIT_OBJECT_INVALID;
+        if (git_odb_read_header(&len, &type, odb, target) == 0 && type == GIT_OBJECT_COMMIT) {
+            *commit = *target;
+            return RELEASY_SUCCESS;
+        }
+    }
+
+    git_object *peeled = NULL;
+    if (git_reference_peel(&peeled, ref, GIT_OBJECT_COMMIT) != 0) {
+        return TAG_INDEX_ERR_GIT_OPERATION;
+    }
+    *commit = *git_object_id(peeled);
+    git_object_free(peeled);
+    return RELEASY_SUCCESS;
+}
+
+/*
+ * Rebuilds the index from the refdb. This is the only place that peels every
+ * version tag; after that the index is kept current by
+ * tag_index_note_created().
+ */
+int tag_index_build(git_repository *repo) {
+    if (!repo) return RELEASY_ERROR;
+
+    // Take the stamp first so a tag written during the scan makes us stale
+    tag_index_stamp_t stamp;
+    int ret = read_stamp(repo, &stamp);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    git_reference_iterator *iter = NULL;
+    if (git_reference_iterator_glob_new(&iter, repo, TAG_REF_PREFIX "*") != 0) {
+        return TAG_INDEX_ERR_GIT_OPERATION;
+    }
+
+    // Peeling falls back to git_reference_peel() if the odb can't be had
+    git_odb *odb = NULL;
+    git_repository_odb(&odb, repo);
+
+    version_list_t list;
+    version_list_init(&list);
+
+    git_reference *ref = NULL;
+    int error;
+    while ((error = git_reference_next(&ref, iter)) == 0) {
+        const char *tag = git_reference_name(ref) + strlen(TAG_REF_PREFIX);
+        size_t before = list.count;
+
+        ret = version_list_add(&list, tag);
+        // A version tag on a tree or blob stays listed with a zero commit,
+        // the way version_list_load() lists it from the refdb
+        if (ret == RELEASY_SUCCESS && list.count > before) {
+            resolve_tag_commit(ref, odb, &list.items[list.count - 1].commit);
+        }
+        git_reference_free(ref);
+        if (ret != RELEASY_SUCCESS) break;
+    }
+    git_reference_iterator_free(iter);
+    if (odb) git_odb_free(odb);
+
+    if (ret == RELEASY_SUCCESS && error != GIT_ITEROVER) ret = TAG_INDEX_ERR_GIT_OPERATION;
+    if (ret == RELEASY_SUCCESS) {
+        version_list_sort(&list);
+        ret = write_index(repo, &list, &stamp);
+    }
+
+    version_list_cleanup(&list);
+    return ret;
+}
+
+/*
+ * Maps the index, rebuilding it first when it is missing, corrupt or older
+ * than the refdb.
+ */
+int tag_index_open(tag_index_t *index, git_repository *repo) {
+    if (!index || !repo) return RELEASY_ERROR;
+
+    tag_index_stamp_t stamp;
+    int ret = read_stamp(repo, &stamp);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    ret = map_index(index, repo);
+    if (ret == RELEASY_SUCCESS) {
+        if (stamp_matches(index, &stamp)) return RELEASY_SUCCESS;
+        tag_index_close(index);
+    } else if (ret == TAG_INDEX_ERR_MEMORY) {
+        return ret;
+    }
+
+    ret = tag_index_build(repo);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    return map_index(index, repo);
+}
+
+int tag_index_is_fresh(git_repository *repo) {
+    if (!repo) return 0;
+
+    tag_index_stamp_t stamp;
+    if (read_stamp(repo, &stamp) != RELEASY_SUCCESS) return 0;
+
+    tag_index_t index;
+    if (map_index(&index, repo) != RELEASY_SUCCESS) return 0;
+
+    int fresh = stamp_matches(&index, &stamp);
+    tag_index_close(&index);
+    return fresh;
+}
+
+int tag_index_read_stamp(git_repository *repo, tag_index_stamp_t *stamp) {
+    if (!repo || !stamp) return RELEASY_ERROR;
+    return read_stamp(repo, stamp);
+}
+
+// The index's tags with tag_name added, or replaced if it was already there
+static int merge_created(const tag_index_t *index, const char *tag_name, const git_oid *commit,
+                         version_list_t *list) {
+    int ret = RELEASY_SUCCESS;
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < index->count; i++) {
+        const char *name = tag_index_name(index, i);
+        if (!name) return TAG_INDEX_ERR_CORRUPT;
+        if (strcmp(name, tag_name) == 0) continue;
+
+        git_oid oid;
+        git_oid_fromraw(&oid, index->entries[i].commit);
+        ret = version_list_add_commit(list, name, &oid);
+    }
+    if (ret == RELEASY_SUCCESS) ret = version_list_add_commit(list, tag_name, commit);
+    return ret == VERSION_LIST_ERR_MEMORY ? TAG_INDEX_ERR_MEMORY : ret;
+}
+
+static int compare_names(const void *a, const void *b) {
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+/*
+ * Whether the refdb has exactly the version tags in list. Only names are
+ * read, so this costs a listing of refs/tags and never a peel.
+ */
+static int refdb_matches(git_repository *repo, const version_list_t *list, int *matches) {
+    *matches = 0;
+
+    const char **names = malloc((list->count ? list->count : 1) * sizeof(char *));
+    if (!names) return TAG_INDEX_ERR_MEMORY;
+    for (size_t i = 0; i < list->count; i++) names[i] = list->items[i].tag;
+    qsort(names, list->count, sizeof(char *), compare_names);
+
+    git_reference_iterator *iter = NULL;
+    if (git_reference_iterator_glob_new(&iter, repo, TAG_REF_PREFIX "*") != 0) {
+        free(names);
+        return TAG_INDEX_ERR_GIT_OPERATION;
+    }
+
+    const char *name;
+    int error;
+    size_t seen = 0;
+    int missing = 0;
+    while (!missing && (error = git_reference_next_name(&name, iter)) == 0) {
+        const char *tag = name + strlen(TAG_REF_PREFIX);
+        const char *version = tag[0] == 'v' ? tag + 1 : tag;
+        semver_key_t key;
+        if (semver_key_parse(version, strlen(version), &key) != RELEASY_SUCCESS) continue;
+
+        if (bsearch(&tag, names, list->count, sizeof(char *), compare_names)) {
+            seen++;
+        } else {
+            missing = 1;
+        }
+    }
+    git_reference_iterator_free(iter);
+    free(names);
+
+    if (!missing && error != GIT_ITEROVER) return TAG_INDEX_ERR_GIT_OPERATION;
+    *matches = !missing && seen == list->count;
+    return RELEASY_SUCCESS;
+}
+
+/*
+ * Records a tag this process just wrote, so the next run does not have to
+ * peel every tag again. before is the stamp tag_index_read_stamp() gave
+ * right before the tag was written.
+ *
+ * The index is patched under its lock, and only when it was current at
+ * before and the refdb now lists no version tag besides the indexed ones
+ * and this one. A tag another process added or deleted in the meantime
+ * fails that check, and the index is left stale for tag_index_open() to
+ * rebuild. Non-version tags still move the stamp forward.
+ */
+int tag_index_note_created(git_repository *repo, const tag_index_stamp_t *before,
+                           const char *tag_name, const git_oid *commit) {
+    if (!repo || !before || !tag_name || !commit) return RELEASY_ERROR;
+
+    char *path = index_file_path(repo);
+    if (!path) return TAG_INDEX_ERR_MEMORY;
+
+    sidecar_writer_t writer;
+    int ret = sidecar_begin(&writer, path);
+    free(path);
+    if (ret == SIDECAR_ERR_MEMORY) return TAG_INDEX_ERR_MEMORY;
+    // Locked by another writer, or .git is read-only: left to the next rebuild
+    if (ret != RELEASY_SUCCESS) return RELEASY_SUCCESS;
+
+    // Taken before the refdb is listed, so a tag written after the check
+    // still leaves the patched index stale
+    tag_index_stamp_t stamp;
+    ret = read_stamp(repo, &stamp);
+
+    version_list_t list;
+    version_list_init(&list);
+
+    tag_index_t index;
+    int patch = 0;
+    if (ret == RELEASY_SUCCESS && map_index(&index, repo) == RELEASY_SUCCESS) {
+        patch = stamp_matches(&index, before);
+        if (patch) ret = merge_created(&index, tag_name, commit, &list);
+        tag_index_close(&index);
+    }
+    if (ret == RELEASY_SUCCESS && patch) ret = refdb_matches(repo, &list, &patch);
+
+    int ok = ret == RELEASY_SUCCESS && patch;
+    if (ok) {
+        version_list_sort(&list);
+        ok = write_entries(writer.file, &list, &stamp);
+        if (!ok) ret = TAG_INDEX_ERR_FILE_ACCESS;
+    }
+    version_list_cleanup(&list);
+
+    int committed = sidecar_commit(&writer, ok);
+    if (ok && committed != RELEASY_SUCCESS) ret = TAG_INDEX_ERR_FILE_ACCESS;
+    return ret;
+}
+
+const char *tag_index_name(const tag_index_t *index, size_t i) {
+    if (!index || i >= index->count) return NULL;
+
+    const tag_index_entry_t *entry = &index->entries[i];
+    uint64_t end = (uint64_t)entry->name_offset + entry->name_length;
+    if (end >= index->header->names_size || index->names[end] != '\0') return NULL;
+
+    return index->names + entry->name_offset;
+}
+
+void tag_index_close(tag_index_t *index) {
+    if (!index) return;
+    if (index->map) munmap(index->map, index->map_size);
+    memset(index, 0, sizeof(tag_index_t));
+}
+
+const char *tag_index_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case TAG_INDEX_ERR_CORRUPT:
+            return "Tag index is corrupt";
+        case TAG_INDEX_ERR_FILE_ACCESS:
+            return "Failed to access tag index";
+        case TAG_INDEX_ERR_GIT_OPERATION:
+            return "Failed to read tags from repository";
+        case TAG_INDEX_ERR_MEMORY:
+            return "Memory allocation failed";
+        default:
+            return "Unknown error";
+    }
+}
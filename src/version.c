@@ -5,6 +5,8 @@
 #include <ctype.h>
 #include "version.h"
 #include "git_ops.h"
+#include "version_list.h"
+#include "tag_index.h"
 
 int version_init(version_info_t *info) {
     if (!info) return RELEASY_ERROR;
@@ -230,6 +232,10 @@ int version_create_tag(git_repository *repo, version_info_t *info, const char *m
         return VERSION_ERR_GIT_OPERATION;
     }
     
+    // The tag index compares against this to see what else changed
+    tag_index_stamp_t refs_before;
+    int stamped = tag_index_read_stamp(repo, &refs_before) == RELEASY_SUCCESS;
+    
     git_oid tag_oid;
     error = git_tag_create(
         &tag_oid,
@@ -241,6 +247,10 @@ int version_create_tag(git_repository *repo, version_info_t *info, const char *m
         0
     );
     
+    if (!error && stamped) {
+        tag_index_note_created(repo, &refs_before, tag_name, git_commit_id(head_commit));
+    }
+    
     git_signature_free(tagger);
     git_commit_free(head_commit);
     
@@ -278,58 +288,19 @@ int version_compare(const char *version1, const char *version2) {
 int version_get_latest(git_repository *repo, char *version_buf, size_t buf_size) {
     if (!repo || !version_buf || buf_size == 0) return RELEASY_ERROR;
     
-    git_strarray tags = {0};
-    int error = git_tag_list(&tags, repo);
-    if (error) return VERSION_ERR_GIT_OPERATION;
-    
-    if (tags.count == 0) {
-        git_strarray_free(&tags);
-        return VERSION_ERR_NO_PREVIOUS_VERSION;
-    }
-    
-    // Find latest version tag
-    semver_t latest = {0};
-    char *latest_tag = NULL;
-    int found = 0;
-    
-    for (size_t i = 0; i < tags.count; i++) {
-        // Skip non-version tags
-        if (!git_ops_is_version_tag(NULL, tags.strings[i])) continue;
-        
-        // Parse version (skip 'v' prefix if present)
-        const char *ver = tags.strings[i];
-        if (ver[0] == 'v') ver++;
-        
-        semver_t current;
-        if (semver_parse(ver, &current) == 0) {
-            if (!found || semver_compare(&current, &latest) > 0) {
-                if (found) semver_free(&latest);
-                latest = current;
-                latest_tag = tags.strings[i];
-                found = 1;
-            } else {
-                semver_free(&current);
-            }
-        }
-    }
-    
-    int ret = RELEASY_SUCCESS;
-    if (found) {
-        // Copy version to buffer (skip 'v' prefix if present)
-        const char *ver = latest_tag;
-        if (ver[0] == 'v') ver++;
-        if (strlen(ver) >= buf_size) {
-            ret = VERSION_ERR_INVALID_FORMAT;
-        } else {
-            strcpy(version_buf, ver);
-        }
-        semver_free(&latest);
-    } else {
-        ret = VERSION_ERR_NO_PREVIOUS_VERSION;
+    int ret = version_list_select_latest(repo, NULL, version_buf, buf_size);
+    switch (ret) {
+        case RELEASY_SUCCESS:
+            return RELEASY_SUCCESS;
+        case VERSION_LIST_ERR_NOT_FOUND:
+            return VERSION_ERR_NO_PREVIOUS_VERSION;
+        case VERSION_LIST_ERR_BUFFER_TOO_SMALL:
+            return VERSION_ERR_INVALID_FORMAT;
+        case VERSION_LIST_ERR_MEMORY:
+            return VERSION_ERR_MEMORY;
+        default:
+            return VERSION_ERR_GIT_OPERATION;
     }
-    
-    git_strarray_free(&tags);
-    return ret;
 }
 
 void version_cleanup(version_info_t *info) {
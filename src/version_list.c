@@ -0,0 +1,336 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "version_list.h"
+#include "tag_index.h"
+
+#define TAG_REF_PREFIX "refs/tags/"
+#define TAG_REF_GLOB TAG_REF_PREFIX "*"
+
+typedef int (*tag_name_cb)(const char *tag, void *payload);
+
+/*
+ * Streams tag names straight from the refdb. Only names are read, so tags
+ * are never peeled and no git_strarray copy of the whole list is made.
+ */
+static int foreach_tag_name(git_repository *repo, tag_name_cb callback, void *payload) {
+    git_reference_iterator *iter = NULL;
+    if (git_reference_iterator_glob_new(&iter, repo, TAG_REF_GLOB) != 0) {
+        return VERSION_LIST_ERR_GIT_OPERATION;
+    }
+
+    const char *name;
+    int error;
+    while ((error = git_reference_next_name(&name, iter)) == 0) {
+        int ret = callback(name + strlen(TAG_REF_PREFIX), payload);
+        if (ret != RELEASY_SUCCESS) {
+            git_reference_iterator_free(iter);
+            return ret;
+        }
+    }
+
+    git_reference_iterator_free(iter);
+    return error == GIT_ITEROVER ? RELEASY_SUCCESS : VERSION_LIST_ERR_GIT_OPERATION;
+}
+
+int version_list_init(version_list_t *list) {
+    if (!list) return RELEASY_ERROR;
+    memset(list, 0, sizeof(version_list_t));
+    return RELEASY_SUCCESS;
+}
+
+/*
+ * Adds a tag if it names a version. Non-version tags are skipped and still
+ * count as success, so callers can feed every tag in the repository.
+ */
+int version_list_add(version_list_t *list, const char *tag) {
+    return version_list_add_commit(list, tag, NULL);
+}
+
+int version_list_add_commit(version_list_t *list, const char *tag, const git_oid *commit) {
+    if (!list || !tag) return RELEASY_ERROR;
+
+    // Skip 'v' prefix if present
+    const char *version = tag[0] == 'v' ? tag + 1 : tag;
+
+    semver_key_t key;
+    if (semver_key_parse(version, strlen(version), &key) != RELEASY_SUCCESS) {
+        return RELEASY_SUCCESS;
+    }
+
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        version_list_item_t *items = realloc(list->items, capacity * sizeof(version_list_item_t));
+        if (!items) return VERSION_LIST_ERR_MEMORY;
+        list->items = items;
+        list->capacity = capacity;
+    }
+
+    version_list_item_t *item = &list->items[list->count];
+    item->tag = strdup(tag);
+    if (!item->tag) return VERSION_LIST_ERR_MEMORY;
+    item->version = item->tag + (version - tag);
+    item->key = key;
+    if (commit) {
+        item->commit = *commit;
+    } else {
+        memset(&item->commit, 0, sizeof(git_oid));
+    }
+    list->count++;
+
+    return RELEASY_SUCCESS;
+}
+
+static int item_compare(const void *a, const void *b) {
+    const version_list_item_t *item_a = a;
+    const version_list_item_t *item_b = b;
+
+    return semver_key_compare_exact(&item_a->key, item_a->version,
+                                    &item_b->key, item_b->version);
+}
+
+void version_list_sort(version_list_t *list) {
+    if (!list || list->count < 2) return;
+    qsort(list->items, list->count, sizeof(version_list_item_t), item_compare);
+}
+
+static int add_tag_callback(const char *tag, void *payload) {
+    return version_list_add(payload, tag);
+}
+
+/*
+ * Copies the tag index into the list. Entries are stored already sorted, so
+ * no parsing or sorting is needed.
+ */
+static int load_from_index(version_list_t *list, const tag_index_t *index) {
+    if (index->count > list->capacity) {
+        version_list_item_t *items = realloc(list->items, index->count * sizeof(version_list_item_t));
+        if (!items) return VERSION_LIST_ERR_MEMORY;
+        list->items = items;
+        list->capacity = index->count;
+    }
+
+    for (size_t i = 0; i < index->count; i++) {
+        const char *name = tag_index_name(index, i);
+        if (!name) return VERSION_LIST_ERR_GIT_OPERATION;
+
+        version_list_item_t *item = &list->items[list->count];
+        item->tag = strdup(name);
+        if (!item->tag) return VERSION_LIST_ERR_MEMORY;
+        item->version = item->tag + (name[0] == 'v' ? 1 : 0);
+        item->key = index->entries[i].key;
+        git_oid_fromraw(&item->commit, index->entries[i].commit);
+        list->count++;
+    }
+
+    return RELEASY_SUCCESS;
+}
+
+int version_list_load(version_list_t *list, git_repository *repo) {
+    if (!list || !repo) return RELEASY_ERROR;
+
+    tag_index_t index;
+    if (list->count == 0 && tag_index_open(&index, repo) == RELEASY_SUCCESS) {
+        int ret = load_from_index(list, &index);
+        tag_index_close(&index);
+        if (ret == RELEASY_SUCCESS) return ret;
+        version_list_cleanup(list);
+    }
+
+    // No usable index (read-only .git, corrupt file): list the refdb directly
+    int ret = foreach_tag_name(repo, add_tag_callback, list);
+    if (ret != RELEASY_SUCCESS) return ret;
+
+    version_list_sort(list);
+    return RELEASY_SUCCESS;
+}
+
+const version_list_item_t *version_list_latest(const version_list_t *list) {
+    if (!list || list->count == 0) return NULL;
+    return &list->items[list->count - 1];
+}
+
+/*
+ * Hands the tag names over to the caller as a plain array, in list order.
+ * The list is left empty.
+ */
+int version_list_detach(version_list_t *list, char ***tags, size_t *count) {
+    if (!list || !tags || !count) return RELEASY_ERROR;
+
+    *tags = NULL;
+    *count = 0;
+    if (list->count == 0) return RELEASY_SUCCESS;
+
+    char **names = malloc(list->count * sizeof(char *));
+    if (!names) return RELEASY_ERROR;
+
+    for (size_t i = 0; i < list->count; i++) {
+        names[i] = list->items[i].tag;
+        list->items[i].tag = NULL;
+    }
+
+    *tags = names;
+    *count = list->count;
+    list->count = 0;
+    return RELEASY_SUCCESS;
+}
+
+void version_list_cleanup(version_list_t *list) {
+    if (!list) return;
+
+    for (size_t i = 0; i < list->count; i++) {
+        free(list->items[i].tag);
+    }
+    free(list->items);
+    memset(list, 0, sizeof(version_list_t));
+}
+
+int version_filter_matches(const version_filter_t *filter, const semver_view_t *view) {
+    if (!filter) return 1;
+    if (!view) return 0;
+
+    if (filter->major != VERSION_FILTER_ANY && filter->major != view->major) return 0;
+    if (filter->minor != VERSION_FILTER_ANY && filter->minor != view->minor) return 0;
+    if (filter->patch != VERSION_FILTER_ANY && filter->patch != view->patch) return 0;
+
+    switch (filter->match) {
+        case VERSION_MATCH_RELEASE:
+            return view->prerelease.length == 0;
+        case VERSION_MATCH_PRERELEASE:
+            return view->prerelease.length != 0;
+        default:
+            return 1;
+    }
+}
+
+typedef struct {
+    const version_filter_t *filter;
+    semver_key_t key;
+    char *version;
+    size_t capacity;
+} latest_state_t;
+
+static int select_latest_callback(const char *tag, void *payload) {
+    latest_state_t *state = payload;
+
+    // Skip 'v' prefix if present
+    const char *version = tag[0] == 'v' ? tag + 1 : tag;
+    size_t len = strlen(version);
+
+    semver_view_t view;
+    if (semver_parse_view(version, len, &view) != RELEASY_SUCCESS) return RELEASY_SUCCESS;
+    if (!version_filter_matches(state->filter, &view)) return RELEASY_SUCCESS;
+
+    semver_key_t key;
+    semver_key_from_view(&key, version, &view);
+
+    if (state->version) {
+        if (semver_key_compare_exact(&key, version, &state->key, state->version) <= 0) {
+            return RELEASY_SUCCESS;
+        }
+    }
+
+    // Only a new maximum is copied, the iterator owns the name otherwise
+    if (len + 1 > state->capacity) {
+        size_t capacity = len + 1 > 64 ? len + 1 : 64;
+        char *buf = realloc(state->version, capacity);
+        if (!buf) return VERSION_LIST_ERR_MEMORY;
+        state->version = buf;
+        state->capacity = capacity;
+    }
+    memcpy(state->version, version, len + 1);
+    state->key = key;
+
+    return RELEASY_SUCCESS;
+}
+
+// Filters on the packed key so index entries never have to be reparsed
+static int filter_matches_key(const version_filter_t *filter, const semver_key_t *key) {
+    if (!filter) return 1;
+
+    long long major = (long long)(key->prefix[0] >> 32);
+    long long minor = (long long)(key->prefix[0] & 0xffffffffu);
+    long long patch = (long long)(key->prefix[1] >> 32);
+    int release = (key->prefix[1] & SEMVER_KEY_RELEASE) != 0;
+
+    if (filter->major != VERSION_FILTER_ANY && filter->major != major) return 0;
+    if (filter->minor != VERSION_FILTER_ANY && filter->minor != minor) return 0;
+    if (filter->patch != VERSION_FILTER_ANY && filter->patch != patch) return 0;
+
+    switch (filter->match) {
+        case VERSION_MATCH_RELEASE:
+            return release;
+        case VERSION_MATCH_PRERELEASE:
+            return !release;
+        default:
+            return 1;
+    }
+}
+
+static int select_latest_from_index(const tag_index_t *index, const version_filter_t *filter,
+                                    char *version, size_t size) {
+    // Entries are sorted oldest first, so the first match from the end wins
+    for (size_t i = index->count; i-- > 0;) {
+        if (!filter_matches_key(filter, &index->entries[i].key)) continue;
+
+        const char *name = tag_index_name(index, i);
+        if (!name) return VERSION_LIST_ERR_GIT_OPERATION;
+        if (name[0] == 'v') name++;
+
+        if (strlen(name) >= size) return VERSION_LIST_ERR_BUFFER_TOO_SMALL;
+        strcpy(version, name);
+        return RELEASY_SUCCESS;
+    }
+
+    return VERSION_LIST_ERR_NOT_FOUND;
+}
+
+/*
+ * Finds the highest version tag matching filter (NULL matches everything) in
+ * the tag index, or in a single pass over refs/tags keeping only the running
+ * maximum when there is no index. The version is written without its 'v'
+ * prefix.
+ */
+int version_list_select_latest(git_repository *repo, const version_filter_t *filter,
+                               char *version, size_t size) {
+    if (!repo || !version || size == 0) return RELEASY_ERROR;
+
+    tag_index_t index;
+    if (tag_index_open(&index, repo) == RELEASY_SUCCESS) {
+        int ret = select_latest_from_index(&index, filter, version, size);
+        tag_index_close(&index);
+        if (ret != VERSION_LIST_ERR_GIT_OPERATION) return ret;
+    }
+
+    latest_state_t state = { .filter = filter };
+    int ret = foreach_tag_name(repo, select_latest_callback, &state);
+
+    if (ret == RELEASY_SUCCESS && !state.version) {
+        ret = VERSION_LIST_ERR_NOT_FOUND;
+    } else if (ret == RELEASY_SUCCESS && strlen(state.version) >= size) {
+        ret = VERSION_LIST_ERR_BUFFER_TOO_SMALL;
+    } else if (ret == RELEASY_SUCCESS) {
+        strcpy(version, state.version);
+    }
+
+    free(state.version);
+    return ret;
+}
+
+const char *version_list_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case VERSION_LIST_ERR_NOT_FOUND:
+            return "No matching version tag found";
+        case VERSION_LIST_ERR_GIT_OPERATION:
+            return "Failed to read tags from repository";
+        case VERSION_LIST_ERR_MEMORY:
+            return "Memory allocation failed";
+        case VERSION_LIST_ERR_BUFFER_TOO_SMALL:
+            return "Version does not fit in buffer";
+        default:
+            return "Unknown error";
+    }
+}
@@ -0,0 +1,752 @@
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "worktree_status.h"
+
+// Any negative return from a notify callback aborts the diff
+#define STOP_DIFF -1
+
+// Shards per worker; more shards than workers keeps the pool busy when
+// some directories are much slower to stat than others
+#define SHARDS_PER_WORKER 8
+
+typedef struct {
+    int found;
+} change_probe_t;
+
+static int stop_at_first_delta(const git_diff *diff_so_far, const git_diff_delta *delta,
+                               const char *matched_pathspec, void *payload) {
+    (void)diff_so_far;
+    (void)delta;
+    (void)matched_pathspec;
+
+    ((change_probe_t *)payload)->found = 1;
+    return STOP_DIFF;
+}
+
+static int head_tree(git_repository *repo, git_object **tree) {
+    // An unborn HEAD compares against the empty tree
+    *tree = NULL;
+    if (git_repository_head_unborn(repo) == 1) return RELEASY_SUCCESS;
+
+    return git_revparse_single(tree, repo, "HEAD^{tree}") == 0 ? RELEASY_SUCCESS
+                                                               : WORKTREE_ERR_GIT_OPERATION;
+}
+
+static int has_staged_changes(git_repository *repo, git_index *index, int *found) {
+    git_object *tree = NULL;
+    if (head_tree(repo, &tree) != RELEASY_SUCCESS) return WORKTREE_ERR_GIT_OPERATION;
+
+    change_probe_t probe = {0};
+    git_diff_options opts;
+    git_diff_options_init(&opts, GIT_DIFF_OPTIONS_VERSION);
+    opts.notify_cb = stop_at_first_delta;
+    opts.payload = &probe;
+
+    git_diff *diff = NULL;
+    int error = git_diff_tree_to_index(&diff, repo, (git_tree *)tree, index, &opts);
+    git_diff_free(diff);
+    git_object_free(tree);
+
+    *found = probe.found;
+    return probe.found || error == 0 ? RELEASY_SUCCESS : WORKTREE_ERR_GIT_OPERATION;
+}
+
+/*
+ * Index against worktree. libgit2 only hashes a file when its stat data
+ * disagrees with the index, untracked directories come back as a single
+ * entry, and ignored directories are never entered. The index is only
+ * read: a racily clean file is hashed again on every check rather than
+ * having its stat data written back behind git's back.
+ */
+static int has_worktree_changes(git_repository *repo, git_index *index, int *found) {
+    change_probe_t probe = {0};
+    git_diff_options opts;
+    git_diff_options_init(&opts, GIT_DIFF_OPTIONS_VERSION);
+    opts.flags = GIT_DIFF_INCLUDE_UNTRACKED;
+    opts.notify_cb = stop_at_first_delta;
+    opts.payload = &probe;
+
+    git_diff *diff = NULL;
+    int error = git_diff_index_to_workdir(&diff, repo, index, &opts);
+    git_diff_free(diff);
+
+    *found = probe.found;
+    return probe.found || error == 0 ? RELEASY_SUCCESS : WORKTREE_ERR_GIT_OPERATION;
+}
+
+// Directories get a trailing '/', the way git status lists untracked ones
+static int report_add(worktree_report_t *report, const char *path, size_t len, int is_dir,
+                      unsigned int status) {
+    if (report->count == report->capacity) {
+        size_t capacity = report->capacity ? report->capacity * 2 : 16;
+        worktree_change_t *changes = realloc(report->changes, capacity * sizeof(worktree_change_t));
+        if (!changes) return WORKTREE_ERR_MEMORY;
+        report->changes = changes;
+        report->capacity = capacity;
+    }
+
+    char *copy = malloc(len + 2);
+    if (!copy) return WORKTREE_ERR_MEMORY;
+    memcpy(copy, path, len);
+    if (is_dir) copy[len++] = '/';
+    copy[len] = '\0';
+
+    report->changes[report->count].path = copy;
+    report->changes[report->count].status = status;
+    report->count++;
+    return RELEASY_SUCCESS;
+}
+
+static int change_compare(const void *a, const void *b) {
+    return strcmp(((const worktree_change_t *)a)->path, ((const worktree_change_t *)b)->path);
+}
+
+// Sorts by path and folds index and worktree findings for one path together
+static void report_finish(worktree_report_t *report) {
+    if (report->count < 2) return;
+    qsort(report->changes, report->count, sizeof(worktree_change_t), change_compare);
+
+    size_t out = 0;
+    for (size_t i = 1; i < report->count; i++) {
+        worktree_change_t *last = &report->changes[out];
+        if (strcmp(last->path, report->changes[i].path) == 0) {
+            last->status |= report->changes[i].status;
+            free(report->changes[i].path);
+        } else {
+            report->changes[++out] = report->changes[i];
+        }
+    }
+    report->count = out + 1;
+}
+
+static unsigned int index_status(git_delta_t status) {
+    switch (status) {
+        case GIT_DELTA_ADDED:
+            return GIT_STATUS_INDEX_NEW;
+        case GIT_DELTA_DELETED:
+            return GIT_STATUS_INDEX_DELETED;
+        case GIT_DELTA_RENAMED:
+            return GIT_STATUS_INDEX_RENAMED;
+        case GIT_DELTA_TYPECHANGE:
+            return GIT_STATUS_INDEX_TYPECHANGE;
+        case GIT_DELTA_CONFLICTED:
+            return GIT_STATUS_CONFLICTED;
+        default:
+            return GIT_STATUS_INDEX_MODIFIED;
+    }
+}
+
+static int report_staged_changes(git_repository *repo, git_index *index, worktree_report_t *report) {
+    git_object *tree = NULL;
+    if (head_tree(repo, &tree) != RELEASY_SUCCESS) return WORKTREE_ERR_GIT_OPERATION;
+
+    git_diff *diff = NULL;
+    int error = git_diff_tree_to_index(&diff, repo, (git_tree *)tree, index, NULL);
+    git_object_free(tree);
+    if (error) return WORKTREE_ERR_GIT_OPERATION;
+
+    int ret = RELEASY_SUCCESS;
+    size_t count = git_diff_num_deltas(diff);
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < count; i++) {
+        const git_diff_delta *delta = git_diff_get_delta(diff, i);
+        const char *path = delta->new_file.path ? delta->new_file.path : delta->old_file.path;
+        ret = report_add(report, path, strlen(path), 0, index_status(delta->status));
+    }
+
+    git_diff_free(diff);
+    return ret;
+}
+
+// The serial path for the full report: one git_status_list, copied out
+static int report_from_status_list(git_repository *repo, worktree_report_t *report) {
+    git_status_options opts;
+    git_status_options_init(&opts, GIT_STATUS_OPTIONS_VERSION);
+    opts.show = GIT_STATUS_SHOW_INDEX_AND_WORKDIR;
+    opts.flags = GIT_STATUS_OPT_INCLUDE_UNTRACKED;
+
+    git_status_list *list = NULL;
+    if (git_status_list_new(&list, repo, &opts) != 0) return WORKTREE_ERR_GIT_OPERATION;
+
+    int ret = RELEASY_SUCCESS;
+    size_t count = git_status_list_entrycount(list);
+    for (size_t i = 0; ret == RELEASY_SUCCESS && i < count; i++) {
+        const git_status_entry *entry = git_status_byindex(list, i);
+        const git_diff_delta *delta = entry->index_to_workdir ? entry->index_to_workdir
+                                                              : entry->head_to_index;
+        if (!delta) continue;
+        const char *path = delta->new_file.path ? delta->new_file.path : delta->old_file.path;
+        ret = report_add(report, path, strlen(path), 0, entry->status);
+    }
+
+    git_status_list_free(list);
+    return ret;
+}
+
+/*
+ * Parallel verification
+ *
+ * Workers only stat() and readdir() the worktree against a read-only copy
+ * of the index entries; nothing touches libgit2 from more than one thread.
+ * What they find is split into certain changes (missing file, new size,
+ * conflict) and hits that need libgit2 to decide (touched but maybe
+ * unchanged files, untracked names that may be ignored). The latter are
+ * settled on the calling thread after the pool is done, which is cheap
+ * because a clean tree produces almost none of them.
+ */
+
+typedef enum {
+    HIT_CONFLICT,
+    HIT_DELETED,
+    HIT_MODIFIED,
+    HIT_SUSPECT,
+    HIT_UNTRACKED_FILE,
+    HIT_UNTRACKED_DIR
+} hit_kind_t;
+
+typedef struct {
+    hit_kind_t kind;
+    char *path;
+} scan_hit_t;
+
+typedef struct {
+    scan_hit_t *hits;
+    size_t count;
+    size_t capacity;
+    int error;
+} scan_result_t;
+
+typedef struct {
+    const git_index_entry **entries;
+    size_t count;
+    size_t *shard_starts;       // shard_count + 1 boundaries
+    size_t shard_count;
+    int root_fd;
+    struct timespec index_mtime;
+    int collect_all;
+    atomic_size_t next_shard;
+    atomic_int stop;
+} scan_shared_t;
+
+typedef struct {
+    scan_shared_t *shared;
+    scan_result_t result;
+} scan_worker_t;
+
+static int is_certain(hit_kind_t kind) {
+    return kind == HIT_CONFLICT || kind == HIT_DELETED || kind == HIT_MODIFIED;
+}
+
+static void record_hit(scan_shared_t *shared, scan_result_t *result, hit_kind_t kind,
+                       const char *path, size_t len) {
+    if (result->error) return;
+
+    if (result->count == result->capacity) {
+        size_t capacity = result->capacity ? result->capacity * 2 : 16;
+        scan_hit_t *hits = realloc(result->hits, capacity * sizeof(scan_hit_t));
+        if (!hits) {
+            result->error = WORKTREE_ERR_MEMORY;
+            atomic_store(&shared->stop, 1);
+            return;
+        }
+        result->hits = hits;
+        result->capacity = capacity;
+    }
+
+    char *copy = malloc(len + 1);
+    if (!copy) {
+        result->error = WORKTREE_ERR_MEMORY;
+        atomic_store(&shared->stop, 1);
+        return;
+    }
+    memcpy(copy, path, len);
+    copy[len] = '\0';
+
+    result->hits[result->count].kind = kind;
+    result->hits[result->count].path = copy;
+    result->count++;
+
+    if (is_certain(kind) && !shared->collect_all) atomic_store(&shared->stop, 1);
+}
+
+// First entry whose path is >= key
+static size_t lower_bound(const scan_shared_t *shared, const char *key) {
+    size_t lo = 0, hi = shared->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcmp(shared->entries[mid]->path, key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// A path is tracked if it is an index entry or a directory holding one
+static int is_tracked(const scan_shared_t *shared, char *path, size_t len) {
+    size_t i = lower_bound(shared, path);
+    if (i < shared->count && strcmp(shared->entries[i]->path, path) == 0) return 1;
+
+    path[len] = '/';
+    path[len + 1] = '\0';
+    i = lower_bound(shared, path);
+    int tracked = i < shared->count && strncmp(shared->entries[i]->path, path, len + 1) == 0;
+    path[len] = '\0';
+    return tracked;
+}
+
+// Lists one tracked directory and records every name the index doesn't know
+static void scan_directory(scan_shared_t *shared, scan_result_t *result, const char *dir, size_t dir_len) {
+    int fd = openat(shared->root_fd, dir_len ? dir : ".", O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return;  // Gone or unreadable; the entries below it will say so
+
+    DIR *d = fdopendir(fd);
+    if (!d) {
+        close(fd);
+        return;
+    }
+
+    char path[PATH_MAX];
+    struct dirent *ent;
+    while (!atomic_load(&shared->stop) && (ent = readdir(d)) != NULL) {
+        const char *name = ent->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        if (dir_len == 0 && strcmp(name, ".git") == 0) continue;
+
+        size_t name_len = strlen(name);
+        size_t len = dir_len ? dir_len + 1 + name_len : name_len;
+        if (len + 2 > sizeof(path)) continue;
+        if (dir_len) {
+            memcpy(path, dir, dir_len);
+            path[dir_len] = '/';
+            memcpy(path + dir_len + 1, name, name_len + 1);
+        } else {
+            memcpy(path, name, name_len + 1);
+        }
+
+        if (is_tracked(shared, path, len)) continue;
+
+        int is_dir = ent->d_type == DT_DIR;
+        if (ent->d_type == DT_UNKNOWN) {
+            struct stat st;
+            is_dir = fstatat(shared->root_fd, path, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+        }
+        record_hit(shared, result, is_dir ? HIT_UNTRACKED_DIR : HIT_UNTRACKED_FILE, path, len);
+    }
+
+    closedir(d);
+}
+
+/*
+ * Lists the directories that entry i is the first to reach. Index paths are
+ * sorted, so every directory is reached first by exactly one entry and gets
+ * listed once no matter how the index was split into shards.
+ */
+static void scan_new_directories(scan_shared_t *shared, scan_result_t *result, size_t i) {
+    const char *path = shared->entries[i]->path;
+    const char *prev = i > 0 ? shared->entries[i - 1]->path : NULL;
+
+    if (!prev) scan_directory(shared, result, "", 0);
+
+    char dir[PATH_MAX];
+    for (const char *slash = strchr(path, '/'); slash; slash = strchr(slash + 1, '/')) {
+        size_t len = (size_t)(slash - path);
+        if (prev && strncmp(prev, path, len + 1) == 0) continue;
+        if (len >= sizeof(dir)) return;
+
+        memcpy(dir, path, len);
+        dir[len] = '\0';
+        scan_directory(shared, result, dir, len);
+    }
+}
+
+static int mtime_not_before(const git_index_time *t, const struct timespec *ts) {
+    if (t->seconds != (int32_t)ts->tv_sec) return t->seconds > (int32_t)ts->tv_sec;
+    return (long)t->nanoseconds >= ts->tv_nsec;
+}
+
+// The same stat comparison git does before deciding to hash a file
+static void check_entry(scan_shared_t *shared, scan_result_t *result, const git_index_entry *entry) {
+    const char *path = entry->path;
+    size_t len = strlen(path);
+
+    if (GIT_INDEX_ENTRY_STAGE(entry) > 0) {
+        record_hit(shared, result, HIT_CONFLICT, path, len);
+        return;
+    }
+    if (entry->flags_extended & GIT_INDEX_ENTRY_SKIP_WORKTREE) return;
+    if ((entry->flags_extended & GIT_INDEX_ENTRY_INTENT_TO_ADD) || entry->mode == GIT_FILEMODE_COMMIT) {
+        record_hit(shared, result, HIT_SUSPECT, path, len);
+        return;
+    }
+
+    struct stat st;
+    if (fstatat(shared->root_fd, path, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        record_hit(shared, result, errno == ENOENT || errno == ENOTDIR ? HIT_DELETED : HIT_SUSPECT,
+                   path, len);
+        return;
+    }
+
+    int want_link = entry->mode == GIT_FILEMODE_LINK;
+    if (S_ISDIR(st.st_mode) || (want_link ? !S_ISLNK(st.st_mode) : !S_ISREG(st.st_mode))) {
+        // A file swapped for a link may still be a typechange only on some
+        // platforms, so let libgit2 decide
+        record_hit(shared, result, S_ISDIR(st.st_mode) ? HIT_MODIFIED : HIT_SUSPECT, path, len);
+        return;
+    }
+
+    if ((uint32_t)st.st_size != entry->file_size) {
+        record_hit(shared, result, HIT_MODIFIED, path, len);
+        return;
+    }
+
+    int stat_differs = entry->mtime.seconds != (int32_t)st.st_mtim.tv_sec ||
+                       (entry->mtime.nanoseconds && entry->mtime.nanoseconds != (uint32_t)st.st_mtim.tv_nsec) ||
+                       (entry->ino && entry->ino != (uint32_t)st.st_ino) ||
+                       (!want_link && ((entry->mode & 0111) != 0) != ((st.st_mode & 0111) != 0));
+
+    // Racily clean: written in the same tick the index was, stat can't vouch for it
+    if (stat_differs || mtime_not_before(&entry->mtime, &shared->index_mtime)) {
+        record_hit(shared, result, HIT_SUSPECT, path, len);
+    }
+}
+
+static void *scan_worker(void *arg) {
+    scan_worker_t *worker = arg;
+    scan_shared_t *shared = worker->shared;
+
+    size_t shard;
+    while (!atomic_load(&shared->stop) &&
+           (shard = atomic_fetch_add(&shared->next_shard, 1)) < shared->shard_count) {
+        for (size_t i = shared->shard_starts[shard]; i < shared->shard_starts[shard + 1]; i++) {
+            if (atomic_load(&shared->stop)) break;
+            scan_new_directories(shared, &worker->result, i);
+            check_entry(shared, &worker->result, shared->entries[i]);
+        }
+    }
+
+    return NULL;
+}
+
+static int same_directory(const char *a, const char *b) {
+    const char *sa = strrchr(a, '/');
+    const char *sb = strrchr(b, '/');
+    size_t la = sa ? (size_t)(sa - a) : 0;
+    size_t lb = sb ? (size_t)(sb - b) : 0;
+    return la == lb && strncmp(a, b, la) == 0;
+}
+
+/*
+ * Splits the index into contiguous shards of roughly equal size. A boundary
+ * is pushed forward to the next directory change when one is close, so a
+ * directory's files are usually stat()ed by the same worker.
+ */
+static int make_shards(scan_shared_t *shared, size_t shard_count) {
+    shared->shard_starts = malloc((shard_count + 1) * sizeof(size_t));
+    if (!shared->shard_starts) return WORKTREE_ERR_MEMORY;
+
+    size_t size = (shared->count + shard_count - 1) / shard_count;
+    size_t n = 0;
+    size_t start = 0;
+    while (start < shared->count) {
+        shared->shard_starts[n++] = start;
+        size_t end = start + size < shared->count ? start + size : shared->count;
+        size_t limit = end + size / 2 < shared->count ? end + size / 2 : shared->count;
+        while (end < limit && same_directory(shared->entries[end - 1]->path, shared->entries[end]->path)) {
+            end++;
+        }
+        start = end;
+    }
+    shared->shard_starts[n] = shared->count;
+    shared->shard_count = n;
+    return RELEASY_SUCCESS;
+}
+
+static int worker_count(const worktree_scan_options_t *opts) {
+    long workers = opts->workers;
+    if (workers <= 0) workers = sysconf(_SC_NPROCESSORS_ONLN);
+    if (workers < 1) workers = 1;
+    if (workers > WORKTREE_MAX_WORKERS) workers = WORKTREE_MAX_WORKERS;
+    return (int)workers;
+}
+
+// Whether an untracked directory holds anything git status would show
+static int dir_has_unignored(git_repository *repo, int root_fd, char *path, size_t len, int *found) {
+    int fd = openat(root_fd, path, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return RELEASY_SUCCESS;
+    DIR *d = fdopendir(fd);
+    if (!d) {
+        close(fd);
+        return RELEASY_SUCCESS;
+    }
+
+    int ret = RELEASY_SUCCESS;
+    struct dirent *ent;
+    while (ret == RELEASY_SUCCESS && !*found && (ent = readdir(d)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+
+        size_t name_len = strlen(ent->d_name);
+        if (len + 1 + name_len + 2 > PATH_MAX) continue;
+        path[len] = '/';
+        memcpy(path + len + 1, ent->d_name, name_len + 1);
+        size_t child_len = len + 1 + name_len;
+
+        struct stat st;
+        int is_dir = fstatat(root_fd, path, &st, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(st.st_mode);
+
+        // Directories are matched with a trailing slash so "build/" rules apply
+        if (is_dir) {
+            path[child_len] = '/';
+            path[child_len + 1] = '\0';
+        }
+        int ignored = 0;
+        if (git_ignore_path_is_ignored(&ignored, repo, path) != 0) {
+            ret = WORKTREE_ERR_GIT_OPERATION;
+        } else if (!ignored && is_dir) {
+            path[child_len] = '\0';
+            ret = dir_has_unignored(repo, root_fd, path, child_len, found);
+        } else if (!ignored) {
+            *found = 1;
+        }
+        path[len] = '\0';
+    }
+
+    closedir(d);
+    return ret;
+}
+
+// Turns one worker hit into a status, or 0 when it turned out clean
+static int settle_hit(git_repository *repo, int root_fd, const scan_hit_t *hit, unsigned int *status) {
+    *status = 0;
+
+    switch (hit->kind) {
+        case HIT_CONFLICT:
+            *status = GIT_STATUS_CONFLICTED;
+            return RELEASY_SUCCESS;
+        case HIT_DELETED:
+            *status = GIT_STATUS_WT_DELETED;
+            return RELEASY_SUCCESS;
+        case HIT_MODIFIED:
+            *status = GIT_STATUS_WT_MODIFIED;
+            return RELEASY_SUCCESS;
+        case HIT_SUSPECT:
+            if (git_status_file(status, repo, hit->path) != 0) return WORKTREE_ERR_GIT_OPERATION;
+            *status &= ~(unsigned int)GIT_STATUS_IGNORED;
+            return RELEASY_SUCCESS;
+        case HIT_UNTRACKED_FILE: {
+            int ignored = 0;
+            if (git_ignore_path_is_ignored(&ignored, repo, hit->path) != 0) return WORKTREE_ERR_GIT_OPERATION;
+            if (!ignored) *status = GIT_STATUS_WT_NEW;
+            return RELEASY_SUCCESS;
+        }
+        case HIT_UNTRACKED_DIR: {
+            char path[PATH_MAX];
+            size_t len = strlen(hit->path);
+            if (len + 2 > sizeof(path)) return WORKTREE_ERR_FILE_ACCESS;
+            memcpy(path, hit->path, len);
+            path[len] = '/';
+            path[len + 1] = '\0';
+
+            int ignored = 0;
+            if (git_ignore_path_is_ignored(&ignored, repo, path) != 0) return WORKTREE_ERR_GIT_OPERATION;
+            if (ignored) return RELEASY_SUCCESS;
+
+            path[len] = '\0';
+            int found = 0;
+            int ret = dir_has_unignored(repo, root_fd, path, len, &found);
+            if (found) *status = GIT_STATUS_WT_NEW;
+            return ret;
+        }
+    }
+    return RELEASY_SUCCESS;
+}
+
+static int index_file_mtime(git_repository *repo, struct timespec *mtime) {
+    const char *gitdir = git_repository_path(repo);
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%sindex", gitdir);
+
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        // No index file yet: nothing can be racily clean against it
+        mtime->tv_sec = 0;
+        mtime->tv_nsec = 0;
+        return RELEASY_SUCCESS;
+    }
+    *mtime = st.st_mtim;
+    return RELEASY_SUCCESS;
+}
+
+static int parallel_worktree_scan(git_repository *repo, git_index *index, int workers,
+                                  int *dirty, worktree_report_t *report) {
+    scan_shared_t shared;
+    memset(&shared, 0, sizeof(shared));
+    shared.collect_all = report != NULL;
+    atomic_init(&shared.next_shard, 0);
+    atomic_init(&shared.stop, 0);
+
+    shared.count = git_index_entrycount(index);
+    shared.entries = malloc(shared.count * sizeof(git_index_entry *));
+    if (!shared.entries) return WORKTREE_ERR_MEMORY;
+    for (size_t i = 0; i < shared.count; i++) {
+        shared.entries[i] = git_index_get_byindex(index, i);
+    }
+    index_file_mtime(repo, &shared.index_mtime);
+
+    shared.root_fd = open(git_repository_workdir(repo), O_RDONLY | O_DIRECTORY);
+    int ret = shared.root_fd < 0 ? WORKTREE_ERR_FILE_ACCESS : RELEASY_SUCCESS;
+    if (ret == RELEASY_SUCCESS) ret = make_shards(&shared, (size_t)workers * SHARDS_PER_WORKER);
+
+    scan_worker_t *pool = NULL;
+    pthread_t *threads = NULL;
+    int started = 0;
+    if (ret == RELEASY_SUCCESS) {
+        pool = calloc((size_t)workers, sizeof(scan_worker_t));
+        threads = calloc((size_t)workers, sizeof(pthread_t));
+        if (!pool || !threads) ret = WORKTREE_ERR_MEMORY;
+    }
+
+    for (int i = 0; ret == RELEASY_SUCCESS && i < workers; i++) {
+        pool[i].shared = &shared;
+        if (pthread_create(&threads[i], NULL, scan_worker, &pool[i]) != 0) break;
+        started++;
+    }
+    // Whatever started covers every shard between them; with none, scan here
+    if (ret == RELEASY_SUCCESS && started == 0) {
+        pool[0].shared = &shared;
+        scan_worker(&pool[0]);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Settle on this thread; git_status_file() may reload the index, which
+    // is why workers copied every path they recorded
+    for (int w = 0; pool && w < workers; w++) {
+        scan_result_t *result = &pool[w].result;
+        if (ret == RELEASY_SUCCESS) ret = result->error;
+
+        for (size_t i = 0; ret == RELEASY_SUCCESS && i < result->count; i++) {
+            if (*dirty && !report) break;
+
+            unsigned int status = 0;
+            ret = settle_hit(repo, shared.root_fd, &result->hits[i], &status);
+            if (ret != RELEASY_SUCCESS || !status) continue;
+
+            *dirty = 1;
+            if (report) {
+                const scan_hit_t *hit = &result->hits[i];
+                ret = report_add(report, hit->path, strlen(hit->path),
+                                 hit->kind == HIT_UNTRACKED_DIR, status);
+            }
+        }
+
+        for (size_t i = 0; i < result->count; i++) {
+            free(result->hits[i].path);
+        }
+        free(result->hits);
+    }
+
+    if (shared.root_fd >= 0) close(shared.root_fd);
+    free(shared.shard_starts);
+    free(shared.entries);
+    free(pool);
+    free(threads);
+    return ret;
+}
+
+/*
+ * Runs the in-memory HEAD/index comparison first, then verifies the
+ * worktree. Indexes with at least parallel_min_entries entries are split
+ * into directory shards and stat()ed by a worker pool; smaller ones, and
+ * case-insensitive indexes where path lookups would need folding, go
+ * through libgit2 on this thread.
+ */
+int worktree_status_scan(git_repository *repo, const worktree_scan_options_t *opts,
+                         int *dirty, worktree_report_t *report) {
+    if (!repo || !dirty) return RELEASY_ERROR;
+    *dirty = 0;
+    if (report) memset(report, 0, sizeof(worktree_report_t));
+
+    worktree_scan_options_t defaults = WORKTREE_SCAN_OPTIONS_INIT;
+    if (!opts) opts = &defaults;
+
+    if (git_repository_is_bare(repo)) return WORKTREE_ERR_BARE;
+
+    git_index *index = NULL;
+    if (git_repository_index(&index, repo) != 0) return WORKTREE_ERR_GIT_OPERATION;
+
+    // Pick up changes made by other processes since the index was loaded
+    int ret = git_index_read(index, 0) == 0 ? RELEASY_SUCCESS : WORKTREE_ERR_GIT_OPERATION;
+
+    int workers = worker_count(opts);
+    size_t entries = git_index_entrycount(index);
+    int parallel = workers > 1 && entries > 0 && entries >= opts->parallel_min_entries &&
+                   !(git_index_caps(index) & GIT_INDEX_CAPABILITY_IGNORE_CASE);
+
+    if (ret == RELEASY_SUCCESS && report) {
+        if (parallel) {
+            ret = report_staged_changes(repo, index, report);
+            if (ret == RELEASY_SUCCESS) ret = parallel_worktree_scan(repo, index, workers, dirty, report);
+        } else {
+            ret = report_from_status_list(repo, report);
+        }
+        if (ret == RELEASY_SUCCESS) {
+            report_finish(report);
+            *dirty = report->count > 0;
+        } else {
+            worktree_report_cleanup(report);
+        }
+    } else if (ret == RELEASY_SUCCESS) {
+        if (git_index_has_conflicts(index)) *dirty = 1;
+        if (!*dirty) ret = has_staged_changes(repo, index, dirty);
+        if (ret == RELEASY_SUCCESS && !*dirty) {
+            ret = parallel ? parallel_worktree_scan(repo, index, workers, dirty, NULL)
+                           : has_worktree_changes(repo, index, dirty);
+        }
+    }
+
+    git_index_free(index);
+    return ret;
+}
+
+int worktree_status_is_dirty(git_repository *repo, int *dirty) {
+    return worktree_status_scan(repo, NULL, dirty, NULL);
+}
+
+void worktree_report_cleanup(worktree_report_t *report) {
+    if (!report) return;
+
+    for (size_t i = 0; i < report->count; i++) {
+        free(report->changes[i].path);
+    }
+    free(report->changes);
+    memset(report, 0, sizeof(worktree_report_t));
+}
+
+const char *worktree_status_error_string(int error_code) {
+    switch (error_code) {
+        case RELEASY_SUCCESS:
+            return "Success";
+        case WORKTREE_ERR_BARE:
+            return "Repository has no working directory";
+        case WORKTREE_ERR_GIT_OPERATION:
+            return "Failed to read working directory status";
+        case WORKTREE_ERR_FILE_ACCESS:
+            return "Failed to read working directory";
+        case WORKTREE_ERR_MEMORY:
+            return "Memory allocation failed";
+        default:
+            return "Unknown error";
+    }
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <assert.h>
+#include "arena.h"
+
+static void test_arena_alloc(void) {
+    printf("Testing arena allocation...\n");
+
+    arena_t arena;
+    arena_init(&arena);
+
+    // Allocations are aligned and never overlap
+    char *ptrs[10000];
+    for (size_t i = 0; i < 10000; i++) {
+        ptrs[i] = arena_alloc(&arena, i % 97 + 1);
+        assert(ptrs[i] != NULL);
+        assert(((uintptr_t)ptrs[i] % sizeof(void *)) == 0);
+        memset(ptrs[i], (int)(i & 0xff), i % 97 + 1);
+    }
+    for (size_t i = 0; i < 10000; i++) {
+        for (size_t j = 0; j < i % 97 + 1; j++) {
+            assert((unsigned char)ptrs[i][j] == (i & 0xff));
+        }
+    }
+
+    // Larger than any chunk still fits
+    char *big = arena_alloc(&arena, ARENA_MAX_CHUNK * 2);
+    assert(big != NULL);
+    big[ARENA_MAX_CHUNK * 2 - 1] = 'x';
+
+    char *str = arena_strdup(&arena, "feat(core): add arena");
+    assert(strcmp(str, "feat(core): add arena") == 0);
+    str = arena_strndup(&arena, "feat(core): add arena", 4);
+    assert(strcmp(str, "feat") == 0);
+    assert(arena_strdup(&arena, NULL) == NULL);
+
+    // Reset keeps one chunk and carves from its start again
+    arena_reset(&arena);
+    char *first = arena_alloc(&arena, 16);
+    arena_reset(&arena);
+    assert(arena_alloc(&arena, 16) == first);
+
+    arena_cleanup(&arena);
+    assert(arena.head == NULL);
+    arena_cleanup(&arena);
+
+    printf("Arena allocation tests passed!\n");
+}
+
+int main(void) {
+    printf("Running arena tests...\n\n");
+
+    test_arena_alloc();
+
+    printf("\nAll arena tests passed!\n");
+    return 0;
+}
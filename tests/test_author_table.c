@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "author_table.h"
+
+static void test_author_intern(void) {
+    printf("Testing author interning...\n");
+
+    author_table_t table;
+    author_table_init(&table);
+    assert(author_table_get(&table, AUTHOR_NONE) == NULL);
+
+    uint32_t ann = author_table_intern(&table, "Ann <ann@example.com>", 21);
+    uint32_t bob = author_table_intern(&table, "Bob <bob@example.com>", 21);
+    assert(ann == 1 && bob == 2);
+    assert(author_table_intern(&table, "Ann <ann@example.com>", 21) == ann);
+
+    // Only the given length is the key
+    assert(author_table_intern(&table, "Ann <ann@example.com> trailing", 21) == ann);
+    assert(author_table_intern(&table, "Ann", 3) == 3);
+
+    const author_t *author = author_table_get(&table, bob);
+    assert(author != NULL);
+    assert(strcmp(author->signature, "Bob <bob@example.com>") == 0);
+    assert(author->length == 21);
+    assert(author_table_get(&table, 4) == NULL);
+
+    // Past several grows every id still resolves to its own signature
+    char signature[64];
+    for (int i = 0; i < 5000; i++) {
+        snprintf(signature, sizeof(signature), "Dev %d <dev%d@example.com>", i, i);
+        assert(author_table_intern(&table, signature, strlen(signature)) == (uint32_t)i + 4);
+    }
+    assert(table.count == 5003);
+    assert(table.capacity >= table.count * 2);
+    for (int i = 0; i < 5000; i++) {
+        snprintf(signature, sizeof(signature), "Dev %d <dev%d@example.com>", i, i);
+        assert(author_table_intern(&table, signature, strlen(signature)) == (uint32_t)i + 4);
+        assert(strcmp(author_table_get(&table, (uint32_t)i + 4)->signature, signature) == 0);
+    }
+    assert(author_table_get(&table, ann)->signature[0] == 'A');
+    assert(author_table_memory(&table) > table.string_bytes);
+
+    author_table_cleanup(&table);
+    assert(table.count == 0 && table.slots == NULL);
+    author_table_cleanup(&table);
+
+    printf("Author interning tests passed!\n");
+}
+
+static void test_author_intern_parts(void) {
+    printf("Testing author interning from name and email...\n");
+
+    author_table_t table;
+    author_table_init(&table);
+
+    // The parts and the whole signature are the same author
+    uint32_t ann = author_table_intern_parts(&table, "Ann", "ann@example.com");
+    assert(ann == 1);
+    assert(strcmp(author_table_get(&table, ann)->signature, "Ann <ann@example.com>") == 0);
+    assert(author_table_get(&table, ann)->length == 21);
+    assert(author_table_intern(&table, "Ann <ann@example.com>", 21) == ann);
+    assert(author_table_intern_parts(&table, "Ann", "ann@example.com") == ann);
+    size_t bytes = table.string_bytes;
+
+    uint32_t bob = author_table_intern(&table, "Bob <bob@example.com>", 21);
+    assert(author_table_intern_parts(&table, "Bob", "bob@example.com") == bob);
+    assert(table.string_bytes == bytes + 22);
+
+    // Either part differing is another author
+    assert(author_table_intern_parts(&table, "Ann", "ann@example.org") == 3);
+    assert(author_table_intern_parts(&table, "Anne", "ann@example.com") == 4);
+    assert(author_table_intern_parts(&table, "", "") == 5);
+    assert(strcmp(author_table_get(&table, 5)->signature, " <>") == 0);
+    assert(author_table_intern_parts(&table, "Ann", NULL) == AUTHOR_NONE);
+    assert(table.count == 5);
+
+    author_table_cleanup(&table);
+
+    printf("Author interning from name and email tests passed!\n");
+}
+
+int main(void) {
+    printf("Running author table tests...\n\n");
+
+    test_author_intern();
+    test_author_intern_parts();
+
+    printf("\nAll author table tests passed!\n");
+    return 0;
+}
@@ -41,6 +41,17 @@ static void test_commit_parsing(void) {
     assert(commit.type == COMMIT_TYPE_FEAT);
     assert(strcmp(commit.scope, "core") == 0);
     assert(strcmp(commit.description, "add new feature") == 0);
+    assert(strcmp(commit.body, "This is the body") == 0);
+    assert(strcmp(commit.footer, "BREAKING CHANGE: API changed") == 0);
+    assert(commit.is_breaking == 1);
+    changelog_free_commit(&commit);
+    
+    // A '!' in the description is not a breaking change marker
+    msg = "fix(parser): handle a trailing '!'";
+    assert(changelog_parse_commit(msg, &commit) == RELEASY_SUCCESS);
+    assert(commit.type == COMMIT_TYPE_FIX);
+    assert(commit.is_breaking == 0);
+    assert(commit.body == NULL && commit.footer == NULL);
     changelog_free_commit(&commit);
     
     // Test breaking change marker
@@ -58,6 +69,65 @@ static void test_commit_parsing(void) {
     printf("Commit parsing tests passed!\n");
 }
 
+static int span_equals(changelog_span_t span, const char *expected) {
+    return span.ptr && span.len == strlen(expected) && memcmp(span.ptr, expected, span.len) == 0;
+}
+
+static void test_message_spans(void) {
+    printf("Testing zero-copy message parsing...\n");
+    
+    conventional_commit_t parsed;
+    
+    // Every type resolves, in any case
+    for (int type = 0; type < COMMIT_TYPE_UNKNOWN; type++) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "%s: x", changelog_commit_type_string(type));
+        assert(changelog_parse_message(msg, strlen(msg), &parsed) == RELEASY_SUCCESS);
+        assert(parsed.type == (commit_type_t)type);
+    }
+    const char *msg = "Fix: x";
+    assert(changelog_parse_message(msg, strlen(msg), &parsed) == RELEASY_SUCCESS);
+    assert(parsed.type == COMMIT_TYPE_FIX);
+    msg = "wip: x";
+    assert(changelog_parse_message(msg, strlen(msg), &parsed) == RELEASY_SUCCESS);
+    assert(parsed.type == COMMIT_TYPE_UNKNOWN);
+    assert(span_equals(parsed.type_name, "wip"));
+    
+    // Spans point into the message
+    msg = "refactor(api)!: rename handles\r\n\nFirst line\nsecond line\n\n\n"
+          "Refs: #12\nBREAKING-CHANGE: handles are opaque\n\n";
+    assert(changelog_parse_message(msg, strlen(msg), &parsed) == RELEASY_SUCCESS);
+    assert(parsed.type == COMMIT_TYPE_REFACTOR);
+    assert(parsed.scope.ptr == msg + 9);
+    assert(span_equals(parsed.scope, "api"));
+    assert(span_equals(parsed.description, "rename handles"));
+    assert(span_equals(parsed.body, "First line\nsecond line"));
+    assert(span_equals(parsed.footer, "Refs: #12\nBREAKING-CHANGE: handles are opaque"));
+    assert(parsed.is_breaking);
+    
+    // A footer right after the header, and a last paragraph that is not one
+    msg = "fix: z\n\nRefs #34";
+    assert(changelog_parse_message(msg, strlen(msg), &parsed) == RELEASY_SUCCESS);
+    assert(parsed.body.ptr == NULL);
+    assert(span_equals(parsed.footer, "Refs #34"));
+    assert(!parsed.is_breaking);
+    msg = "docs: d\n\nfirst\n\nnot a footer: really";
+    assert(changelog_parse_message(msg, strlen(msg), &parsed) == RELEASY_SUCCESS);
+    assert(span_equals(parsed.body, "first\n\nnot a footer: really"));
+    assert(parsed.footer.ptr == NULL);
+    
+    // Only the given length is read
+    msg = "feat: bounded\n\nBREAKING CHANGE: past the end";
+    assert(changelog_parse_message(msg, strlen("feat: bounded"), &parsed) == RELEASY_SUCCESS);
+    assert(!parsed.is_breaking && parsed.footer.ptr == NULL);
+    
+    assert(changelog_parse_message("feat(core: x", 12, &parsed) == CHANGELOG_ERR_INVALID_FORMAT);
+    assert(changelog_parse_message("Merge branch 'main'", 19, &parsed) == CHANGELOG_ERR_INVALID_FORMAT);
+    assert(changelog_parse_message("", 0, &parsed) == CHANGELOG_ERR_INVALID_FORMAT);
+    
+    printf("Zero-copy message parsing tests passed!\n");
+}
+
 static void test_version_validation(void) {
     printf("Testing version validation...\n");
     
@@ -90,9 +160,19 @@ static void test_backup_functionality(void) {
     fprintf(f, "# Test Changelog\n");
     fclose(f);
     
-    // Enable backup and write
+    // Nothing is written, or backed up, without entries
     log.backup = 1;
-    assert(changelog_write(&log) == CHANGELOG_ERR_NO_COMMITS); // Fails due to no commits
+    assert(changelog_write(&log) == CHANGELOG_ERR_NO_COMMITS);
+    assert(!file_exists_with_pattern("test_changelog.md.*.bak"));
+
+    // Writing a release backs up the file it replaces
+    changelog_entry_t release = { .version = "1.0.0", .date = "2024-03-20" };
+    changelog_entry_t *entries[] = { &release };
+    log.entries = entries;
+    log.count = 1;
+    assert(changelog_write(&log) == RELEASY_SUCCESS);
+    log.entries = NULL;
+    log.count = 0;
     
     // Check if backup was created
     char backup_pattern[256];
@@ -152,7 +232,7 @@ static void test_git_integration(void) {
     int found_feat = 0, found_fix = 0, found_breaking = 0;
     for (size_t i = 0; i < entry->count; i++) {
         commit_info_t *commit = entry->commits[i];
-        if (commit->type == COMMIT_TYPE_FEAT && strcmp(commit->scope, "core") == 0) {
+        if (commit->type == COMMIT_TYPE_FEAT && commit->scope && strcmp(commit->scope, "core") == 0) {
             found_feat = 1;
         } else if (commit->type == COMMIT_TYPE_FIX) {
             found_fix = 1;
@@ -252,6 +332,7 @@ int main(void) {
     
     test_changelog_init();
     test_commit_parsing();
+    test_message_spans();
     test_version_validation();
     test_backup_functionality();
     test_error_handling();
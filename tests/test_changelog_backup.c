@@ -0,0 +1,194 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "changelog.h"
+#include "changelog_backup.h"
+
+#define TEST_DIR "backup_test_dir"
+#define TEST_FILE TEST_DIR "/CHANGELOG.md"
+
+static void write_file(const char *path, const char *content) {
+    FILE *f = fopen(path, "w");
+    assert(f != NULL);
+    fputs(content, f);
+    fclose(f);
+}
+
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    assert(f != NULL);
+    static char buf[4096];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    buf[n] = '\0';
+    fclose(f);
+    return buf;
+}
+
+static size_t count_backups(void) {
+    DIR *d = opendir(TEST_DIR);
+    assert(d != NULL);
+    size_t count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(d)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len > 4 && strcmp(entry->d_name + len - 4, ".bak") == 0) count++;
+    }
+    closedir(d);
+    return count;
+}
+
+static void clear_dir(void) {
+    DIR *d = opendir(TEST_DIR);
+    if (!d) return;
+    struct dirent *entry;
+    char path[512];
+    while ((entry = readdir(d)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        snprintf(path, sizeof(path), "%s/%s", TEST_DIR, entry->d_name);
+        unlink(path);
+    }
+    closedir(d);
+    rmdir(TEST_DIR);
+}
+
+static void test_backup_dedup(void) {
+    printf("Testing changelog backups...\n");
+
+    clear_dir();
+    assert(mkdir(TEST_DIR, 0755) == 0);
+    write_file(TEST_FILE, "# Changelog\n\n## [1.0.0]\n");
+
+    changelog_backup_policy_t policy = CHANGELOG_BACKUP_POLICY_INIT;
+    changelog_backup_result_t first, again;
+    assert(changelog_backup(TEST_FILE, &policy, &first) == RELEASY_SUCCESS);
+    assert(first.method >= CHANGELOG_BACKUP_CLONED);
+    assert(strncmp(first.path, TEST_FILE ".", strlen(TEST_FILE) + 1) == 0);
+    assert(strcmp(read_file(first.path), "# Changelog\n\n## [1.0.0]\n") == 0);
+
+    // Unchanged content is never copied twice
+    assert(changelog_backup(TEST_FILE, &policy, &again) == RELEASY_SUCCESS);
+    assert(again.method == CHANGELOG_BACKUP_EXISTING || again.method == CHANGELOG_BACKUP_LINKED);
+    struct stat a, b;
+    assert(stat(first.path, &a) == 0 && stat(again.path, &b) == 0);
+    assert(a.st_ino == b.st_ino);
+    changelog_backup_result_free(&again);
+
+    // An old backup with the same content is linked under the new name
+    char old_path[512];
+    const char *hash = first.path + strlen(TEST_FILE) + 1 + CHANGELOG_BACKUP_STAMP_LENGTH;
+    snprintf(old_path, sizeof(old_path), TEST_FILE ".20200101_000000%s", hash);
+    assert(rename(first.path, old_path) == 0);
+    assert(changelog_backup(TEST_FILE, &policy, &again) == RELEASY_SUCCESS);
+    assert(again.method == CHANGELOG_BACKUP_LINKED);
+    assert(stat(old_path, &a) == 0 && stat(again.path, &b) == 0);
+    assert(a.st_ino == b.st_ino);
+    changelog_backup_result_free(&again);
+    changelog_backup_result_free(&first);
+
+    // New content gets a backup of its own
+    write_file(TEST_FILE, "# Changelog\n\n## [1.1.0]\n\n## [1.0.0]\n");
+    assert(changelog_backup(TEST_FILE, &policy, &again) == RELEASY_SUCCESS);
+    assert(again.method >= CHANGELOG_BACKUP_CLONED);
+    assert(strcmp(read_file(again.path), "# Changelog\n\n## [1.1.0]\n\n## [1.0.0]\n") == 0);
+    assert(count_backups() == 3);
+    changelog_backup_result_free(&again);
+
+    clear_dir();
+    printf("Changelog backup tests passed!\n");
+}
+
+static void test_backup_retention(void) {
+    printf("Testing backup retention...\n");
+
+    clear_dir();
+    assert(mkdir(TEST_DIR, 0755) == 0);
+    write_file(TEST_FILE, "# Changelog\n");
+
+    // Backups from before content hashes are counted as well
+    write_file(TEST_FILE ".20200101_000000.bak", "old\n");
+    write_file(TEST_FILE ".20210101_000000.0123456789abcdef.bak", "old\n");
+    write_file(TEST_FILE ".20220101_000000.0123456789abcdef.bak", "old\n");
+    write_file(TEST_FILE ".20230101_000000.bak", "old\n");
+    write_file(TEST_FILE ".not_a_stamp.bak", "other\n");
+    write_file(TEST_DIR "/OTHER.md.20200101_000000.bak", "other\n");
+
+    // The default policy never removes a backup the user made
+    char name[128];
+    for (int year = 2000; year < 2015; year++) {
+        snprintf(name, sizeof(name), TEST_FILE ".%d0101_000000.bak", year);
+        write_file(name, "older\n");
+    }
+    changelog_backup_policy_t policy = CHANGELOG_BACKUP_POLICY_INIT;
+    changelog_backup_result_t kept;
+    assert(changelog_backup(TEST_FILE, &policy, &kept) == RELEASY_SUCCESS);
+    assert(kept.removed == 0);
+    assert(access(TEST_FILE ".20000101_000000.bak", F_OK) == 0);
+    assert(unlink(kept.path) == 0);
+    changelog_backup_result_free(&kept);
+    for (int year = 2000; year < 2015; year++) {
+        snprintf(name, sizeof(name), TEST_FILE ".%d0101_000000.bak", year);
+        assert(unlink(name) == 0);
+    }
+
+    size_t removed = 0;
+    assert(changelog_backup_prune(TEST_FILE, &policy, time(NULL), &removed) == RELEASY_SUCCESS);
+    assert(removed == 0);
+
+    policy.keep = 3;
+    assert(changelog_backup_prune(TEST_FILE, &policy, time(NULL), &removed) == RELEASY_SUCCESS);
+    assert(removed == 1);
+    assert(access(TEST_FILE ".20200101_000000.bak", F_OK) != 0);
+    assert(access(TEST_FILE ".20210101_000000.0123456789abcdef.bak", F_OK) == 0);
+
+    // By age: nothing more than 400 days before 2023-01-02
+    struct tm tm = {0};
+    tm.tm_year = 123;
+    tm.tm_mon = 0;
+    tm.tm_mday = 2;
+    tm.tm_isdst = -1;
+    policy.keep = 0;
+    policy.max_age = 400 * 86400;
+    assert(changelog_backup_prune(TEST_FILE, &policy, mktime(&tm), &removed) == RELEASY_SUCCESS);
+    assert(removed == 1);
+    assert(access(TEST_FILE ".20210101_000000.0123456789abcdef.bak", F_OK) != 0);
+    assert(access(TEST_FILE ".20220101_000000.0123456789abcdef.bak", F_OK) == 0);
+
+    // The newest stays however old it is
+    policy.max_age = 1;
+    assert(changelog_backup_prune(TEST_FILE, &policy, time(NULL), &removed) == RELEASY_SUCCESS);
+    assert(removed == 1);
+    assert(access(TEST_FILE ".20230101_000000.bak", F_OK) == 0);
+    assert(access(TEST_FILE ".not_a_stamp.bak", F_OK) == 0);
+    assert(access(TEST_DIR "/OTHER.md.20200101_000000.bak", F_OK) == 0);
+
+    // A new backup applies the policy itself
+    policy.keep = 1;
+    policy.max_age = 0;
+    changelog_backup_result_t result;
+    assert(changelog_backup(TEST_FILE, &policy, &result) == RELEASY_SUCCESS);
+    assert(result.removed == 1);
+    assert(access(result.path, F_OK) == 0);
+    changelog_backup_result_free(&result);
+
+    policy.max_age = -1;
+    assert(changelog_backup(TEST_FILE, &policy, NULL) == CHANGELOG_ERR_INVALID_CONFIG);
+
+    clear_dir();
+    printf("Backup retention tests passed!\n");
+}
+
+int main(void) {
+    printf("Running changelog backup tests...\n\n");
+
+    test_backup_dedup();
+    test_backup_retention();
+
+    printf("\nAll changelog backup tests passed!\n");
+    return 0;
+}
@@ -2,8 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <sys/stat.h>
 #include <git2.h>
 #include "changelog.h"
+#include "date_cache.h"
 #include "test_helpers.h"
 
 static void test_git_integration(void) {
@@ -34,11 +36,13 @@ static void test_git_integration(void) {
     assert(strcmp(entry->version, "1.0.0") == 0);
     assert(entry->count == 3);
     
-    // Verify commits
+    // Verify commits, each dated by its author signature
     int found_feat = 0, found_fix = 0, found_breaking = 0;
     for (size_t i = 0; i < entry->count; i++) {
         commit_info_t *commit = entry->commits[i];
-        if (commit->type == COMMIT_TYPE_FEAT && strcmp(commit->scope, "core") == 0) {
+        assert(commit->timestamp == test_repo.author->when.time);
+        assert(strcmp(commit->author, "Test User <test@example.com>") == 0);
+        if (commit->type == COMMIT_TYPE_FEAT && commit->scope && strcmp(commit->scope, "core") == 0) {
             found_feat = 1;
         } else if (commit->type == COMMIT_TYPE_FIX) {
             found_fix = 1;
@@ -49,11 +53,25 @@ static void test_git_integration(void) {
     assert(found_feat && found_fix && found_breaking);
     
     // Test changelog writing
+    log.formats = CHANGELOG_FORMAT_MARKDOWN | CHANGELOG_FORMAT_JSON;
     assert(changelog_write(&log) == RELEASY_SUCCESS);
     assert(file_exists_with_pattern("CHANGELOG.md"));
+
+    // The day is only formatted when the JSON is rendered
+    char day[DATE_DAY_LENGTH + 1], expected[64];
+    assert(date_format_day(test_repo.author->when.time, day) == RELEASY_SUCCESS);
+    snprintf(expected, sizeof(expected), "\"date\":\"%s\",", day);
+    FILE *f = fopen("CHANGELOG.json", "r");
+    assert(f != NULL);
+    char json[8192];
+    size_t len = fread(json, 1, sizeof(json) - 1, f);
+    json[len] = '\0';
+    fclose(f);
+    assert(strstr(json, expected) != NULL);
     
     // Cleanup
     remove("CHANGELOG.md");
+    remove("CHANGELOG.json");
     changelog_cleanup(&log);
     cleanup_test_repo(&test_repo);
     
@@ -131,6 +149,522 @@ static void test_changelog_formatting(void) {
     printf("Changelog formatting tests passed!\n");
 }
 
+static char *read_file(const char *path) {
+    FILE *f = fopen(path, "r");
+    assert(f != NULL);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    rewind(f);
+    char *data = malloc(size + 1);
+    assert(data != NULL);
+    assert(fread(data, 1, size, f) == (size_t)size);
+    data[size] = '\0';
+    fclose(f);
+    return data;
+}
+
+static int starts_with(const char *data, const char *prefix) {
+    return strncmp(data, prefix, strlen(prefix)) == 0;
+}
+
+static size_t count_matches(const char *data, const char *needle) {
+    size_t count = 0;
+    for (const char *p = strstr(data, needle); p; p = strstr(p + 1, needle)) count++;
+    return count;
+}
+
+static changelog_entry_t *make_entry(const char *version, const char *description) {
+    changelog_entry_t *entry = calloc(1, sizeof(changelog_entry_t));
+    assert(entry != NULL);
+    entry->version = strdup(version);
+    entry->date = strdup("2024-03-20");
+    entry->commits = calloc(1, sizeof(commit_info_t *));
+    entry->commits[0] = calloc(1, sizeof(commit_info_t));
+    entry->commits[0]->type = COMMIT_TYPE_FEAT;
+    entry->commits[0]->description = strdup(description);
+    entry->count = 1;
+    return entry;
+}
+
+static void write_release(const char *path, const char *version, const char *description) {
+    changelog_t log;
+    assert(changelog_init(&log, path) == RELEASY_SUCCESS);
+    log.entries = calloc(1, sizeof(changelog_entry_t *));
+    log.entries[0] = make_entry(version, description);
+    log.count = 1;
+    assert(changelog_write(&log) == RELEASY_SUCCESS);
+    changelog_cleanup(&log);
+}
+
+static void test_incremental_write(void) {
+    printf("Testing incremental changelog update...\n");
+
+    FILE *f = fopen("splice_test.md", "w");
+    assert(f != NULL);
+    fprintf(f, "# Changelog\n\nAll notable changes are listed here.\n\n"
+               "## [1.0.0] - 2024-01-01\n\n### feat\n\n* first release\n\n");
+    fclose(f);
+    chmod("splice_test.md", 0640);
+
+    // New sections go after the preamble and above older history
+    write_release("splice_test.md", "1.1.0", "second release");
+    write_release("splice_test.md", "1.2.0", "third release");
+
+    char *data = read_file("splice_test.md");
+    assert(starts_with(data, "# Changelog\n\nAll notable changes are listed here.\n\n## [1.2.0]"));
+    char *v12 = strstr(data, "third release");
+    char *v11 = strstr(data, "second release");
+    char *v10 = strstr(data, "first release");
+    assert(v12 && v11 && v10 && v12 < v11 && v11 < v10);
+    free(data);
+
+    // Writing a version again replaces its section instead of adding one
+    write_release("splice_test.md", "1.1.0", "second release, amended");
+    data = read_file("splice_test.md");
+    assert(strstr(data, "second release\n") == NULL);
+    assert(strstr(data, "second release, amended") != NULL);
+    assert(count_matches(data, "## [1.1.0]") == 1);
+    assert(strstr(data, "third release") && strstr(data, "first release"));
+    free(data);
+
+    struct stat st;
+    assert(stat("splice_test.md", &st) == 0);
+    assert((st.st_mode & 0777) == 0640);
+
+    // The temp file never outlives the write
+    assert(!file_exists_with_pattern("splice_test.md.*"));
+
+    // A file without a title gets one
+    remove("splice_test.md");
+    write_release("splice_test.md", "0.1.0", "initial");
+    data = read_file("splice_test.md");
+    assert(starts_with(data, "# Changelog\n\n## [0.1.0]"));
+    free(data);
+
+    remove("splice_test.md");
+
+    printf("Incremental changelog update tests passed!\n");
+}
+
+static int stop_after_ten(const commit_info_t *commit, void *payload) {
+    (void)commit;
+    size_t *seen = payload;
+    return ++*seen == 10 ? CHANGELOG_ERR_NO_COMMITS : RELEASY_SUCCESS;
+}
+
+// Small batches so the range spans many of them. Both parse every commit
+// themselves rather than reading it from the commit cache.
+static const changelog_walk_options_t serial_walk = {
+    .workers = 1, .batch_size = CHANGELOG_WALK_BATCH, .use_cache = 0
+};
+static const changelog_walk_options_t parallel_walk = {
+    .workers = 4, .batch_size = 64, .use_cache = 0
+};
+
+static void test_changelog_stream(void) {
+    printf("Testing streamed changelog...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    assert(create_test_commit(&test_repo, "feat: before the release") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+
+    // More commits than the old batch limit of 1000
+    const size_t total = 1100;
+    char message[64];
+    for (size_t i = 0; i < total; i++) {
+        snprintf(message, sizeof(message), "%s(core): change %zu",
+                 i % 3 == 0 ? "fix" : i % 3 == 1 ? "feat" : "docs", i);
+        assert(create_test_commit(&test_repo, message) == 0);
+    }
+
+    // Each layout, with and without the contributors section
+    for (int mode = 0; mode < 4; mode++) {
+        int grouped = mode & 1, contributors = mode >> 1;
+        changelog_t batch;
+        assert(changelog_init(&batch, "batch_test.md") == RELEASY_SUCCESS);
+        batch.group_by_type = grouped;
+        batch.include_contributors = contributors;
+        batch.walk = serial_walk;
+        assert(changelog_generate(&batch, test_repo.repo, "1.1.0") == RELEASY_SUCCESS);
+        assert(batch.entries[0]->count == total);
+        assert(strcmp(batch.entries[0]->previous_version, "v1.0.0") == 0);
+        assert(changelog_write(&batch) == RELEASY_SUCCESS);
+
+        changelog_t stream;
+        assert(changelog_init(&stream, "stream_test.md") == RELEASY_SUCCESS);
+        stream.group_by_type = grouped;
+        stream.include_contributors = contributors;
+        stream.walk = parallel_walk;
+        assert(changelog_generate_stream(&stream, test_repo.repo, "1.1.0") == RELEASY_SUCCESS);
+
+        // Both stages render the same bytes, and the pool keeps walk order
+        char *expected = read_file("batch_test.md");
+        char *actual = read_file("stream_test.md");
+        assert(strcmp(expected, actual) == 0);
+        assert(strstr(actual, "change 1099") != NULL);
+        assert(strstr(actual, "before the release") == NULL);
+        assert((strstr(actual, "\n### Contributors\n\n") != NULL) == contributors);
+        free(expected);
+        free(actual);
+
+        remove("batch_test.md");
+        remove("stream_test.md");
+        changelog_cleanup(&batch);
+        changelog_cleanup(&stream);
+    }
+
+    // A callback can stop the walk early
+    size_t seen = 0;
+    assert(changelog_walk(test_repo.repo, "v1.0.0", NULL, &serial_walk, stop_after_ten, &seen) == CHANGELOG_ERR_NO_COMMITS);
+    assert(seen == 10);
+    seen = 0;
+    assert(changelog_walk(test_repo.repo, "v1.0.0", NULL, &parallel_walk, stop_after_ten, &seen) == CHANGELOG_ERR_NO_COMMITS);
+    assert(seen == 10);
+    assert(changelog_walk(test_repo.repo, "v9.9.9", NULL, NULL, stop_after_ten, &seen) == CHANGELOG_ERR_TAG_NOT_FOUND);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Streamed changelog tests passed!\n");
+}
+
+static void test_tag_spelling(void) {
+    printf("Testing tag-spelled versions...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    assert(create_test_commit(&test_repo, "fix: second") == 0);
+
+    // "v1.1.0" is release 1.1.0: named without the 'v', and it starts
+    // after v1.0.0 rather than at the root
+    changelog_t log;
+    assert(changelog_init(&log, "tag_test.md") == RELEASY_SUCCESS);
+    assert(changelog_generate(&log, test_repo.repo, "v1.1.0") == RELEASY_SUCCESS);
+    assert(strcmp(log.entries[0]->version, "1.1.0") == 0);
+    assert(strcmp(log.entries[0]->previous_version, "v1.0.0") == 0);
+    assert(log.entries[0]->count == 1);
+    changelog_cleanup(&log);
+
+    assert(changelog_init(&log, "tag_test.md") == RELEASY_SUCCESS);
+    assert(changelog_generate_stream(&log, test_repo.repo, "v1.1.0") == RELEASY_SUCCESS);
+    char *written = read_file("tag_test.md");
+    assert(strstr(written, "## [1.1.0]") != NULL);
+    assert(strstr(written, "[v1.1.0]") == NULL);
+    assert(strstr(written, "second") != NULL);
+    assert(strstr(written, "first") == NULL);
+    free(written);
+    changelog_cleanup(&log);
+
+    remove("tag_test.md");
+    cleanup_test_repo(&test_repo);
+
+    printf("Tag-spelled version tests passed!\n");
+}
+
+static void test_generate_all(void) {
+    printf("Testing single-walk changelog for every release...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    assert(create_test_commit(&test_repo, "fix: second") == 0);
+    assert(create_test_commit(&test_repo, "chore update deps") == 0);
+    assert(create_test_commit(&test_repo, "feat(api): third") == 0);
+    assert(create_test_tag(&test_repo, "v1.1.0") == 0);
+    assert(create_test_commit(&test_repo, "docs: not released yet") == 0);
+
+    changelog_t log;
+    assert(changelog_init(&log, "CHANGELOG.md") == RELEASY_SUCCESS);
+    assert(changelog_generate_all(&log, test_repo.repo) == RELEASY_SUCCESS);
+
+    // Newest first, each commit in the oldest release containing it
+    assert(log.count == 2);
+    changelog_entry_t *newest = log.entries[0], *oldest = log.entries[1];
+    assert(strcmp(newest->version, "1.1.0") == 0);
+    assert(strcmp(newest->previous_version, "v1.0.0") == 0);
+    assert(newest->count == 2);
+    assert(strcmp(newest->commits[0]->description, "third") == 0);
+    assert(strcmp(newest->commits[1]->description, "second") == 0);
+
+    assert(strcmp(oldest->version, "1.0.0") == 0);
+    assert(oldest->previous_version == NULL);
+    assert(oldest->count == 1);
+    assert(strcmp(oldest->commits[0]->description, "first") == 0);
+
+    // The same commits as generating each release on its own
+    changelog_t single;
+    assert(changelog_init(&single, "CHANGELOG.md") == RELEASY_SUCCESS);
+    assert(changelog_generate(&single, test_repo.repo, "1.1.0") == RELEASY_SUCCESS);
+    assert(single.entries[0]->count == 3);  // Walks to HEAD, so the docs commit too
+    changelog_cleanup(&single);
+    changelog_cleanup(&log);
+
+    // Without a version tag there is nothing to rebuild
+    test_repo_t untagged = {0};
+    assert(init_test_repo(&untagged) == 0);
+    assert(create_test_commit(&untagged, "feat: first") == 0);
+    assert(changelog_init(&log, "CHANGELOG.md") == RELEASY_SUCCESS);
+    assert(changelog_generate_all(&log, untagged.repo) == CHANGELOG_ERR_TAG_NOT_FOUND);
+    assert(changelog_generate_all(NULL, untagged.repo) == RELEASY_ERROR);
+    changelog_cleanup(&log);
+    cleanup_test_repo(&untagged);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Single-walk changelog tests passed!\n");
+}
+
+static void test_previous_version(void) {
+    printf("Testing previous version lookup...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    git_oid fork;
+    assert(git_reference_name_to_id(&fork, test_repo.repo, "HEAD") == 0);
+
+    // v1.5.0 lives on a branch HEAD never merged
+    assert(create_test_commit(&test_repo, "feat: abandoned") == 0);
+    assert(create_test_tag(&test_repo, "v1.5.0") == 0);
+    assert(reset_test_branch(&test_repo, &fork) == 0);
+    assert(create_test_commit(&test_repo, "fix: second") == 0);
+    assert(create_test_commit(&test_repo, "feat: third") == 0);
+
+    // Searched by walking, then through a commit-graph that is missing
+    // the newest commit
+    for (int pass = 0; pass < 2; pass++) {
+        changelog_t log;
+        assert(changelog_init(&log, "CHANGELOG.md") == RELEASY_SUCCESS);
+        assert(changelog_generate(&log, test_repo.repo, "2.0.0") == RELEASY_SUCCESS);
+        assert(strcmp(log.entries[0]->previous_version, "v1.0.0") == 0);
+        assert(log.entries[0]->count == 2);
+
+        // Regenerating a tagged release skips its own tag
+        assert(changelog_generate(&log, test_repo.repo, "1.0.0") == RELEASY_SUCCESS);
+        assert(log.entries[1]->previous_version == NULL);
+        changelog_cleanup(&log);
+
+        if (pass == 0) {
+            if (write_commit_graph(&test_repo) != 0) break;
+            assert(create_test_commit(&test_repo, "chore tidy") == 0);
+        }
+    }
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Previous version lookup tests passed!\n");
+}
+
+typedef struct {
+    char text[256];
+} scope_log_t;
+
+static int log_description(const commit_info_t *commit, void *payload) {
+    scope_log_t *log = payload;
+    strncat(log->text, commit->description, sizeof(log->text) - strlen(log->text) - 2);
+    strcat(log->text, " ");
+    return RELEASY_SUCCESS;
+}
+
+static const char *walk_path(test_repo_t *test_repo, const char *path, int workers, scope_log_t *log) {
+    changelog_walk_options_t opts = CHANGELOG_WALK_OPTIONS_INIT;
+    opts.workers = workers;
+    opts.batch_size = 1;
+    opts.path = path;
+    memset(log, 0, sizeof(scope_log_t));
+    assert(changelog_walk(test_repo->repo, NULL, NULL, &opts, log_description, log) == RELEASY_SUCCESS);
+    return log->text;
+}
+
+static void test_path_scope(void) {
+    printf("Testing path-scoped changelogs...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(add_test_file(&test_repo, "packages/a/main.c", "a\n") == 0);
+    assert(create_test_commit(&test_repo, "feat(a): one") == 0);
+    assert(add_test_file(&test_repo, "packages/b/main.c", "b\n") == 0);
+    assert(create_test_commit(&test_repo, "feat(b): two") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    assert(add_test_file(&test_repo, "packages/a/main.c", "a2\n") == 0);
+    assert(create_test_commit(&test_repo, "fix(a): three") == 0);
+    assert(add_test_file(&test_repo, "README.md", "readme\n") == 0);
+    assert(create_test_commit(&test_repo, "docs: four") == 0);
+    assert(create_test_tag(&test_repo, "v1.1.0") == 0);
+
+    // Tree diffs only, then with the changed-path filters answering first
+    for (int pass = 0; pass < 2; pass++) {
+        scope_log_t log;
+        for (int workers = 1; workers <= 4; workers += 3) {
+            assert(strcmp(walk_path(&test_repo, "packages/a", workers, &log), "three one ") == 0);
+            assert(strcmp(walk_path(&test_repo, "./packages/b/", workers, &log), "two ") == 0);
+            assert(strcmp(walk_path(&test_repo, "packages", workers, &log), "three two one ") == 0);
+            assert(strcmp(walk_path(&test_repo, "packages/a/main.c", workers, &log), "three one ") == 0);
+            assert(strcmp(walk_path(&test_repo, "packages/c", workers, &log), "") == 0);
+            assert(strcmp(walk_path(&test_repo, ".", workers, &log), "four three two one ") == 0);
+        }
+
+        // Every release of one package from the one walk
+        changelog_t all;
+        assert(changelog_init(&all, "CHANGELOG.md") == RELEASY_SUCCESS);
+        all.walk.path = "packages/a";
+        assert(changelog_generate_all(&all, test_repo.repo) == RELEASY_SUCCESS);
+        assert(all.count == 2);
+        assert(all.entries[0]->count == 1);
+        assert(strcmp(all.entries[0]->commits[0]->description, "three") == 0);
+        assert(all.entries[1]->count == 1);
+        assert(strcmp(all.entries[1]->commits[0]->description, "one") == 0);
+        changelog_cleanup(&all);
+
+        if (write_commit_graph(&test_repo) != 0) break;
+    }
+
+    changelog_walk_options_t opts = CHANGELOG_WALK_OPTIONS_INIT;
+    opts.path = "../elsewhere";
+    assert(changelog_walk(test_repo.repo, NULL, NULL, &opts, log_description, NULL) ==
+           CHANGELOG_ERR_INVALID_PATH);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Path-scoped changelog tests passed!\n");
+}
+
+static const char *walk_mainline(test_repo_t *test_repo, int expand_merges, int workers,
+                                 scope_log_t *log) {
+    changelog_walk_options_t opts = CHANGELOG_WALK_OPTIONS_INIT;
+    opts.workers = workers;
+    opts.batch_size = 1;
+    opts.first_parent = 1;
+    opts.expand_merges = expand_merges;
+    memset(log, 0, sizeof(scope_log_t));
+    assert(changelog_walk(test_repo->repo, "v1.0.0", NULL, &opts, log_description, log) == RELEASY_SUCCESS);
+    return log->text;
+}
+
+static void test_first_parent(void) {
+    printf("Testing first-parent changelogs...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: base") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    git_oid fork, side;
+    assert(git_reference_name_to_id(&fork, test_repo.repo, "HEAD") == 0);
+
+    assert(create_test_commit(&test_repo, "fix: inner") == 0);
+    assert(create_test_commit(&test_repo, "wip") == 0);
+    assert(git_reference_name_to_id(&side, test_repo.repo, "HEAD") == 0);
+    assert(reset_test_branch(&test_repo, &fork) == 0);
+    assert(create_test_commit(&test_repo, "docs: mainline") == 0);
+    assert(create_test_merge(&test_repo, &side,
+                             "Merge pull request #7 from dev/widget\n\nfeat(ui): add widget\n") == 0);
+    assert(create_test_commit(&test_repo, "Merge branch 'hotfix'") == 0);
+
+    // Merges stand for their branches, under the pull request title; then
+    // expanded, with the branch right after its merge
+    for (int pass = 0; pass < 2; pass++) {
+        scope_log_t log;
+        for (int workers = 1; workers <= 4; workers += 3) {
+            assert(strcmp(walk_mainline(&test_repo, 0, workers, &log), "add widget mainline ") == 0);
+            assert(strcmp(walk_mainline(&test_repo, 1, workers, &log), "add widget inner mainline ") == 0);
+        }
+        if (write_commit_graph(&test_repo) != 0) break;
+    }
+
+    // Every commit once, and a merge header that is not conventional stays out
+    changelog_t log;
+    assert(changelog_init(&log, "CHANGELOG.md") == RELEASY_SUCCESS);
+    assert(changelog_generate(&log, test_repo.repo, "1.1.0") == RELEASY_SUCCESS);
+    assert(log.entries[0]->count == 2);
+    changelog_cleanup(&log);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("First-parent changelog tests passed!\n");
+}
+
+static const char *walk_deduplicated(test_repo_t *test_repo, int cherry_pick, const char *compare,
+                                     int workers, scope_log_t *log) {
+    changelog_walk_options_t opts = CHANGELOG_WALK_OPTIONS_INIT;
+    opts.workers = workers;
+    opts.batch_size = 1;
+    opts.cherry_pick = cherry_pick;
+    opts.compare = compare;
+    memset(log, 0, sizeof(scope_log_t));
+    assert(changelog_walk(test_repo->repo, "v1.0.0", NULL, &opts, log_description, log) == RELEASY_SUCCESS);
+    return log->text;
+}
+
+static void test_cherry_pick(void) {
+    printf("Testing cherry-pick deduplication...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(add_test_file(&test_repo, "a.txt", "1\n") == 0);
+    assert(add_test_file(&test_repo, "b.txt", "1\n") == 0);
+    assert(create_test_commit(&test_repo, "feat: base") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    git_oid fork, side, release;
+    assert(git_reference_name_to_id(&fork, test_repo.repo, "HEAD") == 0);
+
+    // A fix picked onto a side branch that is merged back later
+    assert(add_test_file(&test_repo, "a.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "fix: picked") == 0);
+    assert(git_reference_name_to_id(&side, test_repo.repo, "HEAD") == 0);
+
+    // A release branch that already has one of the mainline's changes
+    assert(reset_test_branch(&test_repo, &fork) == 0);
+    assert(add_test_file(&test_repo, "a.txt", "1\n") == 0);
+    assert(add_test_file(&test_repo, "b.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "feat: backported") == 0);
+    assert(git_reference_name_to_id(&release, test_repo.repo, "HEAD") == 0);
+
+    assert(reset_test_branch(&test_repo, &fork) == 0);
+    assert(add_test_file(&test_repo, "b.txt", "1\n") == 0);
+    assert(add_test_file(&test_repo, "a.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "fix: original") == 0);
+    assert(add_test_file(&test_repo, "b.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "feat: kept") == 0);
+    assert(add_test_file(&test_repo, "a.txt", "3\n") == 0);
+    assert(create_test_commit(&test_repo, "feat: dropped") == 0);
+
+    git_oid dropped;
+    char hex[GIT_OID_HEXSZ + 1] = {0}, message[256];
+    assert(git_reference_name_to_id(&dropped, test_repo.repo, "HEAD") == 0);
+    git_oid_fmt(hex, &dropped);
+    snprintf(message, sizeof(message), "Revert \"feat: dropped\"\n\nThis reverts commit %s.\n", hex);
+    assert(add_test_file(&test_repo, "a.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, message) == 0);
+    assert(create_test_merge(&test_repo, &side, "Merge branch 'side'") == 0);
+
+    git_oid_fmt(hex, &release);
+    for (int pass = 0; pass < 2; pass++) {
+        scope_log_t log;
+        for (int workers = 1; workers <= 4; workers += 3) {
+            const char *text = walk_deduplicated(&test_repo, 0, NULL, workers, &log);
+            assert(strstr(text, "picked") && strstr(text, "original") && strstr(text, "dropped"));
+
+            // One copy of the fix, and the reverted feature cancelled out
+            text = walk_deduplicated(&test_repo, 1, NULL, workers, &log);
+            assert(!strstr(text, "picked") != !strstr(text, "original"));
+            assert(strstr(text, "kept") && !strstr(text, "dropped"));
+
+            text = walk_deduplicated(&test_repo, 1, hex, workers, &log);
+            assert(!strstr(text, "kept") && !strstr(text, "dropped"));
+        }
+        if (write_commit_graph(&test_repo) != 0) break;
+    }
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Cherry-pick deduplication tests passed!\n");
+}
+
 int main(void) {
     printf("Running changelog git integration tests...\n\n");
     
@@ -138,6 +672,14 @@ int main(void) {
     
     test_git_integration();
     test_changelog_formatting();
+    test_changelog_stream();
+    test_tag_spelling();
+    test_incremental_write();
+    test_generate_all();
+    test_previous_version();
+    test_path_scope();
+    test_first_parent();
+    test_cherry_pick();
     
     git_libgit2_shutdown();
     
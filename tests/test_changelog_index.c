@@ -0,0 +1,160 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "changelog.h"
+#include "changelog_index.h"
+
+#define TEST_FILE "index_test.md"
+#define TEST_CACHE "index_test_cache/releasy/changelog.idx"
+
+static const char *sample =
+    "# Changelog\n"
+    "\n"
+    "## [1.10.0] - 2024-05-01\n"
+    "\n"
+    "### feat\n"
+    "\n"
+    "* add show\n"
+    "\n"
+    "## [1.2.0] - 2024-03-21\n"
+    "\n"
+    "### fix\n"
+    "\n"
+    "* **parser:** handle quotes\n"
+    "\n"
+    "## Unreleased notes\n"
+    "\n"
+    "## [v1.1.0]\n"
+    "\n"
+    "* first\n"
+    "\n"
+    "## [1.2.0] - 2024-01-01\n"
+    "\n"
+    "* an older duplicate\n";
+
+static void write_changelog(const char *content) {
+    FILE *f = fopen(TEST_FILE, "w");
+    assert(f != NULL);
+    fputs(content, f);
+    fclose(f);
+
+    // Well before any sidecar written next, so it is never racy
+    struct timespec times[2] = { { 1700000000, 0 }, { 1700000000, 0 } };
+    assert(utimensat(AT_FDCWD, TEST_FILE, times, 0) == 0);
+}
+
+static int section_is(const changelog_index_t *index, const char *version, const char *expected) {
+    const char *section;
+    size_t length;
+    if (changelog_index_find(index, version, &section, &length) != RELEASY_SUCCESS) return 0;
+
+    // Zero copy: the section is the changelog's own bytes
+    assert(section >= index->data && section + length <= index->data + index->size);
+    return length == strlen(expected) && memcmp(section, expected, length) == 0;
+}
+
+static void test_index_lookup(void) {
+    printf("Testing changelog section lookup...\n");
+
+    write_changelog(sample);
+    changelog_index_t index;
+    assert(changelog_index_open(&index, TEST_FILE, NULL) == RELEASY_SUCCESS);
+    assert(index.count == 3);
+    assert(!index.from_cache);
+
+    assert(section_is(&index, "1.10.0", "## [1.10.0] - 2024-05-01\n\n### feat\n\n* add show\n\n"));
+    assert(section_is(&index, "v1.2.0", "## [1.2.0] - 2024-03-21\n\n### fix\n\n* **parser:** handle quotes\n\n"));
+    assert(section_is(&index, "1.1.0", "## [v1.1.0]\n\n* first\n\n"));
+
+    const char *section;
+    size_t length;
+    assert(changelog_index_find(&index, "1.0.0", &section, &length) == CHANGELOG_ERR_SECTION_NOT_FOUND);
+    assert(changelog_index_find(&index, "1.2", &section, &length) == CHANGELOG_ERR_SECTION_NOT_FOUND);
+    changelog_index_close(&index);
+
+    // Last section runs to the end of a file without a final newline
+    write_changelog("## [2.0.0]\n* last");
+    assert(changelog_index_open(&index, TEST_FILE, NULL) == RELEASY_SUCCESS);
+    assert(section_is(&index, "2.0.0", "## [2.0.0]\n* last"));
+    changelog_index_close(&index);
+
+    write_changelog("");
+    assert(changelog_index_open(&index, TEST_FILE, NULL) == RELEASY_SUCCESS);
+    assert(index.count == 0);
+    assert(changelog_index_find(&index, "1.0.0", &section, &length) == CHANGELOG_ERR_SECTION_NOT_FOUND);
+    changelog_index_close(&index);
+
+    assert(changelog_index_open(&index, "missing_index_test.md", NULL) == CHANGELOG_ERR_FILE_ACCESS);
+    assert(strcmp(changelog_error_string(CHANGELOG_ERR_SECTION_NOT_FOUND), "Version not found in changelog") == 0);
+
+    remove(TEST_FILE);
+    printf("Changelog section lookup tests passed!\n");
+}
+
+static void test_index_sidecar(void) {
+    printf("Testing changelog index sidecar...\n");
+
+    // Stands in for .git; the releasy directory under it is created on save
+    assert(mkdir("index_test_cache", 0755) == 0);
+    write_changelog(sample);
+    changelog_index_t index;
+    assert(changelog_index_open(&index, TEST_FILE, TEST_CACHE) == RELEASY_SUCCESS);
+    assert(!index.from_cache);
+    changelog_index_close(&index);
+    assert(access(TEST_CACHE, F_OK) == 0);
+
+    // Same size and mtime: the sidecar is used as is
+    assert(changelog_index_open(&index, TEST_FILE, TEST_CACHE) == RELEASY_SUCCESS);
+    assert(index.from_cache);
+    assert(index.count == 3);
+    assert(section_is(&index, "1.1.0", "## [v1.1.0]\n\n* first\n\n"));
+    changelog_index_close(&index);
+
+    // A changed changelog is scanned again and the sidecar replaced
+    write_changelog("## [3.0.0]\n\n* new\n\n## [1.1.0]\n");
+    assert(changelog_index_open(&index, TEST_FILE, TEST_CACHE) == RELEASY_SUCCESS);
+    assert(!index.from_cache);
+    assert(section_is(&index, "3.0.0", "## [3.0.0]\n\n* new\n\n"));
+    changelog_index_close(&index);
+    assert(changelog_index_open(&index, TEST_FILE, TEST_CACHE) == RELEASY_SUCCESS);
+    assert(index.from_cache);
+    assert(section_is(&index, "1.1.0", "## [1.1.0]\n"));
+    changelog_index_close(&index);
+
+    // A damaged sidecar is ignored
+    FILE *f = fopen(TEST_CACHE, "r+b");
+    assert(f != NULL);
+    fputs("garbage", f);
+    fclose(f);
+    assert(changelog_index_open(&index, TEST_FILE, TEST_CACHE) == RELEASY_SUCCESS);
+    assert(!index.from_cache);
+    assert(section_is(&index, "3.0.0", "## [3.0.0]\n\n* new\n\n"));
+    changelog_index_close(&index);
+
+    char *path = changelog_index_cache_path("/repo/.git/", TEST_FILE);
+    assert(path != NULL);
+    assert(strncmp(path, "/repo/.git/releasy/changelog-", 29) == 0);
+    assert(strcmp(path + strlen(path) - 4, ".idx") == 0);
+    free(path);
+
+    remove(TEST_FILE);
+    remove(TEST_CACHE);
+    rmdir("index_test_cache/releasy");
+    rmdir("index_test_cache");
+    printf("Changelog index sidecar tests passed!\n");
+}
+
+int main(void) {
+    printf("Running changelog index tests...\n\n");
+
+    test_index_lookup();
+    test_index_sidecar();
+
+    printf("\nAll changelog index tests passed!\n");
+    return 0;
+}
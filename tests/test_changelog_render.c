@@ -0,0 +1,323 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include "changelog.h"
+#include "changelog_render.h"
+
+static commit_info_t *make_commit(commit_type_t type, const char *scope, const char *description,
+                                  const char *author) {
+    commit_info_t *commit = calloc(1, sizeof(commit_info_t));
+    assert(commit != NULL);
+    commit->type = type;
+    commit->scope = scope ? strdup(scope) : NULL;
+    commit->description = strdup(description);
+    commit->author = author ? strdup(author) : NULL;
+    commit->commit_hash = strdup("0123456789abcdef0123456789abcdef01234567");
+    commit->timestamp = 1710936000;  // 2024-03-20 12:00 UTC
+    return commit;
+}
+
+static changelog_entry_t *make_entry(void) {
+    changelog_entry_t *entry = calloc(1, sizeof(changelog_entry_t));
+    assert(entry != NULL);
+    entry->version = strdup("1.2.0");
+    entry->previous_version = strdup("v1.1.0");
+    entry->date = strdup("2024-03-21");
+    entry->count = 6;
+    entry->commits = calloc(entry->count, sizeof(commit_info_t *));
+    assert(entry->commits != NULL);
+    entry->commits[0] = make_commit(COMMIT_TYPE_FIX, "parser", "handle \"quotes\" & <tags>", "Ann <ann@example.com>");
+    entry->commits[1] = make_commit(COMMIT_TYPE_FEAT, "cli", "add --format", NULL);
+    entry->commits[2] = make_commit(COMMIT_TYPE_FIX, NULL, "unscoped fix", NULL);
+    entry->commits[3] = make_commit(COMMIT_TYPE_UNKNOWN, NULL, "not listed when grouped", NULL);
+    entry->commits[4] = make_commit(COMMIT_TYPE_FIX, "cli", "flag parsing", NULL);
+    entry->commits[5] = make_commit(COMMIT_TYPE_FIX, "parser", "second parser fix", NULL);
+    entry->commits[5]->is_breaking = 1;
+    return entry;
+}
+
+static char *render(const changelog_t *log, changelog_entry_t *const *entries, size_t count,
+                    changelog_format_t format) {
+    char path[] = "render_test_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+
+    changelog_model_t model;
+    assert(changelog_model_build(&model, log, entries, count) == RELEASY_SUCCESS);
+    assert(changelog_model_render(&model, format, fd) == RELEASY_SUCCESS);
+    changelog_model_free(&model);
+
+    off_t size = lseek(fd, 0, SEEK_END);
+    char *data = malloc((size_t)size + 1);
+    assert(data != NULL);
+    assert(pread(fd, data, (size_t)size, 0) == size);
+    data[size] = '\0';
+    close(fd);
+    unlink(path);
+    return data;
+}
+
+static void test_render_markdown(void) {
+    printf("Testing bucketed Markdown rendering...\n");
+
+    changelog_t log;
+    assert(changelog_init(&log, "render_test.md") == RELEASY_SUCCESS);
+    changelog_entry_t *entry = make_entry();
+
+    // Types in enum order, walk order within a type
+    char *text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strcmp(text,
+                  "## [1.2.0] - 2024-03-21\n"
+                  "\n### feat\n\n"
+                  "* **cli:** add --format\n"
+                  "\n### fix\n\n"
+                  "* **parser:** handle \"quotes\" & <tags> (Ann <ann@example.com>)\n"
+                  "* unscoped fix\n"
+                  "* **cli:** flag parsing\n"
+                  "* **parser:** second parser fix [BREAKING]\n"
+                  "\n") == 0);
+    free(text);
+
+    log.group_by_scope = 1;
+    text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strstr(text, "* unscoped fix\n"
+                        "* **cli:** flag parsing\n"
+                        "* **parser:** handle") != NULL);
+    assert(strstr(text, "(Ann <ann@example.com>)\n* **parser:** second parser fix") != NULL);
+    free(text);
+
+    // Ungrouped keeps walk order, unknown types included
+    log.group_by_type = 0;
+    log.include_authors = 0;
+    text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strstr(text, "* fix: handle \"quotes\" & <tags>\n* feat: add --format\n") != NULL);
+    assert(strstr(text, "* unknown: not listed when grouped\n") != NULL);
+    assert(strstr(text, "###") == NULL);
+    free(text);
+
+    // Longer than the buffer: pieces are flushed as it fills
+    free(entry->commits[1]->description);
+    entry->commits[1]->description = malloc(CHANGELOG_RENDER_BUFFER * 2);
+    memset(entry->commits[1]->description, 'x', CHANGELOG_RENDER_BUFFER * 2 - 1);
+    entry->commits[1]->description[CHANGELOG_RENDER_BUFFER * 2 - 1] = '\0';
+    text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strlen(text) > CHANGELOG_RENDER_BUFFER * 2);
+    assert(strstr(text, "xxx\n* fix: unscoped fix\n") != NULL);
+    free(text);
+
+    changelog_free_entry(entry);
+    free(entry);
+    changelog_cleanup(&log);
+
+    printf("Bucketed Markdown rendering tests passed!\n");
+}
+
+static void test_render_json_html(void) {
+    printf("Testing JSON and HTML rendering...\n");
+
+    changelog_t log;
+    assert(changelog_init(&log, "render_test.md") == RELEASY_SUCCESS);
+    changelog_entry_t *entry = make_entry();
+
+    char *json = render(&log, &entry, 1, CHANGELOG_FORMAT_JSON);
+    assert(strncmp(json, "{\"releases\":[", 13) == 0);
+    assert(strstr(json, "\"version\":\"1.2.0\",\"date\":\"2024-03-21\",\"previous_version\":\"v1.1.0\"") != NULL);
+    assert(strstr(json, "{\"type\":\"feat\",\"commits\":[") != NULL);
+    assert(strstr(json, "\"description\":\"handle \\\"quotes\\\" & <tags>\"") != NULL);
+    assert(strstr(json, "\"scope\":null,\"description\":\"unscoped fix\"") != NULL);
+    assert(strstr(json, "\"breaking\":true") != NULL);
+    assert(strstr(json, "\"date\":\"2024-03-20\",\"author\":\"Ann <ann@example.com>\"") != NULL);
+    assert(strstr(json, "\"date\":null") != NULL);
+    assert(strstr(json, "\"hash\":\"0123456789abcdef0123456789abcdef01234567\"") != NULL);
+    assert(strstr(json, "not listed") == NULL);
+    free(json);
+
+    char *html = render(&log, &entry, 1, CHANGELOG_FORMAT_HTML);
+    assert(strncmp(html, "<!DOCTYPE html>", 15) == 0);
+    assert(strstr(html, "<section id=\"v1.2.0\">\n<h2>1.2.0 <small>2024-03-21</small></h2>\n") != NULL);
+    assert(strstr(html, "<h3>feat</h3>\n<ul>\n<li><strong>cli:</strong> add --format</li>\n</ul>\n") != NULL);
+    assert(strstr(html, "handle &quot;quotes&quot; &amp; &lt;tags&gt; (Ann &lt;ann@example.com&gt;)") != NULL);
+    assert(strstr(html, "</body>\n</html>\n") != NULL);
+    free(html);
+
+    // All three from one changelog_write()
+    log.formats = CHANGELOG_FORMAT_ALL;
+    log.entries = malloc(sizeof(changelog_entry_t *));
+    assert(log.entries != NULL);
+    log.entries[0] = entry;
+    log.count = 1;
+    assert(changelog_write(&log) == RELEASY_SUCCESS);
+    assert(access("render_test.md", F_OK) == 0);
+    assert(access("render_test.json", F_OK) == 0);
+    assert(access("render_test.html", F_OK) == 0);
+    remove("render_test.md");
+    remove("render_test.json");
+    remove("render_test.html");
+    changelog_cleanup(&log);
+
+    printf("JSON and HTML rendering tests passed!\n");
+}
+
+static void test_render_contributors(void) {
+    printf("Testing contributor sections...\n");
+
+    changelog_t log;
+    assert(changelog_init(&log, "render_test.md") == RELEASY_SUCCESS);
+    changelog_entry_t *entry = make_entry();
+
+    // Authors as the walk would intern them; the unknown commit goes uncredited
+    static const char *signatures[] = {
+        "Ann <ann@example.com>", "Bob <bob@example.com>", "Bob <bob@example.com>",
+        "Ann <ann@example.com>", "Cy <cy@example.com>", "Bob <bob@example.com>"
+    };
+    for (size_t i = 0; i < entry->count; i++) {
+        entry->commits[i]->author_id = author_table_intern(&log.authors, signatures[i], strlen(signatures[i]));
+        assert(entry->commits[i]->author_id != AUTHOR_NONE);
+    }
+    assert(log.authors.count == 3);
+
+    char *text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strstr(text, "Contributors") == NULL);
+    free(text);
+
+    log.include_contributors = 1;
+    text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strstr(text,
+                  "[BREAKING]\n"
+                  "\n### Contributors\n\n"
+                  "* Bob <bob@example.com> (3 commits)\n"
+                  "* Ann <ann@example.com> (1 commit)\n"
+                  "* Cy <cy@example.com> (1 commit)\n"
+                  "\n") != NULL);
+    free(text);
+
+    char *json = render(&log, &entry, 1, CHANGELOG_FORMAT_JSON);
+    assert(strstr(json, "\"contributors\":[{\"author\":\"Bob <bob@example.com>\",\"commits\":3},"
+                        "{\"author\":\"Ann <ann@example.com>\",\"commits\":1},") != NULL);
+    free(json);
+
+    char *html = render(&log, &entry, 1, CHANGELOG_FORMAT_HTML);
+    assert(strstr(html, "<h3>Contributors</h3>\n<ul>\n<li>Bob &lt;bob@example.com&gt; (3 commits)</li>\n") != NULL);
+    free(html);
+
+    // Ungrouped lists every commit, so every commit is credited
+    log.group_by_type = 0;
+    text = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+    assert(strstr(text, "* Bob <bob@example.com> (3 commits)\n* Ann <ann@example.com> (2 commits)\n") != NULL);
+    free(text);
+
+    changelog_free_entry(entry);
+    free(entry);
+    changelog_cleanup(&log);
+
+    printf("Contributor section tests passed!\n");
+}
+
+static char *read_back(int fd) {
+    off_t size = lseek(fd, 0, SEEK_END);
+    char *data = malloc((size_t)size + 1);
+    assert(data != NULL);
+    assert(pread(fd, data, (size_t)size, 0) == size);
+    data[size] = '\0';
+    return data;
+}
+
+static void test_markdown_writer(void) {
+    printf("Testing piece-at-a-time Markdown...\n");
+
+    changelog_t log;
+    assert(changelog_init(&log, "render_test.md") == RELEASY_SUCCESS);
+    changelog_entry_t *entry = make_entry();
+    char *expected = render(&log, &entry, 1, CHANGELOG_FORMAT_MARKDOWN);
+
+    // The same bytes as the model, one piece at a time
+    char path[] = "render_test_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    changelog_markdown_t *md = changelog_markdown_open(fd, 1, 0);
+    assert(md != NULL);
+    changelog_markdown_entry(md, entry->version, entry->date);
+    changelog_markdown_type(md, COMMIT_TYPE_FEAT);
+    changelog_markdown_commit(md, entry->commits[1]);
+    changelog_markdown_type(md, COMMIT_TYPE_FIX);
+    changelog_markdown_commit(md, entry->commits[0]);
+    changelog_markdown_commit(md, entry->commits[2]);
+    changelog_markdown_commit(md, entry->commits[4]);
+    changelog_markdown_commit(md, entry->commits[5]);
+    changelog_markdown_text(md, "\n", 1);
+    assert(changelog_markdown_close(md) == RELEASY_SUCCESS);
+    char *text = read_back(fd);
+    assert(strcmp(text, expected) == 0);
+    free(text);
+    free(expected);
+
+    // Commits can be freed as soon as they are written
+    assert(ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0);
+    md = changelog_markdown_open(fd, 0, 0);
+    assert(md != NULL);
+    commit_info_t *commit = make_commit(COMMIT_TYPE_FEAT, NULL,
+                                        "a description long enough to be written without a copy"
+                                        " if the writer were allowed to borrow it", NULL);
+    changelog_markdown_commit(md, commit);
+    changelog_free_commit(commit);
+    free(commit);
+    assert(changelog_markdown_close(md) == RELEASY_SUCCESS);
+    text = read_back(fd);
+    assert(strcmp(text, "* feat: a description long enough to be written without a copy"
+                        " if the writer were allowed to borrow it\n") == 0);
+    free(text);
+    close(fd);
+    unlink(path);
+
+    // A failed write is reported, not dropped
+    fd = open("/dev/null", O_RDONLY);
+    assert(fd >= 0);
+    md = changelog_markdown_open(fd, 0, 0);
+    assert(md != NULL);
+    changelog_markdown_entry(md, "1.0.0", NULL);
+    assert(changelog_markdown_flush(md) == CHANGELOG_ERR_FILE_ACCESS);
+    assert(changelog_markdown_close(md) == CHANGELOG_ERR_FILE_ACCESS);
+    close(fd);
+
+    changelog_free_entry(entry);
+    free(entry);
+    changelog_cleanup(&log);
+
+    printf("Piece-at-a-time Markdown tests passed!\n");
+}
+
+static void test_parse_formats(void) {
+    printf("Testing format lists...\n");
+
+    int formats = 0;
+    assert(changelog_parse_formats("md", &formats) == RELEASY_SUCCESS);
+    assert(formats == CHANGELOG_FORMAT_MARKDOWN);
+    assert(changelog_parse_formats("markdown,JSON,html", &formats) == RELEASY_SUCCESS);
+    assert(formats == CHANGELOG_FORMAT_ALL);
+    assert(changelog_parse_formats("json,pdf", &formats) == CHANGELOG_ERR_INVALID_CONFIG);
+    assert(changelog_parse_formats("", &formats) == CHANGELOG_ERR_INVALID_CONFIG);
+    assert(strcmp(changelog_format_extension(CHANGELOG_FORMAT_HTML), ".html") == 0);
+
+    printf("Format list tests passed!\n");
+}
+
+int main(void) {
+    printf("Running changelog render tests...\n\n");
+
+    // Commit days are local time
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    test_render_markdown();
+    test_render_json_html();
+    test_render_contributors();
+    test_markdown_writer();
+    test_parse_formats();
+
+    printf("\nAll changelog render tests passed!\n");
+    return 0;
+}
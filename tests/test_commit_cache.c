@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <git2.h>
+#include "commit_cache.h"
+#include "changelog.h"
+#include "sidecar.h"
+#include "test_helpers.h"
+
+static git_oid make_oid(unsigned char seed) {
+    unsigned char raw[GIT_OID_RAWSZ];
+    memset(raw, seed, sizeof(raw));
+    git_oid oid;
+    git_oid_fromraw(&oid, raw);
+    return oid;
+}
+
+static void cache_path(test_repo_t *test_repo, char *path, size_t size) {
+    snprintf(path, size, "%s%s/%s", git_repository_commondir(test_repo->repo),
+             SIDECAR_DIR, COMMIT_CACHE_FILE);
+}
+
+static void test_commit_cache_round_trip(void) {
+    printf("Testing commit cache round trip...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    commit_cache_t cache;
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 0);
+
+    commit_info_t info = {0};
+    info.type = COMMIT_TYPE_FIX;
+    info.scope = "parser";
+    info.description = "handle empty input";
+    info.footer = "Refs: #12";
+    info.author = "Test User <test@example.com>";
+    info.is_breaking = 1;
+    info.timestamp = 1700000000;
+
+    git_oid fix = make_oid(0x20), other = make_oid(0x10), missing = make_oid(0x30);
+    assert(commit_cache_add(&cache, &fix, &info) == RELEASY_SUCCESS);
+    assert(commit_cache_add(&cache, &other, NULL) == RELEASY_SUCCESS);
+    assert(commit_cache_save(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    commit_cache_close(&cache);
+
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 2);
+    assert(cache.header->generation == 1);
+
+    commit_info_t hit;
+    assert(commit_cache_lookup(&cache, &fix, &hit) == COMMIT_CACHE_HIT);
+    assert(hit.type == COMMIT_TYPE_FIX);
+    assert(strcmp(hit.scope, "parser") == 0);
+    assert(strcmp(hit.description, "handle empty input") == 0);
+    assert(hit.body == NULL);
+    assert(strcmp(hit.footer, "Refs: #12") == 0);
+    assert(strcmp(hit.author, "Test User <test@example.com>") == 0);
+    assert(hit.is_breaking);
+    assert(hit.timestamp == 1700000000);
+    assert(hit.commit_hash == NULL);
+
+    assert(commit_cache_lookup(&cache, &other, &hit) == COMMIT_CACHE_HIT_OTHER);
+    assert(commit_cache_lookup(&cache, &missing, &hit) == COMMIT_CACHE_MISS);
+
+    // Nothing added, nothing to write
+    assert(commit_cache_save(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    commit_cache_close(&cache);
+
+    assert(commit_cache_add(NULL, &fix, NULL) == RELEASY_ERROR);
+    assert(strcmp(commit_cache_error_string(COMMIT_CACHE_ERR_LOCKED),
+                  "Commit cache is being written by another process") == 0);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Commit cache round trip tests passed!\n");
+}
+
+typedef struct {
+    char text[4096];
+    size_t len;
+} walk_log_t;
+
+static int log_commit(const commit_info_t *commit, void *payload) {
+    walk_log_t *log = payload;
+    int n = snprintf(log->text + log->len, sizeof(log->text) - log->len, "%d|%s|%s|%s|%s|%lld\n",
+                     commit->type, commit->scope ? commit->scope : "", commit->description,
+                     commit->commit_hash, commit->author, (long long)commit->timestamp);
+    assert(n > 0 && (size_t)n < sizeof(log->text) - log->len);
+    log->len += (size_t)n;
+    return RELEASY_SUCCESS;
+}
+
+static void walk_with_cache(test_repo_t *test_repo, int workers, walk_log_t *log) {
+    changelog_walk_options_t opts = CHANGELOG_WALK_OPTIONS_INIT;
+    opts.workers = workers;
+    opts.batch_size = 2;
+    memset(log, 0, sizeof(walk_log_t));
+    assert(changelog_walk(test_repo->repo, NULL, NULL, &opts, log_commit, log) == RELEASY_SUCCESS);
+}
+
+static void test_commit_cache_walk(void) {
+    printf("Testing cached changelog walk...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat(cli): add flag") == 0);
+    assert(create_test_commit(&test_repo, "not conventional") == 0);
+    assert(create_test_commit(&test_repo, "fix: crash on start") == 0);
+    assert(create_test_commit(&test_repo, "docs: readme") == 0);
+    assert(create_test_commit(&test_repo, "perf!: faster walk") == 0);
+
+    // Cold, warm and warm again on the pool: the same commits come out
+    walk_log_t cold, warm, pooled;
+    walk_with_cache(&test_repo, 1, &cold);
+    assert(cold.len > 0);
+
+    commit_cache_t cache;
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 5);
+    commit_cache_close(&cache);
+
+    walk_with_cache(&test_repo, 1, &warm);
+    assert(strcmp(cold.text, warm.text) == 0);
+    walk_with_cache(&test_repo, 4, &pooled);
+    assert(strcmp(cold.text, pooled.text) == 0);
+
+    // New commits are parsed once and join the cache
+    assert(create_test_commit(&test_repo, "feat: later") == 0);
+    walk_with_cache(&test_repo, 1, &warm);
+    assert(strncmp(warm.text, "0||later|", 9) == 0);
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 6);
+    commit_cache_close(&cache);
+
+    // A damaged file is thrown away and rewritten
+    char path[1024];
+    cache_path(&test_repo, path, sizeof(path));
+    FILE *f = fopen(path, "wb");
+    assert(f);
+    fputs("RLSYCMTS garbage", f);
+    fclose(f);
+
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 0);
+    commit_cache_close(&cache);
+
+    walk_with_cache(&test_repo, 1, &cold);
+    assert(strcmp(cold.text, warm.text) == 0);
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 6);
+    commit_cache_close(&cache);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Cached changelog walk tests passed!\n");
+}
+
+static void test_commit_cache_eviction(void) {
+    printf("Testing commit cache eviction...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    git_oid a = make_oid(1), b = make_oid(2), c = make_oid(3), d = make_oid(4);
+    commit_info_t info;
+
+    commit_cache_t cache;
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(commit_cache_add(&cache, &a, NULL) == RELEASY_SUCCESS);
+    assert(commit_cache_add(&cache, &b, NULL) == RELEASY_SUCCESS);
+    assert(commit_cache_add(&cache, &c, NULL) == RELEASY_SUCCESS);
+    assert(commit_cache_save(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    commit_cache_close(&cache);
+
+    // Room for two entries: the one just used and the one just added stay
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    cache.max_bytes = sizeof(commit_cache_header_t) + 2 * sizeof(commit_cache_entry_t);
+    assert(commit_cache_lookup(&cache, &c, &info) == COMMIT_CACHE_HIT_OTHER);
+    assert(commit_cache_add(&cache, &d, NULL) == RELEASY_SUCCESS);
+    assert(commit_cache_save(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    commit_cache_close(&cache);
+
+    assert(commit_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 2);
+    assert(cache.header->generation == 2);
+    assert(commit_cache_lookup(&cache, &a, &info) == COMMIT_CACHE_MISS);
+    assert(commit_cache_lookup(&cache, &b, &info) == COMMIT_CACHE_MISS);
+    assert(commit_cache_lookup(&cache, &c, &info) == COMMIT_CACHE_HIT_OTHER);
+    assert(commit_cache_lookup(&cache, &d, &info) == COMMIT_CACHE_HIT_OTHER);
+
+    // A writer holding the lock keeps others out
+    char lock[1100];
+    cache_path(&test_repo, lock, sizeof(lock) - 8);
+    strcat(lock, ".lock");
+    FILE *f = fopen(lock, "w");
+    assert(f);
+    fclose(f);
+    assert(commit_cache_add(&cache, &a, NULL) == RELEASY_SUCCESS);
+    assert(commit_cache_save(&cache, test_repo.repo) == COMMIT_CACHE_ERR_LOCKED);
+    remove(lock);
+    commit_cache_close(&cache);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Commit cache eviction tests passed!\n");
+}
+
+int main(void) {
+    printf("Running commit cache tests...\n\n");
+
+    git_libgit2_init();
+
+    test_commit_cache_round_trip();
+    test_commit_cache_walk();
+    test_commit_cache_eviction();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll commit cache tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <git2.h>
+#include "commit_graph.h"
+#include "test_helpers.h"
+
+static void test_commit_graph_read(void) {
+    printf("Testing commit-graph reader...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    commit_graph_t graph;
+    assert(commit_graph_open(&graph, test_repo.repo) == COMMIT_GRAPH_ERR_NOT_FOUND);
+
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    git_oid fork;
+    assert(git_reference_name_to_id(&fork, test_repo.repo, "HEAD") == 0);
+    assert(create_test_commit(&test_repo, "feat: side") == 0);
+    git_oid side;
+    assert(git_reference_name_to_id(&side, test_repo.repo, "HEAD") == 0);
+    assert(reset_test_branch(&test_repo, &fork) == 0);
+    assert(create_test_commit(&test_repo, "fix: main") == 0);
+    assert(create_test_merge(&test_repo, &side, "Merge side") == 0);
+
+    if (write_commit_graph(&test_repo) != 0) {
+        printf("git is not available, skipping\n");
+        cleanup_test_repo(&test_repo);
+        return;
+    }
+
+    assert(commit_graph_open(&graph, test_repo.repo) == RELEASY_SUCCESS);
+    assert(graph.count == 4);
+
+    // Every commit agrees with the object database
+    git_revwalk *walker = NULL;
+    assert(git_revwalk_new(&walker, test_repo.repo) == 0);
+    assert(git_revwalk_push_head(walker) == 0);
+    git_oid oid;
+    size_t walked = 0;
+    while (git_revwalk_next(&oid, walker) == 0) {
+        uint32_t pos = commit_graph_find(&graph, &oid);
+        assert(pos != COMMIT_GRAPH_NONE);
+
+        git_oid found;
+        commit_graph_oid(&graph, pos, &found);
+        assert(git_oid_equal(&found, &oid));
+
+        git_commit *commit = NULL;
+        assert(git_commit_lookup(&commit, test_repo.repo, &oid) == 0);
+        assert(commit_graph_time(&graph, pos) == (int64_t)git_commit_time(commit));
+
+        uint32_t parents[4];
+        size_t count = commit_graph_parents(&graph, pos, parents, 4);
+        assert(count == git_commit_parentcount(commit));
+        for (size_t i = 0; i < count; i++) {
+            git_oid parent;
+            commit_graph_oid(&graph, parents[i], &parent);
+            assert(git_oid_equal(&parent, git_commit_parent_id(commit, (unsigned int)i)));
+            assert(commit_graph_generation(&graph, parents[i]) < commit_graph_generation(&graph, pos));
+        }
+        if (count == 0) assert(commit_graph_generation(&graph, pos) == 1);
+
+        git_commit_free(commit);
+        walked++;
+    }
+    assert(walked == 4);
+    git_revwalk_free(walker);
+
+    // A commit made after the graph is not in it
+    assert(create_test_commit(&test_repo, "docs: later") == 0);
+    assert(git_reference_name_to_id(&oid, test_repo.repo, "HEAD") == 0);
+    assert(commit_graph_find(&graph, &oid) == COMMIT_GRAPH_NONE);
+    commit_graph_close(&graph);
+
+    // A truncated file is refused
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s", git_repository_commondir(test_repo.repo), COMMIT_GRAPH_FILE);
+    remove(path);
+    FILE *f = fopen(path, "wb");
+    assert(f);
+    fputs("CGPH", f);
+    fclose(f);
+    assert(commit_graph_open(&graph, test_repo.repo) == COMMIT_GRAPH_ERR_CORRUPT);
+    assert(graph.map == NULL);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Commit-graph reader tests passed!\n");
+}
+
+static size_t revwalk_range(test_repo_t *test_repo, const git_oid *to, const git_oid *hide,
+                            git_oid *oids, size_t max) {
+    git_revwalk *walker = NULL;
+    assert(git_revwalk_new(&walker, test_repo->repo) == 0);
+    assert(git_revwalk_push(walker, to) == 0);
+    if (hide) assert(git_revwalk_hide(walker, hide) == 0);
+
+    size_t count = 0;
+    git_oid oid;
+    while (git_revwalk_next(&oid, walker) == 0) {
+        assert(count < max);
+        oids[count++] = oid;
+    }
+    git_revwalk_free(walker);
+    return count;
+}
+
+// Same commits as a revwalk, order aside
+static void check_range(test_repo_t *test_repo, const commit_graph_t *graph,
+                        const git_oid *to, const git_oid *hide) {
+    git_oid expected[16];
+    size_t expected_count = revwalk_range(test_repo, to, hide, expected, 16);
+
+    git_oid *oids = NULL;
+    size_t count = 0;
+    assert(commit_graph_range(graph, test_repo->repo, to, hide, &oids, &count) == RELEASY_SUCCESS);
+    assert(count == expected_count);
+    for (size_t i = 0; i < count; i++) {
+        int found = 0;
+        for (size_t j = 0; j < expected_count; j++) {
+            if (git_oid_equal(&oids[i], &expected[j])) found = 1;
+        }
+        assert(found);
+    }
+    free(oids);
+}
+
+static void test_commit_graph_range(void) {
+    printf("Testing commit-graph ranges...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    git_oid first, side, merge, later;
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(git_reference_name_to_id(&first, test_repo.repo, "HEAD") == 0);
+    assert(create_test_commit(&test_repo, "feat: side") == 0);
+    assert(create_test_commit(&test_repo, "fix: side") == 0);
+    assert(git_reference_name_to_id(&side, test_repo.repo, "HEAD") == 0);
+    assert(reset_test_branch(&test_repo, &first) == 0);
+    assert(create_test_commit(&test_repo, "fix: main") == 0);
+    assert(create_test_merge(&test_repo, &side, "Merge side") == 0);
+    assert(git_reference_name_to_id(&merge, test_repo.repo, "HEAD") == 0);
+
+    if (write_commit_graph(&test_repo) != 0) {
+        printf("git is not available, skipping\n");
+        cleanup_test_repo(&test_repo);
+        return;
+    }
+
+    // Two commits the graph has not seen
+    assert(create_test_commit(&test_repo, "docs: later") == 0);
+    assert(create_test_commit(&test_repo, "docs: latest") == 0);
+    assert(git_reference_name_to_id(&later, test_repo.repo, "HEAD") == 0);
+
+    commit_graph_t graph;
+    assert(commit_graph_open(&graph, test_repo.repo) == RELEASY_SUCCESS);
+
+    check_range(&test_repo, &graph, &merge, NULL);
+    check_range(&test_repo, &graph, &merge, &first);
+    check_range(&test_repo, &graph, &merge, &side);
+    check_range(&test_repo, &graph, &later, &side);
+    check_range(&test_repo, &graph, &later, &merge);
+    check_range(&test_repo, &graph, &side, &later);
+    check_range(&test_repo, &graph, &later, &later);
+
+    git_oid *oids = NULL;
+    size_t count = 0;
+    assert(commit_graph_range(&graph, test_repo.repo, &later, &merge, &oids, &count) == RELEASY_SUCCESS);
+    assert(count == 2 && git_oid_equal(&oids[0], &later));
+    free(oids);
+
+    commit_graph_close(&graph);
+    cleanup_test_repo(&test_repo);
+
+    printf("Commit-graph range tests passed!\n");
+}
+
+// Commit with the clock at when, which may run behind the parent's
+static void commit_at(test_repo_t *test_repo, const char *message, git_time_t when, git_oid *oid) {
+    git_signature_free(test_repo->author);
+    assert(git_signature_new(&test_repo->author, "Test User", "test@example.com", when, 0) == 0);
+    assert(create_test_commit(test_repo, message) == 0);
+    assert(git_reference_name_to_id(oid, test_repo->repo, "HEAD") == 0);
+}
+
+static void check_order(const commit_graph_t *graph, test_repo_t *test_repo, const git_oid *to,
+                        const git_oid *expected, size_t expected_count) {
+    git_oid *oids = NULL;
+    size_t count = 0;
+    assert(commit_graph_range(graph, test_repo->repo, to, NULL, &oids, &count) == RELEASY_SUCCESS);
+    assert(count == expected_count);
+    for (size_t i = 0; i < count; i++) {
+        assert(git_oid_equal(&oids[i], &expected[i]));
+    }
+    free(oids);
+}
+
+static void test_commit_graph_skewed_clock(void) {
+    printf("Testing commit-graph ranges with a skewed clock...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    // behind and its child were made on a machine whose clock ran late,
+    // so by time alone they sort after their own parent
+    git_oid base, side, behind, behind_child, merge, later;
+    commit_at(&test_repo, "feat: base", 1000, &base);
+    commit_at(&test_repo, "feat: side", 5000, &side);
+    assert(reset_test_branch(&test_repo, &base) == 0);
+    commit_at(&test_repo, "fix: behind", 500, &behind);
+    commit_at(&test_repo, "fix: behind child", 600, &behind_child);
+    git_signature_free(test_repo.author);
+    assert(git_signature_new(&test_repo.author, "Test User", "test@example.com", 700, 0) == 0);
+    assert(create_test_merge(&test_repo, &side, "Merge side") == 0);
+    assert(git_reference_name_to_id(&merge, test_repo.repo, "HEAD") == 0);
+
+    if (write_commit_graph(&test_repo) != 0) {
+        printf("git is not available, skipping\n");
+        cleanup_test_repo(&test_repo);
+        return;
+    }
+
+    // A commit the graph has not seen, older than everything before it
+    commit_at(&test_repo, "docs: later", 100, &later);
+
+    commit_graph_t graph;
+    assert(commit_graph_open(&graph, test_repo.repo) == RELEASY_SUCCESS);
+
+    // Children first; commits of the same generation newest first
+    const git_oid expected[] = { later, merge, behind_child, side, behind, base };
+    check_order(&graph, &test_repo, &merge, expected + 1, 5);
+    check_order(&graph, &test_repo, &later, expected, 6);
+    check_range(&test_repo, &graph, &later, NULL);
+
+    commit_graph_close(&graph);
+    cleanup_test_repo(&test_repo);
+
+    printf("Skewed clock tests passed!\n");
+}
+
+int main(void) {
+    printf("Running commit-graph tests...\n\n");
+
+    git_libgit2_init();
+
+    test_commit_graph_read();
+    test_commit_graph_range();
+    test_commit_graph_skewed_clock();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll commit-graph tests passed!\n");
+    return 0;
+}
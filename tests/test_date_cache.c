@@ -0,0 +1,100 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <pthread.h>
+#include "date_cache.h"
+#include "releasy.h"
+
+#define THREADS 4
+
+// Hourly over two years, so every day, both DST switches and a few
+// thousand evictions are seen
+#define SPAN_START 1672531200   // 2023-01-01 00:00 UTC
+#define SPAN_HOURS (2 * 365 * 24)
+
+static void check_span(date_cache_t *cache, int64_t offset) {
+    char expected[DATE_DAY_LENGTH + 1];
+    for (int64_t h = 0; h < SPAN_HOURS; h++) {
+        int64_t when = SPAN_START + h * 3600 + offset;
+        assert(date_format_day(when, expected) == RELEASY_SUCCESS);
+        const char *day = date_cache_day(cache, when);
+        assert(day != NULL && strcmp(day, expected) == 0);
+    }
+}
+
+static void test_date_cache_days(void) {
+    printf("Testing cached day formatting...\n");
+
+    date_cache_t cache;
+    date_cache_init(&cache);
+
+    // Around a spring-forward night: 2024-03-10 06:59:59 UTC is 01:59:59 EST
+    char day[DATE_DAY_LENGTH + 1];
+    assert(date_format_day(1710053999, day) == RELEASY_SUCCESS);
+    assert(strcmp(day, "2024-03-10") == 0);
+    assert(strcmp(date_cache_day(&cache, 1710053999), "2024-03-10") == 0);
+    assert(strcmp(date_cache_day(&cache, 1710053999 - 7 * 3600), "2024-03-09") == 0);
+
+    // Seconds either side of local midnight land on different days
+    assert(strcmp(date_cache_day(&cache, 1710129599), "2024-03-10") == 0);
+    assert(strcmp(date_cache_day(&cache, 1710129600), "2024-03-11") == 0);
+    assert(strcmp(date_cache_day(&cache, 1710129599), "2024-03-10") == 0);
+
+    // A whole day is formatted once for each UTC day it overlaps, then
+    // served from the cache
+    date_cache_init(&cache);
+    assert(strcmp(date_cache_day(&cache, 1710216000), "2024-03-12") == 0);
+    for (int64_t s = 0; s < 86400; s += 60) {
+        assert(strcmp(date_cache_day(&cache, 1710216000 + s), "2024-03-12") == 0);
+    }
+    assert(cache.misses == 2);
+
+    check_span(&cache, 0);
+    check_span(&cache, 1799);
+    assert(cache.hits > cache.misses);
+
+    // Before the epoch
+    assert(strcmp(date_cache_day(&cache, -43200), "1969-12-31") == 0);
+
+    printf("Cached day formatting tests passed!\n");
+}
+
+// Each thread has its own cache; the library under them must not race
+static void *format_days(void *arg) {
+    int64_t offset = (int64_t)(intptr_t)arg;
+    date_cache_t cache;
+    date_cache_init(&cache);
+    check_span(&cache, offset);
+    return NULL;
+}
+
+static void test_date_cache_threads(void) {
+    printf("Testing day formatting across threads...\n");
+
+    pthread_t threads[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_create(&threads[i], NULL, format_days, (void *)(intptr_t)(i * 997)) == 0);
+    }
+    for (int i = 0; i < THREADS; i++) {
+        assert(pthread_join(threads[i], NULL) == 0);
+    }
+
+    printf("Day formatting across threads tests passed!\n");
+}
+
+int main(void) {
+    printf("Running date cache tests...\n\n");
+
+    // A zone with DST, spelled out so no tz database is needed
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+
+    test_date_cache_days();
+    test_date_cache_threads();
+
+    printf("\nAll date cache tests passed!\n");
+    return 0;
+}
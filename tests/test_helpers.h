@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
+#include <sys/stat.h>
 #include <fnmatch.h>
 #include <git2.h>
 #include <time.h>
@@ -63,6 +64,18 @@ static int init_test_repo(test_repo_t *test_repo) {
     int error = git_repository_init(&test_repo->repo, test_repo->path, 0);
     if (error) return error;
     
+    // Tags are signed with the configured identity, which the machine
+    // running the tests may not have
+    git_config *config = NULL;
+    error = git_repository_config(&config, test_repo->repo);
+    if (!error) error = git_config_set_string(config, "user.name", "Test User");
+    if (!error) error = git_config_set_string(config, "user.email", "test@example.com");
+    git_config_free(config);
+    if (error) {
+        git_repository_free(test_repo->repo);
+        return error;
+    }
+    
     // Create test signature
     error = git_signature_now(&test_repo->author, "Test User", "test@example.com");
     if (error) {
@@ -130,8 +143,9 @@ static int create_test_tag(test_repo_t *test_repo, const char *tag_name) {
     error = git_object_lookup(&head_commit, test_repo->repo, &head_id, GIT_OBJECT_COMMIT);
     if (error) return error;
     
+    git_oid tag_id;
     error = git_tag_create_lightweight(
-        NULL,
+        &tag_id,
         test_repo->repo,
         tag_name,
         head_commit,
@@ -142,6 +156,74 @@ static int create_test_tag(test_repo_t *test_repo, const char *tag_name) {
     return error;
 }
 
+// Write a file in the work tree, creating its directories, and stage it
+// for the next create_test_commit()
+static int add_test_file(test_repo_t *test_repo, const char *path, const char *content) {
+    char full[1024];
+    snprintf(full, sizeof(full), "%s/%s", test_repo->path, path);
+    for (char *slash = strchr(full + strlen(test_repo->path) + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        mkdir(full, 0755);
+        *slash = '/';
+    }
+
+    FILE *f = fopen(full, "w");
+    if (!f) return -1;
+    fputs(content, f);
+    fclose(f);
+
+    git_index *index;
+    int error = git_repository_index(&index, test_repo->repo);
+    if (error) return error;
+    error = git_index_add_bypath(index, path);
+    if (!error) error = git_index_write(index);
+    git_index_free(index);
+    return error;
+}
+
+// Move the current branch to commit, so the next commit starts a fork
+static int reset_test_branch(test_repo_t *test_repo, const git_oid *commit) {
+    git_reference *head = NULL, *moved = NULL;
+    int error = git_repository_head(&head, test_repo->repo);
+    if (error) return error;
+
+    error = git_reference_set_target(&moved, head, commit, "reset");
+    git_reference_free(moved);
+    git_reference_free(head);
+    return error;
+}
+
+// Merge other into the current branch, keeping the current tree
+static int create_test_merge(test_repo_t *test_repo, const git_oid *other, const char *message) {
+    git_oid head_id, merge_id;
+    int error = git_reference_name_to_id(&head_id, test_repo->repo, "HEAD");
+    if (error) return error;
+
+    git_commit *parents[2] = { NULL, NULL };
+    git_tree *tree = NULL;
+    error = git_commit_lookup(&parents[0], test_repo->repo, &head_id);
+    if (!error) error = git_commit_lookup(&parents[1], test_repo->repo, other);
+    if (!error) error = git_commit_tree(&tree, parents[0]);
+    if (!error) {
+        error = git_commit_create(&merge_id, test_repo->repo, "HEAD", test_repo->author, test_repo->author,
+                                  "UTF-8", message, tree, 2, (const git_commit **)parents);
+    }
+
+    git_tree_free(tree);
+    git_commit_free(parents[0]);
+    git_commit_free(parents[1]);
+    return error;
+}
+
+// Write a commit-graph, with changed-path filters, using the git command
+// line; fails when git is missing
+static int write_commit_graph(test_repo_t *test_repo) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "git -C %s commit-graph write --reachable --changed-paths >/dev/null 2>&1",
+             test_repo->path);
+    return system(cmd) == 0 ? 0 : -1;
+}
+
 // Cleanup test repository
 static void cleanup_test_repo(test_repo_t *test_repo) {
     if (test_repo->author) git_signature_free(test_repo->author);
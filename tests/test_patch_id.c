@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <git2.h>
+#include "patch_id.h"
+#include "sidecar.h"
+#include "test_helpers.h"
+
+static git_oid head_id(test_repo_t *test_repo) {
+    git_oid oid;
+    assert(git_reference_name_to_id(&oid, test_repo->repo, "HEAD") == 0);
+    return oid;
+}
+
+static int same_id(const unsigned char *a, const unsigned char *b) {
+    return memcmp(a, b, GIT_OID_RAWSZ) == 0;
+}
+
+static int is_zero(const unsigned char *id) {
+    static const unsigned char zero[GIT_OID_RAWSZ];
+    return same_id(id, zero);
+}
+
+static void test_patch_id_compute(void) {
+    printf("Testing patch id computation...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(add_test_file(&test_repo, "a.txt", "1\n") == 0);
+    assert(add_test_file(&test_repo, "b.txt", "1\n") == 0);
+    assert(create_test_commit(&test_repo, "feat: base") == 0);
+    git_oid fork = head_id(&test_repo);
+
+    // The same change on a branch whose other files differ
+    assert(add_test_file(&test_repo, "b.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "chore: elsewhere") == 0);
+    assert(add_test_file(&test_repo, "a.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "fix: picked") == 0);
+    git_oid picked = head_id(&test_repo);
+
+    assert(reset_test_branch(&test_repo, &fork) == 0);
+    assert(add_test_file(&test_repo, "b.txt", "1\n") == 0);
+    assert(add_test_file(&test_repo, "a.txt", "2\n") == 0);
+    assert(create_test_commit(&test_repo, "fix: original") == 0);
+    git_oid original = head_id(&test_repo);
+
+    char hex[GIT_OID_HEXSZ + 1] = {0};
+    git_oid_fmt(hex, &original);
+    char message[256];
+    snprintf(message, sizeof(message), "Revert \"fix: original\"\n\nThis reverts commit %s.\n", hex);
+    assert(add_test_file(&test_repo, "a.txt", "1\n") == 0);
+    assert(create_test_commit(&test_repo, message) == 0);
+    git_oid revert = head_id(&test_repo);
+
+    assert(create_test_merge(&test_repo, &picked, "Merge branch 'side'") == 0);
+    git_oid merge = head_id(&test_repo);
+
+    patch_id_entry_t a, b, r, m;
+    assert(patch_id_compute(test_repo.repo, &original, &a) == RELEASY_SUCCESS);
+    assert(patch_id_compute(test_repo.repo, &picked, &b) == RELEASY_SUCCESS);
+    assert(patch_id_compute(test_repo.repo, &revert, &r) == RELEASY_SUCCESS);
+    assert(patch_id_compute(test_repo.repo, &merge, &m) == RELEASY_SUCCESS);
+
+    assert(same_id(a.commit, original.id));
+    assert(!is_zero(a.patch) && same_id(a.patch, b.patch));
+    assert(is_zero(a.reverts) && is_zero(b.reverts));
+    assert(!is_zero(r.patch) && !same_id(r.patch, a.patch));
+    assert(same_id(r.reverts, original.id));
+    assert(is_zero(m.patch));
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Patch id computation tests passed!\n");
+}
+
+static void test_patch_id_cache(void) {
+    printf("Testing patch id cache...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    // Enough commits to go past the serial threshold
+    git_oid oids[100];
+    for (int i = 0; i < 100; i++) {
+        char content[32], message[32];
+        snprintf(content, sizeof(content), "%d\n", i);
+        snprintf(message, sizeof(message), "fix: step %d", i);
+        assert(add_test_file(&test_repo, "counter.txt", content) == 0);
+        assert(create_test_commit(&test_repo, message) == 0);
+        oids[i] = head_id(&test_repo);
+    }
+
+    patch_id_entry_t serial[100], pooled[100], cached[100];
+    assert(patch_id_compute_all(test_repo.repo, NULL, oids, 100, 1, serial) == RELEASY_SUCCESS);
+    assert(patch_id_compute_all(test_repo.repo, NULL, oids, 100, 4, pooled) == RELEASY_SUCCESS);
+    assert(memcmp(serial, pooled, sizeof(serial)) == 0);
+
+    patch_id_cache_t cache;
+    assert(patch_id_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 0);
+    assert(patch_id_compute_all(test_repo.repo, &cache, oids, 100, 4, cached) == RELEASY_SUCCESS);
+    assert(cache.added_count == 100);
+    assert(patch_id_cache_save(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    patch_id_cache_close(&cache);
+
+    // Warm: every entry comes from the file and nothing is added
+    assert(patch_id_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 100);
+    memset(cached, 0, sizeof(cached));
+    assert(patch_id_compute_all(test_repo.repo, &cache, oids, 100, 4, cached) == RELEASY_SUCCESS);
+    assert(cache.added_count == 0);
+    assert(memcmp(serial, cached, sizeof(serial)) == 0);
+
+    patch_id_entry_t hit;
+    assert(patch_id_cache_lookup(&cache, &oids[42], &hit) == 1);
+    assert(memcmp(&hit, &serial[42], sizeof(hit)) == 0);
+
+    // A commit that cannot be read is not remembered as having no patch
+    git_oid missing;
+    memset(&missing, 0xab, sizeof(missing));
+    assert(patch_id_compute_all(test_repo.repo, &cache, &missing, 1, 1, &hit) == RELEASY_SUCCESS);
+    assert(cache.added_count == 0);
+    assert(patch_id_cache_lookup(&cache, &missing, &hit) == 0);
+    patch_id_cache_close(&cache);
+
+    // A damaged file opens empty and is replaced on the next save
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s/%s", git_repository_commondir(test_repo.repo),
+             SIDECAR_DIR, PATCH_ID_CACHE_FILE);
+    FILE *f = fopen(path, "r+b");
+    assert(f != NULL);
+    fputs("garbage", f);
+    fclose(f);
+    assert(patch_id_cache_open(&cache, test_repo.repo) == RELEASY_SUCCESS);
+    assert(cache.count == 0);
+    assert(patch_id_cache_lookup(&cache, &oids[0], &hit) == 0);
+    patch_id_cache_close(&cache);
+
+    assert(strcmp(patch_id_error_string(PATCH_ID_ERR_LOCKED),
+                  "Patch id cache is being written by another process") == 0);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Patch id cache tests passed!\n");
+}
+
+int main(void) {
+    printf("Running patch id tests...\n\n");
+
+    git_libgit2_init();
+
+    test_patch_id_compute();
+    test_patch_id_cache();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll patch id tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <git2.h>
+#include "repo_session.h"
+#include "git_ops.h"
+#include "test_helpers.h"
+
+static void test_repo_session_open(void) {
+    printf("Testing repository session...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+
+    assert(!repo_session_is_open());
+    assert(repo_session_repo() == NULL);
+
+    assert(repo_session_open(test_repo.path) == RELEASY_SUCCESS);
+    assert(repo_session_is_open());
+    git_repository *repo = repo_session_repo();
+    assert(repo != NULL);
+    assert(repo_session_config() != NULL);
+    assert(repo_session_odb() != NULL);
+    assert(strcmp(repo_session_get()->path, test_repo.path) == 0);
+
+    // Opening again hands back the same handles
+    assert(repo_session_open(test_repo.path) == RELEASY_SUCCESS);
+    assert(repo_session_repo() == repo);
+
+    repo_session_close();
+    assert(!repo_session_is_open());
+    assert(repo_session_get() == NULL);
+
+    assert(repo_session_open("releasy_no_such_repo") == REPO_SESSION_ERR_NOT_FOUND);
+    assert(!repo_session_is_open());
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Repository session tests passed!\n");
+}
+
+static void test_repo_session_borrowed(void) {
+    printf("Testing borrowed repository handles...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+
+    assert(repo_session_open(test_repo.path) == RELEASY_SUCCESS);
+
+    // Several contexts in a row share the session and leave it open
+    for (int i = 0; i < 2; i++) {
+        git_context_t ctx;
+        assert(git_ops_init(&ctx) == RELEASY_SUCCESS);
+        assert(git_ops_use_repo(&ctx, repo_session_repo(), repo_session_config()) == RELEASY_SUCCESS);
+        assert(ctx.repo == repo_session_repo());
+
+        char version[32];
+        assert(git_ops_get_latest_version(&ctx, version, sizeof(version)) == RELEASY_SUCCESS);
+        assert(strcmp(version, "1.0.0") == 0);
+
+        git_ops_cleanup(&ctx);
+        assert(repo_session_is_open());
+    }
+
+    repo_session_close();
+    cleanup_test_repo(&test_repo);
+
+    printf("Borrowed repository handle tests passed!\n");
+}
+
+int main(void) {
+    printf("Running repository session tests...\n\n");
+
+    git_libgit2_init();
+
+    test_repo_session_open();
+    test_repo_session_borrowed();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll repository session tests passed!\n");
+    return 0;
+}
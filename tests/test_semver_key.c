@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "semver.h"
+
+static int sign(int value) {
+    return (value > 0) - (value < 0);
+}
+
+static int key_compare_strings(const char *a, const char *b) {
+    semver_key_t key_a, key_b;
+    assert(semver_key_parse(a, strlen(a), &key_a) == RELEASY_SUCCESS);
+    assert(semver_key_parse(b, strlen(b), &key_b) == RELEASY_SUCCESS);
+    return semver_key_compare(&key_a, &key_b);
+}
+
+static int version_compare_strings(const char *a, const char *b) {
+    semver_t ver_a, ver_b;
+    assert(semver_parse(a, &ver_a) == RELEASY_SUCCESS);
+    assert(semver_parse(b, &ver_b) == RELEASY_SUCCESS);
+    int result = semver_compare(&ver_a, &ver_b);
+    semver_free(&ver_a);
+    semver_free(&ver_b);
+    return result;
+}
+
+static void test_spec_precedence(void) {
+    printf("Testing SemVer 2.0 precedence...\n");
+
+    // Strictly increasing, mostly taken from the SemVer specification
+    static const char *ordered[] = {
+        "0.9.9", "1.0.0-0", "1.0.0-2", "1.0.0-10", "1.0.0-alpha", "1.0.0-alpha.1",
+        "1.0.0-alpha.beta", "1.0.0-beta", "1.0.0-beta.2", "1.0.0-beta.11",
+        "1.0.0-rc.1", "1.0.0-rc.2", "1.0.0-rc.10", "1.0.0", "1.0.1-a", "1.0.1",
+        "1.2.0", "1.10.0", "2.0.0-rc.1", "2.0.0", "10.0.0", "2147483647.0.0"
+    };
+    size_t count = sizeof(ordered) / sizeof(ordered[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count; j++) {
+            int expected = (i > j) - (i < j);
+            assert(sign(key_compare_strings(ordered[i], ordered[j])) == expected);
+            assert(sign(version_compare_strings(ordered[i], ordered[j])) == expected);
+        }
+    }
+
+    printf("Precedence tests passed!\n");
+}
+
+static void test_equal_precedence(void) {
+    printf("Testing equal precedence...\n");
+
+    // Build metadata doesn't take part in precedence
+    assert(key_compare_strings("1.0.0+build.1", "1.0.0+build.2") == 0);
+    assert(key_compare_strings("1.0.0-rc.1+a", "1.0.0-rc.1") == 0);
+    assert(version_compare_strings("1.0.0-rc.1+a", "1.0.0-rc.1") == 0);
+
+    // Leading zeros in numeric prerelease identifiers compare by value
+    assert(key_compare_strings("1.0.0-rc.01", "1.0.0-rc.1") == 0);
+    assert(version_compare_strings("1.0.0-rc.01", "1.0.0-rc.1") == 0);
+
+    printf("Equal precedence tests passed!\n");
+}
+
+static void test_truncated_keys(void) {
+    printf("Testing truncated keys...\n");
+
+    const char *a = "1.0.0-averyveryverylongprereleaselabel.1";
+    const char *b = "1.0.0-averyveryverylongprereleaselabel.2";
+    semver_key_t key_a, key_b, key_short;
+
+    assert(semver_key_parse(a, strlen(a), &key_a) == RELEASY_SUCCESS);
+    assert(semver_key_parse(b, strlen(b), &key_b) == RELEASY_SUCCESS);
+    assert(key_a.flags & SEMVER_KEY_TRUNCATED);
+    assert(semver_key_compare(&key_a, &key_b) == 0);
+    assert(version_compare_strings(a, b) < 0);
+
+    // Truncation never inverts an ordering decided within the suffix
+    assert(semver_key_parse("1.0.0-alpha", 11, &key_short) == RELEASY_SUCCESS);
+    assert(!(key_short.flags & SEMVER_KEY_TRUNCATED));
+    assert(semver_key_compare(&key_short, &key_a) < 0);
+
+    printf("Truncated key tests passed!\n");
+}
+
+static void test_keys_match_compare(void) {
+    printf("Testing key order against semver_compare...\n");
+
+    static const char *labels[] = {
+        "", "-0", "-1", "-9", "-10", "-alpha", "-alpha.1", "-alpha.10", "-alpha.2",
+        "-alpha.beta", "-beta", "-rc", "-rc.1", "-rc.1.1", "-rc-1", "-RC.1", "--"
+    };
+    size_t label_count = sizeof(labels) / sizeof(labels[0]);
+    char a[64], b[64];
+    unsigned int seed = 7;
+
+    for (int round = 0; round < 100000; round++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = seed >> 8;
+        snprintf(a, sizeof(a), "%u.%u.%u%s", r % 3, (r >> 2) % 3, (r >> 4) % 3,
+                 labels[(r >> 6) % label_count]);
+        seed = seed * 1103515245 + 12345;
+        r = seed >> 8;
+        snprintf(b, sizeof(b), "%u.%u.%u%s", r % 3, (r >> 2) % 3, (r >> 4) % 3,
+                 labels[(r >> 6) % label_count]);
+
+        assert(sign(key_compare_strings(a, b)) == sign(version_compare_strings(a, b)));
+    }
+
+    semver_t version;
+    semver_key_t from_version, from_string;
+    assert(semver_parse("3.1.0-beta.4+sha.1", &version) == RELEASY_SUCCESS);
+    assert(semver_key_from_version(&from_version, &version) == RELEASY_SUCCESS);
+    assert(semver_key_parse("3.1.0-beta.4", 12, &from_string) == RELEASY_SUCCESS);
+    assert(semver_key_compare(&from_version, &from_string) == 0);
+    semver_free(&version);
+
+    printf("Key order tests passed!\n");
+}
+
+int main(void) {
+    printf("Running semver key tests...\n\n");
+
+    test_spec_precedence();
+    test_equal_precedence();
+    test_truncated_keys();
+    test_keys_match_compare();
+
+    printf("\nAll semver key tests passed!\n");
+    return 0;
+}
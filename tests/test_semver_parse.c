@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include <regex.h>
+#include "semver.h"
+
+// The grammar semver_parse used to match with regexec(); kept here as the
+// reference the hand written parser is checked against
+#define REFERENCE_REGEX "^(0|[1-9][0-9]*)\\.(0|[1-9][0-9]*)\\.(0|[1-9][0-9]*)(\\-([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*))?(\\+([0-9A-Za-z-]+(\\.[0-9A-Za-z-]+)*))?$"
+
+static regex_t reference;
+static size_t checked;
+
+static int match_equals(regmatch_t m, semver_span_t span) {
+    if (m.rm_so == -1) return span.length == 0;
+    return (size_t)m.rm_so == span.offset &&
+           (size_t)(m.rm_eo - m.rm_so) == span.length;
+}
+
+static void check_against_reference(const char *str) {
+    regmatch_t matches[10];
+    int accepted = regexec(&reference, str, 10, matches, 0) == 0;
+
+    semver_view_t view;
+    int ret = semver_parse_view(str, strlen(str), &view);
+
+    if (!accepted) {
+        if (ret != SEMVER_ERR_INVALID_FORMAT) {
+            printf("Parser accepted '%s' which the regex rejects\n", str);
+            assert(0);
+        }
+        checked++;
+        return;
+    }
+
+    // The old parser ran atoi() on these, the new one reports the component
+    int overflow_group = ret == SEMVER_ERR_INVALID_MAJOR ? 1 :
+                         ret == SEMVER_ERR_INVALID_MINOR ? 2 :
+                         ret == SEMVER_ERR_INVALID_PATCH ? 3 : 0;
+    if (overflow_group) {
+        regmatch_t m = matches[overflow_group];
+        assert(m.rm_eo - m.rm_so > 10 ||
+               strtoll(str + m.rm_so, NULL, 10) > INT_MAX);
+        checked++;
+        return;
+    }
+
+    if (ret != RELEASY_SUCCESS) {
+        printf("Parser rejected '%s' (%s) which the regex accepts\n",
+               str, semver_error_string(ret));
+        assert(0);
+    }
+
+    assert(view.major == atoi(str + matches[1].rm_so));
+    assert(view.minor == atoi(str + matches[2].rm_so));
+    assert(view.patch == atoi(str + matches[3].rm_so));
+    assert(match_equals(matches[5], view.prerelease));
+    assert(match_equals(matches[8], view.build));
+
+    // The owning parser must agree with the span parser
+    semver_t version;
+    semver_init(&version);
+    assert(semver_parse(str, &version) == RELEASY_SUCCESS);
+    assert(version.major == view.major);
+    assert((version.prerelease != NULL) == (view.prerelease.length != 0));
+    assert((version.build != NULL) == (view.build.length != 0));
+    if (version.prerelease) {
+        assert(strncmp(version.prerelease, str + view.prerelease.offset,
+                       view.prerelease.length) == 0);
+    }
+    semver_free(&version);
+
+    checked++;
+}
+
+static void enumerate(char *buf, size_t pos, size_t max_len, const char *alphabet) {
+    buf[pos] = '\0';
+    check_against_reference(buf);
+    if (pos == max_len) return;
+
+    for (const char *c = alphabet; *c; c++) {
+        buf[pos] = *c;
+        enumerate(buf, pos + 1, max_len, alphabet);
+    }
+}
+
+static void test_exhaustive_short_inputs(void) {
+    printf("Testing all short strings against the reference regex...\n");
+
+    char buf[16];
+    enumerate(buf, 0, 6, "01.-+aZ");
+
+    printf("Exhaustive tests passed (%zu inputs)!\n", checked);
+}
+
+static void test_mutated_versions(void) {
+    printf("Testing mutated versions against the reference regex...\n");
+
+    static const char *seeds[] = {
+        "1.0.0", "10.20.30", "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-0.3.7",
+        "1.0.0-x.7.z.92", "1.0.0+20130313144700", "1.0.0-beta+exp.sha.5114f85",
+        "1.0.0-rc.1+build.1", "1.2.3----RC-SNAPSHOT.12.9.1--.12+788",
+        "2147483647.0.0", "0.0.0-0", "99999999999999999999.0.0"
+    };
+    static const char mutations[] = "0123456789.-+aZz_ /\n";
+
+    unsigned int seed = 12345;
+    char buf[64];
+    size_t before = checked;
+
+    for (size_t s = 0; s < sizeof(seeds) / sizeof(seeds[0]); s++) {
+        check_against_reference(seeds[s]);
+
+        for (int round = 0; round < 20000; round++) {
+            strcpy(buf, seeds[s]);
+            size_t len = strlen(buf);
+            int edits = 1 + (int)((seed = seed * 1103515245 + 12345) >> 16) % 3;
+
+            for (int e = 0; e < edits && len > 0; e++) {
+                seed = seed * 1103515245 + 12345;
+                size_t at = (seed >> 16) % len;
+                seed = seed * 1103515245 + 12345;
+                char c = mutations[(seed >> 16) % (sizeof(mutations) - 1)];
+                seed = seed * 1103515245 + 12345;
+
+                switch ((seed >> 16) % 3) {
+                    case 0:
+                        buf[at] = c;
+                        break;
+                    case 1:
+                        memmove(buf + at, buf + at + 1, len - at);
+                        len--;
+                        break;
+                    default:
+                        if (len + 1 < sizeof(buf)) {
+                            memmove(buf + at + 1, buf + at, len - at + 1);
+                            buf[at] = c;
+                            len++;
+                        }
+                        break;
+                }
+            }
+
+            check_against_reference(buf);
+        }
+    }
+
+    printf("Mutation tests passed (%zu inputs)!\n", checked - before);
+}
+
+static void test_numeric_overflow(void) {
+    printf("Testing numeric overflow handling...\n");
+
+    semver_view_t view;
+    assert(semver_parse_view("2147483647.0.0", 14, &view) == RELEASY_SUCCESS);
+    assert(view.major == 2147483647);
+    assert(semver_parse_view("2147483648.0.0", 14, &view) == SEMVER_ERR_INVALID_MAJOR);
+    assert(semver_parse_view("0.2147483648.0", 14, &view) == SEMVER_ERR_INVALID_MINOR);
+    assert(semver_parse_view("0.0.2147483648", 14, &view) == SEMVER_ERR_INVALID_PATCH);
+
+    // A malformed string is a format error even when a component overflows
+    assert(semver_parse_view("2147483648.0", 12, &view) == SEMVER_ERR_INVALID_FORMAT);
+
+    printf("Numeric overflow tests passed!\n");
+}
+
+static void test_spans(void) {
+    printf("Testing span parsing...\n");
+
+    const char *tag = "v1.2.3-rc.1+build.7 trailing";
+    semver_view_t view;
+
+    // Parse a substring without copying it
+    assert(semver_parse_view(tag + 1, 18, &view) == RELEASY_SUCCESS);
+    assert(view.major == 1 && view.minor == 2 && view.patch == 3);
+    assert(view.prerelease.length == 4);
+    assert(strncmp(tag + 1 + view.prerelease.offset, "rc.1", 4) == 0);
+    assert(view.build.length == 7);
+    assert(strncmp(tag + 1 + view.build.offset, "build.7", 7) == 0);
+
+    assert(semver_parse_view(tag + 1, strlen(tag + 1), &view) == SEMVER_ERR_INVALID_FORMAT);
+    assert(semver_parse_view(NULL, 0, &view) == RELEASY_ERROR);
+
+    printf("Span parsing tests passed!\n");
+}
+
+int main(void) {
+    printf("Running semver parser tests...\n\n");
+
+    // Compiled outside assert() so an NDEBUG build still has a reference
+    int compiled = regcomp(&reference, REFERENCE_REGEX, REG_EXTENDED);
+    assert(compiled == 0);
+    (void)compiled;
+
+    test_exhaustive_short_inputs();
+    test_mutated_versions();
+    test_numeric_overflow();
+    test_spans();
+
+    regfree(&reference);
+
+    printf("\nAll semver parser tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,114 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "sidecar.h"
+
+#define TEST_COMMON_DIR "sidecar_test_dir/"
+#define TEST_FILE TEST_COMMON_DIR SIDECAR_DIR "/test.idx"
+
+static void clear_dir(void) {
+    unlink(TEST_FILE);
+    unlink(TEST_FILE ".lock");
+    rmdir(TEST_COMMON_DIR SIDECAR_DIR);
+    rmdir(TEST_COMMON_DIR);
+}
+
+static void test_sidecar_paths(void) {
+    printf("Testing sidecar paths...\n");
+
+    char *path = sidecar_path("/repo/.git/", "tags.idx");
+    assert(path && strcmp(path, "/repo/.git/" SIDECAR_DIR "/tags.idx") == 0);
+    free(path);
+
+    path = sidecar_common_path("/repo/.git/", "packed-refs");
+    assert(path && strcmp(path, "/repo/.git/packed-refs") == 0);
+    free(path);
+
+    assert(sidecar_path(NULL, "tags.idx") == NULL);
+    assert(sidecar_common_path("/repo/.git/", NULL) == NULL);
+
+    printf("Sidecar path tests passed!\n");
+}
+
+static void test_sidecar_write(void) {
+    printf("Testing sidecar writes...\n");
+
+    clear_dir();
+    assert(mkdir(TEST_COMMON_DIR, 0755) == 0);
+
+    void *map = NULL;
+    size_t size = 0;
+    assert(sidecar_map(TEST_FILE, 4, &map, &size, NULL) == SIDECAR_ERR_FILE_ACCESS);
+
+    // Creates the directory and lands under the final name only on commit
+    sidecar_writer_t writer;
+    assert(sidecar_begin(&writer, TEST_FILE) == RELEASY_SUCCESS);
+    assert(fputs("abcdef", writer.file) >= 0);
+    assert(access(TEST_FILE, F_OK) != 0);
+    assert(sidecar_commit(&writer, 1) == RELEASY_SUCCESS);
+    assert(access(TEST_FILE ".lock", F_OK) != 0);
+
+    struct stat st;
+    assert(sidecar_map(TEST_FILE, 4, &map, &size, &st) == RELEASY_SUCCESS);
+    assert(size == 6 && st.st_size == 6);
+    assert(memcmp(map, "abcdef", 6) == 0);
+    munmap(map, size);
+    assert(sidecar_map(TEST_FILE, 7, &map, &size, NULL) == SIDECAR_ERR_CORRUPT);
+
+    // A failed write leaves the old file alone
+    assert(sidecar_begin(&writer, TEST_FILE) == RELEASY_SUCCESS);
+    fputs("partial", writer.file);
+    assert(sidecar_commit(&writer, 0) == SIDECAR_ERR_FILE_ACCESS);
+    assert(access(TEST_FILE ".lock", F_OK) != 0);
+    assert(sidecar_map(TEST_FILE, 4, &map, &size, NULL) == RELEASY_SUCCESS);
+    assert(size == 6);
+    munmap(map, size);
+
+    clear_dir();
+    printf("Sidecar write tests passed!\n");
+}
+
+static void test_sidecar_lock(void) {
+    printf("Testing sidecar locks...\n");
+
+    clear_dir();
+    assert(mkdir(TEST_COMMON_DIR, 0755) == 0);
+
+    sidecar_writer_t first, second;
+    assert(sidecar_begin(&first, TEST_FILE) == RELEASY_SUCCESS);
+    assert(sidecar_begin(&second, TEST_FILE) == SIDECAR_ERR_LOCKED);
+    assert(sidecar_commit(&first, 1) == RELEASY_SUCCESS);
+
+    // A lock left by a writer that died is taken over once it is old enough
+    FILE *f = fopen(TEST_FILE ".lock", "w");
+    assert(f != NULL);
+    fclose(f);
+    assert(sidecar_begin(&second, TEST_FILE) == SIDECAR_ERR_LOCKED);
+
+    struct utimbuf old;
+    old.actime = old.modtime = time(NULL) - SIDECAR_LOCK_STALE_SECONDS - 1;
+    assert(utime(TEST_FILE ".lock", &old) == 0);
+    assert(sidecar_begin(&second, TEST_FILE) == RELEASY_SUCCESS);
+    assert(sidecar_commit(&second, 1) == RELEASY_SUCCESS);
+
+    clear_dir();
+    printf("Sidecar lock tests passed!\n");
+}
+
+int main(void) {
+    printf("Running sidecar tests...\n\n");
+
+    test_sidecar_paths();
+    test_sidecar_write();
+    test_sidecar_lock();
+
+    printf("\nAll sidecar tests passed!\n");
+    return 0;
+}
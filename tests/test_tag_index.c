@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <git2.h>
+#include "tag_index.h"
+#include "sidecar.h"
+#include "version_list.h"
+#include "test_helpers.h"
+
+static void test_tag_index_build(void) {
+    printf("Testing tag index build...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.10.0") == 0);
+    assert(create_test_tag(&test_repo, "nightly") == 0);
+    assert(create_test_commit(&test_repo, "fix: second") == 0);
+    assert(create_test_tag(&test_repo, "v1.2.0") == 0);
+
+    git_oid head;
+    assert(git_reference_name_to_id(&head, test_repo.repo, "HEAD") == 0);
+
+    // The first open builds the index
+    tag_index_t index;
+    assert(tag_index_open(&index, test_repo.repo) == RELEASY_SUCCESS);
+    assert(index.count == 2);
+    assert(strcmp(tag_index_name(&index, 0), "v1.2.0") == 0);
+    assert(strcmp(tag_index_name(&index, 1), "v1.10.0") == 0);
+    assert(memcmp(index.entries[0].commit, head.id, GIT_OID_RAWSZ) == 0);
+    assert(tag_index_name(&index, 2) == NULL);
+    tag_index_close(&index);
+
+    version_list_t list;
+    version_list_init(&list);
+    assert(version_list_load(&list, test_repo.repo) == RELEASY_SUCCESS);
+    assert(list.count == 2);
+    assert(strcmp(list.items[0].version, "1.2.0") == 0);
+    assert(git_oid_equal(&list.items[0].commit, &head));
+    version_list_cleanup(&list);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Tag index build tests passed!\n");
+}
+
+static void test_tag_index_invalidation(void) {
+    printf("Testing tag index invalidation...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v0.1.0") == 0);
+
+    assert(tag_index_build(test_repo.repo) == RELEASY_SUCCESS);
+
+    // A tag created behind our back must show up
+    assert(create_test_tag(&test_repo, "v0.2.0") == 0);
+    assert(!tag_index_is_fresh(test_repo.repo));
+
+    char version[32];
+    assert(version_list_select_latest(test_repo.repo, NULL, version, sizeof(version)) == RELEASY_SUCCESS);
+    assert(strcmp(version, "0.2.0") == 0);
+
+    // A tag we write ourselves is patched in
+    git_oid head;
+    tag_index_stamp_t before;
+    assert(git_reference_name_to_id(&head, test_repo.repo, "HEAD") == 0);
+    assert(tag_index_read_stamp(test_repo.repo, &before) == RELEASY_SUCCESS);
+    assert(create_test_tag(&test_repo, "v0.3.0") == 0);
+    assert(tag_index_note_created(test_repo.repo, &before, "v0.3.0", &head) == RELEASY_SUCCESS);
+
+    tag_index_t index;
+    assert(tag_index_open(&index, test_repo.repo) == RELEASY_SUCCESS);
+    assert(index.count == 3);
+    assert(strcmp(tag_index_name(&index, 2), "v0.3.0") == 0);
+    tag_index_close(&index);
+
+    // Another tag written between the stamp and ours must not be papered over
+    assert(tag_index_read_stamp(test_repo.repo, &before) == RELEASY_SUCCESS);
+    assert(create_test_tag(&test_repo, "v0.4.0") == 0);
+    assert(create_test_tag(&test_repo, "v0.5.0") == 0);
+    assert(tag_index_note_created(test_repo.repo, &before, "v0.5.0", &head) == RELEASY_SUCCESS);
+    assert(!tag_index_is_fresh(test_repo.repo));
+
+    assert(tag_index_open(&index, test_repo.repo) == RELEASY_SUCCESS);
+    assert(index.count == 5);
+    assert(strcmp(tag_index_name(&index, 3), "v0.4.0") == 0);
+    tag_index_close(&index);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Tag index invalidation tests passed!\n");
+}
+
+static void test_tag_index_corrupt(void) {
+    printf("Testing corrupt tag index...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+    assert(tag_index_build(test_repo.repo) == RELEASY_SUCCESS);
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s%s/%s", git_repository_commondir(test_repo.repo),
+             SIDECAR_DIR, TAG_INDEX_FILE);
+    FILE *f = fopen(path, "wb");
+    assert(f);
+    fputs("garbage", f);
+    fclose(f);
+
+    // A damaged file is rebuilt, never trusted
+    tag_index_t index;
+    assert(tag_index_open(&index, test_repo.repo) == RELEASY_SUCCESS);
+    assert(index.count == 1);
+    assert(strcmp(tag_index_name(&index, 0), "v1.0.0") == 0);
+    tag_index_close(&index);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Corrupt tag index tests passed!\n");
+}
+
+static void test_tag_index_unpeelable(void) {
+    printf("Testing tags that do not peel to a commit...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v1.0.0") == 0);
+
+    git_oid head;
+    git_commit *commit = NULL;
+    git_reference *ref = NULL;
+    assert(git_reference_name_to_id(&head, test_repo.repo, "HEAD") == 0);
+    assert(git_commit_lookup(&commit, test_repo.repo, &head) == 0);
+    assert(git_reference_create(&ref, test_repo.repo, "refs/tags/v2.0.0",
+                                git_commit_tree_id(commit), 0, NULL) == 0);
+    git_reference_free(ref);
+    git_commit_free(commit);
+
+    // Listed like the refdb lists it, just without a commit
+    tag_index_t index;
+    assert(tag_index_open(&index, test_repo.repo) == RELEASY_SUCCESS);
+    assert(index.count == 2);
+    assert(strcmp(tag_index_name(&index, 1), "v2.0.0") == 0);
+    git_oid zero;
+    memset(&zero, 0, sizeof(zero));
+    assert(memcmp(index.entries[1].commit, zero.id, GIT_OID_RAWSZ) == 0);
+    assert(memcmp(index.entries[0].commit, head.id, GIT_OID_RAWSZ) == 0);
+    tag_index_close(&index);
+
+    version_list_t list;
+    version_list_init(&list);
+    assert(version_list_load(&list, test_repo.repo) == RELEASY_SUCCESS);
+    assert(list.count == 2);
+    assert(git_oid_is_zero(&list.items[1].commit));
+    version_list_cleanup(&list);
+
+    char version[32];
+    assert(version_list_select_latest(test_repo.repo, NULL, version, sizeof(version)) == RELEASY_SUCCESS);
+    assert(strcmp(version, "2.0.0") == 0);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Unpeelable tag tests passed!\n");
+}
+
+int main(void) {
+    printf("Running tag index tests...\n\n");
+
+    git_libgit2_init();
+
+    test_tag_index_build();
+    test_tag_index_invalidation();
+    test_tag_index_corrupt();
+    test_tag_index_unpeelable();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll tag index tests passed!\n");
+    return 0;
+}
@@ -107,6 +107,7 @@ static void test_version_git_integration(void) {
     
     test_repo_t test_repo = {0};
     assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: initial commit") == 0);
     
     version_info_t info;
     assert(version_init(&info) == RELEASY_SUCCESS);
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <git2.h>
+#include "version_list.h"
+#include "test_helpers.h"
+
+static void test_version_list_sorting(void) {
+    printf("Testing version list sorting...\n");
+
+    static const char *tags[] = {
+        "v1.10.0", "nightly", "v1.2.0", "1.0.0-rc.10", "v1.0.0", "latest",
+        "1.0.0-rc.2", "v2", "v1.0.0-averyveryverylongprereleaselabel.2",
+        "v1.0.0-averyveryverylongprereleaselabel.10"
+    };
+    static const char *expected[] = {
+        "v1.0.0-averyveryverylongprereleaselabel.2",
+        "v1.0.0-averyveryverylongprereleaselabel.10", "1.0.0-rc.2", "1.0.0-rc.10",
+        "v1.0.0", "v1.2.0", "v1.10.0"
+    };
+    size_t expected_count = sizeof(expected) / sizeof(expected[0]);
+
+    version_list_t list;
+    assert(version_list_init(&list) == RELEASY_SUCCESS);
+    for (size_t i = 0; i < sizeof(tags) / sizeof(tags[0]); i++) {
+        assert(version_list_add(&list, tags[i]) == RELEASY_SUCCESS);
+    }
+
+    // Non-version tags are dropped when added
+    assert(list.count == expected_count);
+
+    version_list_sort(&list);
+    for (size_t i = 0; i < expected_count; i++) {
+        assert(strcmp(list.items[i].tag, expected[i]) == 0);
+    }
+    assert(strcmp(list.items[2].version, "1.0.0-rc.2") == 0);
+    assert(strcmp(version_list_latest(&list)->version, "1.10.0") == 0);
+
+    char **names = NULL;
+    size_t count = 0;
+    assert(version_list_detach(&list, &names, &count) == RELEASY_SUCCESS);
+    assert(count == expected_count);
+    assert(list.count == 0);
+    assert(strcmp(names[count - 1], "v1.10.0") == 0);
+    for (size_t i = 0; i < count; i++) free(names[i]);
+    free(names);
+
+    version_list_cleanup(&list);
+    assert(version_list_latest(&list) == NULL);
+
+    printf("Version list sorting tests passed!\n");
+}
+
+static void test_version_list_load(void) {
+    printf("Testing version list loading...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(create_test_tag(&test_repo, "v0.9.0") == 0);
+    assert(create_test_tag(&test_repo, "nightly") == 0);
+    assert(create_test_commit(&test_repo, "fix: second") == 0);
+    assert(create_test_tag(&test_repo, "v0.10.0") == 0);
+
+    version_list_t list;
+    version_list_init(&list);
+    assert(version_list_load(&list, test_repo.repo) == RELEASY_SUCCESS);
+    assert(list.count == 2);
+    assert(strcmp(list.items[0].tag, "v0.9.0") == 0);
+    assert(strcmp(version_list_latest(&list)->tag, "v0.10.0") == 0);
+    version_list_cleanup(&list);
+
+    assert(version_list_load(&list, NULL) == RELEASY_ERROR);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Version list loading tests passed!\n");
+}
+
+static void test_version_filter(void) {
+    printf("Testing version filters...\n");
+
+    semver_view_t release, prerelease;
+    assert(semver_parse_view("2.4.1", 5, &release) == RELEASY_SUCCESS);
+    assert(semver_parse_view("3.1.0-rc.2", 10, &prerelease) == RELEASY_SUCCESS);
+
+    version_filter_t any = VERSION_FILTER_INIT;
+    assert(version_filter_matches(&any, &release));
+    assert(version_filter_matches(&any, &prerelease));
+    assert(version_filter_matches(NULL, &release));
+
+    version_filter_t line = { 2, VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_MATCH_ANY };
+    assert(version_filter_matches(&line, &release));
+    assert(!version_filter_matches(&line, &prerelease));
+
+    version_filter_t pre = { 3, 1, 0, VERSION_MATCH_PRERELEASE };
+    assert(!version_filter_matches(&pre, &release));
+    assert(version_filter_matches(&pre, &prerelease));
+
+    version_filter_t releases = { VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_FILTER_ANY,
+                                  VERSION_MATCH_RELEASE };
+    assert(version_filter_matches(&releases, &release));
+    assert(!version_filter_matches(&releases, &prerelease));
+
+    printf("Version filter tests passed!\n");
+}
+
+static void test_version_select_latest(void) {
+    printf("Testing latest version selection...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+
+    static const char *tags[] = {
+        "v1.9.0", "v2.0.0", "v2.10.1", "v2.9.0", "v3.0.0", "v3.1.0-rc.2",
+        "v3.1.0-rc.10", "v3.1.0-beta.1", "nightly", "zzz-latest"
+    };
+    for (size_t i = 0; i < sizeof(tags) / sizeof(tags[0]); i++) {
+        assert(create_test_tag(&test_repo, tags[i]) == 0);
+    }
+
+    char version[32];
+    assert(version_list_select_latest(test_repo.repo, NULL, version, sizeof(version)) == RELEASY_SUCCESS);
+    assert(strcmp(version, "3.1.0-rc.10") == 0);
+
+    version_filter_t line = { 2, VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_MATCH_ANY };
+    assert(version_list_select_latest(test_repo.repo, &line, version, sizeof(version)) == RELEASY_SUCCESS);
+    assert(strcmp(version, "2.10.1") == 0);
+
+    version_filter_t pre = { 3, 1, 0, VERSION_MATCH_PRERELEASE };
+    assert(version_list_select_latest(test_repo.repo, &pre, version, sizeof(version)) == RELEASY_SUCCESS);
+    assert(strcmp(version, "3.1.0-rc.10") == 0);
+
+    version_filter_t releases = { VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_FILTER_ANY,
+                                  VERSION_MATCH_RELEASE };
+    assert(version_list_select_latest(test_repo.repo, &releases, version, sizeof(version)) == RELEASY_SUCCESS);
+    assert(strcmp(version, "3.0.0") == 0);
+
+    version_filter_t missing = { 4, VERSION_FILTER_ANY, VERSION_FILTER_ANY, VERSION_MATCH_ANY };
+    assert(version_list_select_latest(test_repo.repo, &missing, version, sizeof(version)) ==
+           VERSION_LIST_ERR_NOT_FOUND);
+    assert(version_list_select_latest(test_repo.repo, NULL, version, 4) ==
+           VERSION_LIST_ERR_BUFFER_TOO_SMALL);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Latest version selection tests passed!\n");
+}
+
+int main(void) {
+    printf("Running version list tests...\n\n");
+
+    git_libgit2_init();
+
+    test_version_list_sorting();
+    test_version_list_load();
+    test_version_filter();
+    test_version_select_latest();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll version list tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,135 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <sys/stat.h>
+#include <git2.h>
+#include "worktree_status.h"
+#include "test_helpers.h"
+
+static void write_file(test_repo_t *test_repo, const char *name, const char *content) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", test_repo->path, name);
+    FILE *f = fopen(path, "w");
+    assert(f);
+    fputs(content, f);
+    fclose(f);
+}
+
+static void stage_file(test_repo_t *test_repo, const char *name) {
+    git_index *index = NULL;
+    assert(git_repository_index(&index, test_repo->repo) == 0);
+    assert(git_index_add_bypath(index, name) == 0);
+    assert(git_index_write(index) == 0);
+    git_index_free(index);
+}
+
+static const worktree_scan_options_t serial_opts = { 1, WORKTREE_PARALLEL_MIN_ENTRIES };
+static const worktree_scan_options_t parallel_opts = { 4, 0 };
+
+// Checks the serial and the parallel scan agree, with and without a report
+static int is_dirty(test_repo_t *test_repo) {
+    int serial = -1, parallel = -1;
+    assert(worktree_status_scan(test_repo->repo, &serial_opts, &serial, NULL) == RELEASY_SUCCESS);
+    assert(worktree_status_scan(test_repo->repo, &parallel_opts, &parallel, NULL) == RELEASY_SUCCESS);
+    assert(serial == parallel);
+
+    worktree_report_t serial_report, parallel_report;
+    int dirty = -1;
+    assert(worktree_status_scan(test_repo->repo, &serial_opts, &dirty, &serial_report) == RELEASY_SUCCESS);
+    assert(dirty == serial);
+    assert(worktree_status_scan(test_repo->repo, &parallel_opts, &dirty, &parallel_report) == RELEASY_SUCCESS);
+    assert(dirty == serial);
+
+    assert(serial_report.count == parallel_report.count);
+    for (size_t i = 0; i < serial_report.count; i++) {
+        assert(strcmp(serial_report.changes[i].path, parallel_report.changes[i].path) == 0);
+        assert(serial_report.changes[i].status == parallel_report.changes[i].status);
+    }
+
+    worktree_report_cleanup(&serial_report);
+    worktree_report_cleanup(&parallel_report);
+    return serial;
+}
+
+static void test_worktree_dirty_check(void) {
+    printf("Testing dirty check, serial and parallel...\n");
+
+    test_repo_t test_repo = {0};
+    assert(init_test_repo(&test_repo) == 0);
+
+    // Unborn HEAD with nothing in the worktree
+    assert(!is_dirty(&test_repo));
+
+    write_file(&test_repo, "README.md", "hello\n");
+    write_file(&test_repo, ".gitignore", "build/\n*.o\n");
+    assert(is_dirty(&test_repo));
+
+    stage_file(&test_repo, "README.md");
+    stage_file(&test_repo, ".gitignore");
+    assert(is_dirty(&test_repo));
+
+    assert(create_test_commit(&test_repo, "feat: first") == 0);
+    assert(!is_dirty(&test_repo));
+
+    // Ignored files and directories never count
+    char dir[1024];
+    snprintf(dir, sizeof(dir), "%s/build", test_repo.path);
+    assert(mkdir(dir, 0755) == 0);
+    write_file(&test_repo, "build/out.bin", "x");
+    write_file(&test_repo, "main.o", "x");
+    assert(!is_dirty(&test_repo));
+
+    // Modified tracked file
+    write_file(&test_repo, "README.md", "hello again\n");
+    assert(is_dirty(&test_repo));
+
+    // Staged but otherwise matching the worktree
+    stage_file(&test_repo, "README.md");
+    assert(is_dirty(&test_repo));
+    assert(create_test_commit(&test_repo, "docs: update") == 0);
+    assert(!is_dirty(&test_repo));
+
+    // Untracked directory
+    snprintf(dir, sizeof(dir), "%s/src", test_repo.path);
+    assert(mkdir(dir, 0755) == 0);
+    write_file(&test_repo, "src/new.c", "int x;\n");
+    assert(is_dirty(&test_repo));
+
+    worktree_report_t report;
+    int dirty = 0;
+    assert(worktree_status_scan(test_repo.repo, &parallel_opts, &dirty, &report) == RELEASY_SUCCESS);
+    assert(dirty);
+    assert(report.count == 1);
+    assert(strcmp(report.changes[0].path, "src/") == 0);
+    assert(report.changes[0].status == GIT_STATUS_WT_NEW);
+    worktree_report_cleanup(&report);
+
+    // Deleting a tracked file
+    char file[1024];
+    snprintf(file, sizeof(file), "%s/src/new.c", test_repo.path);
+    remove(file);
+    snprintf(file, sizeof(file), "%s/README.md", test_repo.path);
+    remove(file);
+    assert(is_dirty(&test_repo));
+
+    assert(worktree_status_is_dirty(NULL, NULL) == RELEASY_ERROR);
+
+    cleanup_test_repo(&test_repo);
+
+    printf("Dirty check tests passed!\n");
+}
+
+int main(void) {
+    printf("Running worktree status tests...\n\n");
+
+    git_libgit2_init();
+
+    test_worktree_dirty_check();
+
+    git_libgit2_shutdown();
+
+    printf("\nAll worktree status tests passed!\n");
+    return 0;
+}